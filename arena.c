@@ -0,0 +1,545 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "arena.h"
+
+/* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
+ * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021 See comment above. */
+
+/* This entire source file will be skipped if the application is not configured
+ * to use arenas.  If you want to use arenas then ensure configUSE_ARENAS is set
+ * to 1 in FreeRTOSConfig.h. */
+#if ( configUSE_ARENAS == 1 )
+
+/* Round a size up to a multiple of portBYTE_ALIGNMENT. */
+    #define arenaALIGN_SIZE( xSize )    ( ( ( xSize ) + ( ( size_t ) portBYTE_ALIGNMENT - ( size_t ) 1 ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/*-----------------------------------------------------------*/
+
+    typedef struct ArenaDefinition
+    {
+        uint8_t * pucStart;            /*<< The first byte of the arena's memory, aligned to portBYTE_ALIGNMENT. */
+        size_t xSize;                  /*<< The number of bytes of memory in the arena. */
+        size_t xUsed;                  /*<< The number of bytes allocated from the arena, including alignment padding.  Allocation starts at pucStart + xUsed. */
+        size_t xMaximumUsed;           /*<< The maximum value xUsed has had. */
+        uint8_t ucStaticallyAllocated; /*<< Set to pdTRUE if the arena was created by xArenaCreateStatic(), so vArenaDelete() does not free it. */
+    } Arena_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Initialise a new arena structure that manages xSizeInBytes bytes of memory
+ * starting at pucStart, which must be aligned to portBYTE_ALIGNMENT.
+ */
+    static void prvInitialiseNewArena( Arena_t * const pxArena,
+                                       uint8_t * const pucStart,
+                                       size_t xSizeInBytes,
+                                       uint8_t ucStaticallyAllocated ) PRIVILEGED_FUNCTION;
+
+/*
+ * Allocate two blocks of memory from an arena as one operation, so either both
+ * or neither are allocated.  The first block is aligned to xFirstAlignment,
+ * which must be a power of two no smaller than portBYTE_ALIGNMENT, and is not
+ * allocated, but *ppvFirst is set to NULL, if xFirstSize is 0.  The second
+ * block, which holds the control block of an object, is aligned to
+ * portBYTE_ALIGNMENT.  Returns pdFAIL, and allocates nothing, if the arena does
+ * not have enough space.
+ */
+    static BaseType_t prvAllocatePair( Arena_t * const pxArena,
+                                       size_t xFirstSize,
+                                       size_t xFirstAlignment,
+                                       void ** ppvFirst,
+                                       size_t xSecondSize,
+                                       void ** ppvSecond ) PRIVILEGED_FUNCTION;
+
+/*
+ * Allocate xSize bytes aligned to xAlignment from an arena, or return NULL if
+ * the arena does not have enough space.  Must be called from a critical
+ * section.
+ */
+    static void * prvAllocate( Arena_t * const pxArena,
+                               size_t xSize,
+                               size_t xAlignment ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+        ArenaHandle_t xArenaCreate( size_t xSizeInBytes )
+        {
+            Arena_t * pxArena = NULL;
+            const size_t xArenaStructSize = arenaALIGN_SIZE( sizeof( Arena_t ) );
+
+            /* The arena structure and the arena's memory are allocated in a
+             * single call to pvPortMalloc(), with the structure first. */
+            if( xSizeInBytes < ( xSizeInBytes + xArenaStructSize ) )
+            {
+                pxArena = ( Arena_t * ) pvPortMalloc( xArenaStructSize + xSizeInBytes ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack. */
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( pxArena != NULL )
+            {
+                prvInitialiseNewArena( pxArena, ( ( uint8_t * ) pxArena ) + xArenaStructSize, xSizeInBytes, ( uint8_t ) pdFALSE );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return pxArena;
+        }
+
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    ArenaHandle_t xArenaCreateStatic( size_t xSizeInBytes,
+                                      uint8_t * pucArenaStorage,
+                                      StaticArena_t * pxStaticArena )
+    {
+        Arena_t * const pxArena = ( Arena_t * ) pxStaticArena; /*lint !e740 !e9087 Safe cast as StaticArena_t is opaque Arena_t. */
+        ArenaHandle_t xReturn = NULL;
+        size_t xAlignmentBytes;
+
+        configASSERT( pucArenaStorage );
+        configASSERT( pxStaticArena );
+
+        #if ( configASSERT_DEFINED == 1 )
+        {
+            /* Sanity check that the size of the structure used to declare a
+             * variable of type StaticArena_t equals the size of the real arena
+             * structure. */
+            volatile size_t xSize = sizeof( StaticArena_t );
+            configASSERT( xSize == sizeof( Arena_t ) );
+            ( void ) xSize; /* Prevent lint warning when configASSERT() is not used. */
+        } /*lint !e529 xSize is referenced is configASSERT() is defined. */
+        #endif /* configASSERT_DEFINED */
+
+        if( ( pucArenaStorage != NULL ) && ( pxStaticArena != NULL ) )
+        {
+            /* Skip any bytes at the start of the storage that are before the
+             * first portBYTE_ALIGNMENT boundary. */
+            xAlignmentBytes = ( ( size_t ) 0 - ( size_t ) ( portPOINTER_SIZE_TYPE ) pucArenaStorage ) & ( size_t ) portBYTE_ALIGNMENT_MASK; /*lint !e923 !e9078 Address arithmetic is used to align the arena. */
+
+            if( xSizeInBytes > xAlignmentBytes )
+            {
+                xSizeInBytes -= xAlignmentBytes;
+            }
+            else
+            {
+                xSizeInBytes = ( size_t ) 0;
+            }
+
+            prvInitialiseNewArena( pxArena, pucArenaStorage + xAlignmentBytes, xSizeInBytes, ( uint8_t ) pdTRUE );
+            xReturn = pxArena;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void vArenaDelete( ArenaHandle_t xArena )
+    {
+        Arena_t * const pxArena = xArena;
+
+        configASSERT( pxArena );
+
+        if( pxArena->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+        {
+            #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+            {
+                vPortFree( ( void * ) pxArena ); /*lint !e9087 Standard free() semantics require void *. */
+            }
+            #else
+            {
+                /* Should not be possible to get here, ucStaticallyAllocated must
+                 * be pdTRUE if dynamic allocation is not supported. */
+                configASSERT( 0 );
+            }
+            #endif
+        }
+        else
+        {
+            /* The structure and storage area were provided by the application,
+             * so clear the structure in case the arena is used again. */
+            ( void ) memset( pxArena, 0x00, sizeof( Arena_t ) );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void * pvArenaAllocate( ArenaHandle_t xArena,
+                            size_t xSize )
+    {
+        Arena_t * const pxArena = xArena;
+        void * pvReturn;
+
+        configASSERT( pxArena );
+
+        taskENTER_CRITICAL();
+        {
+            pvReturn = prvAllocate( pxArena, xSize, ( size_t ) portBYTE_ALIGNMENT );
+        }
+        taskEXIT_CRITICAL();
+
+        return pvReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void vArenaReset( ArenaHandle_t xArena )
+    {
+        Arena_t * const pxArena = xArena;
+
+        configASSERT( pxArena );
+
+        taskENTER_CRITICAL();
+        {
+            pxArena->xUsed = ( size_t ) 0;
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    size_t xArenaGetFreeSize( ArenaHandle_t xArena )
+    {
+        const Arena_t * const pxArena = xArena;
+        size_t xReturn;
+
+        configASSERT( pxArena );
+
+        taskENTER_CRITICAL();
+        {
+            xReturn = pxArena->xSize - pxArena->xUsed;
+        }
+        taskEXIT_CRITICAL();
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    size_t xArenaGetMinimumEverFreeSize( ArenaHandle_t xArena )
+    {
+        const Arena_t * const pxArena = xArena;
+        size_t xReturn;
+
+        configASSERT( pxArena );
+
+        taskENTER_CRITICAL();
+        {
+            xReturn = pxArena->xSize - pxArena->xMaximumUsed;
+        }
+        taskEXIT_CRITICAL();
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    TaskHandle_t xArenaCreateTask( ArenaHandle_t xArena,
+                                   TaskFunction_t pxTaskCode,
+                                   const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                   const uint32_t ulStackDepth,
+                                   void * const pvParameters,
+                                   UBaseType_t uxPriority )
+    {
+        TaskHandle_t xReturn = NULL;
+        const size_t xStackSize = ( size_t ) ulStackDepth * sizeof( StackType_t );
+        void * pvStack;
+        void * pvTCB;
+
+        configASSERT( xArena );
+
+        if( ( xStackSize / sizeof( StackType_t ) ) == ( size_t ) ulStackDepth )
+        {
+            if( prvAllocatePair( xArena, xStackSize, ( size_t ) portBYTE_ALIGNMENT, &pvStack, sizeof( StaticTask_t ), &pvTCB ) != pdFAIL )
+            {
+                xReturn = xTaskCreateStatic( pxTaskCode, pcName, ulStackDepth, pvParameters, uxPriority, ( StackType_t * ) pvStack, ( StaticTask_t * ) pvTCB ); /*lint !e9079 The memory is aligned to portBYTE_ALIGNMENT. */
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    QueueHandle_t xArenaCreateQueue( ArenaHandle_t xArena,
+                                     const UBaseType_t uxQueueLength,
+                                     const UBaseType_t uxItemSize )
+    {
+        QueueHandle_t xReturn = NULL;
+        void * pvStorage;
+        void * pvQueue;
+
+        configASSERT( xArena );
+
+        /* The storage area is not allocated if the item size is 0, in which
+         * case pvStorage is set to NULL as xQueueCreateStatic() expects. */
+        if( ( uxQueueLength > ( UBaseType_t ) 0 ) &&
+            ( ( SIZE_MAX / uxQueueLength ) >= uxItemSize ) )
+        {
+            if( prvAllocatePair( xArena, ( size_t ) uxQueueLength * ( size_t ) uxItemSize, ( size_t ) portBYTE_ALIGNMENT, &pvStorage, sizeof( StaticQueue_t ), &pvQueue ) != pdFAIL )
+            {
+                xReturn = xQueueCreateStatic( uxQueueLength, uxItemSize, ( uint8_t * ) pvStorage, ( StaticQueue_t * ) pvQueue ); /*lint !e9079 The memory is aligned to portBYTE_ALIGNMENT. */
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TIMERS == 1 )
+
+        TimerHandle_t xArenaCreateTimer( ArenaHandle_t xArena,
+                                         const char * const pcTimerName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                         const TickType_t xTimerPeriodInTicks,
+                                         const BaseType_t xAutoReload,
+                                         void * const pvTimerID,
+                                         TimerCallbackFunction_t pxCallbackFunction )
+        {
+            TimerHandle_t xReturn = NULL;
+            void * pvTimer;
+
+            configASSERT( xArena );
+
+            taskENTER_CRITICAL();
+            {
+                pvTimer = prvAllocate( xArena, sizeof( StaticTimer_t ), ( size_t ) portBYTE_ALIGNMENT );
+            }
+            taskEXIT_CRITICAL();
+
+            if( pvTimer != NULL )
+            {
+                xReturn = xTimerCreateStatic( pcTimerName, xTimerPeriodInTicks, xAutoReload, pvTimerID, pxCallbackFunction, ( StaticTimer_t * ) pvTimer ); /*lint !e9079 The memory is aligned to portBYTE_ALIGNMENT. */
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return xReturn;
+        }
+
+    #endif /* configUSE_TIMERS */
+/*-----------------------------------------------------------*/
+
+    StreamBufferHandle_t xArenaStreamBufferGenericCreate( ArenaHandle_t xArena,
+                                                          size_t xBufferSizeBytes,
+                                                          size_t xTriggerLevelBytes,
+                                                          BaseType_t xStreamBufferType )
+    {
+        StreamBufferHandle_t xReturn = NULL;
+        size_t xStorageAlignment;
+        void * pvStorage;
+        void * pvStreamBuffer;
+
+        configASSERT( xArena );
+
+        if( ( xStreamBufferType & sbTYPE_FLAG_POWER_OF_TWO_RING ) != ( BaseType_t ) 0 )
+        {
+            /* The whole storage area of a power of two ring is usable, and it
+             * is aligned as if it had been allocated by
+             * xStreamBufferGenericCreate(). */
+            xStorageAlignment = ( ( size_t ) configSTREAM_BUFFER_STORAGE_ALIGNMENT > ( size_t ) portBYTE_ALIGNMENT ) ? ( size_t ) configSTREAM_BUFFER_STORAGE_ALIGNMENT : ( size_t ) portBYTE_ALIGNMENT;
+        }
+        else if( xBufferSizeBytes < ( xBufferSizeBytes + ( size_t ) 1 ) )
+        {
+            /* As xStreamBufferGenericCreate(), allocate one more byte than
+             * requested so the buffer can hold xBufferSizeBytes bytes. */
+            xBufferSizeBytes++;
+            xStorageAlignment = ( size_t ) portBYTE_ALIGNMENT;
+        }
+        else
+        {
+            xStorageAlignment = ( size_t ) 0;
+        }
+
+        if( xStorageAlignment != ( size_t ) 0 )
+        {
+            if( prvAllocatePair( xArena, xBufferSizeBytes, xStorageAlignment, &pvStorage, sizeof( StaticStreamBuffer_t ), &pvStreamBuffer ) != pdFAIL )
+            {
+                xReturn = xStreamBufferGenericCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, xStreamBufferType, ( uint8_t * ) pvStorage, ( StaticStreamBuffer_t * ) pvStreamBuffer ); /*lint !e9079 The memory is aligned to portBYTE_ALIGNMENT. */
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvInitialiseNewArena( Arena_t * const pxArena,
+                                       uint8_t * const pucStart,
+                                       size_t xSizeInBytes,
+                                       uint8_t ucStaticallyAllocated )
+    {
+        /* Only whole multiples of portBYTE_ALIGNMENT are allocated, so any
+         * bytes at the end of the memory that do not make up a whole multiple
+         * are not used. */
+        pxArena->pucStart = pucStart;
+        pxArena->xSize = xSizeInBytes & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+        pxArena->xUsed = ( size_t ) 0;
+        pxArena->xMaximumUsed = ( size_t ) 0;
+        pxArena->ucStaticallyAllocated = ucStaticallyAllocated;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvAllocatePair( Arena_t * const pxArena,
+                                       size_t xFirstSize,
+                                       size_t xFirstAlignment,
+                                       void ** ppvFirst,
+                                       size_t xSecondSize,
+                                       void ** ppvSecond )
+    {
+        BaseType_t xReturn = pdFAIL;
+        size_t xUsedBefore;
+        size_t xMaximumUsedBefore;
+
+        taskENTER_CRITICAL();
+        {
+            xUsedBefore = pxArena->xUsed;
+            xMaximumUsedBefore = pxArena->xMaximumUsed;
+
+            if( xFirstSize > ( size_t ) 0 )
+            {
+                *ppvFirst = prvAllocate( pxArena, xFirstSize, xFirstAlignment );
+            }
+            else
+            {
+                *ppvFirst = NULL;
+            }
+
+            if( ( *ppvFirst != NULL ) || ( xFirstSize == ( size_t ) 0 ) )
+            {
+                *ppvSecond = prvAllocate( pxArena, xSecondSize, ( size_t ) portBYTE_ALIGNMENT );
+
+                if( *ppvSecond != NULL )
+                {
+                    xReturn = pdPASS;
+                }
+                else
+                {
+                    /* Return the first block to the arena. */
+                    pxArena->xUsed = xUsedBefore;
+                    pxArena->xMaximumUsed = xMaximumUsedBefore;
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void * prvAllocate( Arena_t * const pxArena,
+                               size_t xSize,
+                               size_t xAlignment )
+    {
+        uint8_t * pucNext;
+        size_t xPaddingBytes;
+        size_t xFreeBytes;
+        void * pvReturn = NULL;
+
+        configASSERT( ( xAlignment & ( xAlignment - ( size_t ) 1 ) ) == ( size_t ) 0 );
+
+        pucNext = pxArena->pucStart + pxArena->xUsed;
+        xPaddingBytes = ( ( size_t ) 0 - ( size_t ) ( portPOINTER_SIZE_TYPE ) pucNext ) & ( xAlignment - ( size_t ) 1 ); /*lint !e923 !e9078 Address arithmetic is used to align the allocation. */
+        xFreeBytes = pxArena->xSize - pxArena->xUsed;
+
+        /* Allocations are rounded up to portBYTE_ALIGNMENT so the next
+         * allocation starts aligned whenever xAlignment is portBYTE_ALIGNMENT. */
+        if( ( xSize > ( size_t ) 0 ) &&
+            ( xSize <= arenaALIGN_SIZE( xSize ) ) &&
+            ( xPaddingBytes <= xFreeBytes ) &&
+            ( arenaALIGN_SIZE( xSize ) <= ( xFreeBytes - xPaddingBytes ) ) )
+        {
+            pvReturn = ( void * ) ( pucNext + xPaddingBytes );
+            pxArena->xUsed += xPaddingBytes + arenaALIGN_SIZE( xSize );
+
+            if( pxArena->xUsed > pxArena->xMaximumUsed )
+            {
+                pxArena->xMaximumUsed = pxArena->xUsed;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pvReturn;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_ARENAS == 1 */
@@ -39,6 +39,7 @@
 #include "task.h"
 #include "timers.h"
 #include "event_groups.h"
+#include "slab.h"
 
 /* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
  * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
@@ -49,7 +50,12 @@
 /* The following bit fields convey control information in a task's event list
  * item value.  It is important they don't clash with the
  * taskEVENT_LIST_ITEM_VALUE_IN_USE definition. */
-#if configUSE_16_BIT_TICKS == 1
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+    #define eventCLEAR_EVENTS_ON_EXIT_BIT    0x0100000000000000ULL
+    #define eventUNBLOCKED_DUE_TO_BIT_SET    0x0200000000000000ULL
+    #define eventWAIT_FOR_ALL_BITS           0x0400000000000000ULL
+    #define eventEVENT_BITS_CONTROL_BYTES    0xff00000000000000ULL
+#elif configUSE_16_BIT_TICKS == 1
     #define eventCLEAR_EVENTS_ON_EXIT_BIT    0x0100U
     #define eventUNBLOCKED_DUE_TO_BIT_SET    0x0200U
     #define eventWAIT_FOR_ALL_BITS           0x0400U
@@ -61,6 +67,53 @@
     #define eventEVENT_BITS_CONTROL_BYTES    0xff000000UL
 #endif
 
+/* A 64-bit event group value does not fit in the TickType_t value of a task's
+ * event list item on all ports, so the 64-bit variants of the unordered event
+ * list functions are used to hold the value in the task's TCB instead. */
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+    #define eventPLACE_ON_UNORDERED_EVENT_LIST( pxEventList, uxItemValue, xTicksToWait )    vTaskPlaceOnUnorderedEventList64( ( pxEventList ), ( uxItemValue ), ( xTicksToWait ) )
+    #define eventREMOVE_FROM_UNORDERED_EVENT_LIST( pxEventListItem, uxItemValue )           vTaskRemoveFromUnorderedEventList64( ( pxEventListItem ), ( uxItemValue ) )
+    #define eventGET_EVENT_ITEM_VALUE( pxEventListItem )                                    ullTaskGetEventItemValue64( pxEventListItem )
+    #define eventRESET_EVENT_ITEM_VALUE()                                                   ullTaskResetEventItemValue64()
+    #define eventREMOVE_FROM_UNORDERED_EVENT_LIST_FROM_ISR( pxEventListItem, uxItemValue )  xTaskRemoveFromUnorderedEventListFromISR64( ( pxEventListItem ), ( uxItemValue ) )
+#else
+    #define eventPLACE_ON_UNORDERED_EVENT_LIST( pxEventList, uxItemValue, xTicksToWait )    vTaskPlaceOnUnorderedEventList( ( pxEventList ), ( uxItemValue ), ( xTicksToWait ) )
+    #define eventREMOVE_FROM_UNORDERED_EVENT_LIST( pxEventListItem, uxItemValue )           vTaskRemoveFromUnorderedEventList( ( pxEventListItem ), ( uxItemValue ) )
+    #define eventGET_EVENT_ITEM_VALUE( pxEventListItem )                                    listGET_LIST_ITEM_VALUE( pxEventListItem )
+    #define eventRESET_EVENT_ITEM_VALUE()                                                   uxTaskResetEventItemValue()
+    #define eventREMOVE_FROM_UNORDERED_EVENT_LIST_FROM_ISR( pxEventListItem, uxItemValue )  xTaskRemoveFromUnorderedEventListFromISR( ( pxEventListItem ), ( uxItemValue ) )
+#endif
+
+/* Dynamically allocated event groups come from the event group slab cache when
+ * slab caches are in use, otherwise directly from the heap. */
+#if ( configUSE_SLAB_CACHES == 1 )
+    #define eventALLOCATE_EVENT_GROUP()             ( ( EventGroup_t * ) pvSlabAllocate( eSlabCacheEventGroup, sizeof( EventGroup_t ) ) )
+    #define eventFREE_EVENT_GROUP( pxEventBits )    vSlabFree( pxEventBits )
+#else
+    #define eventALLOCATE_EVENT_GROUP()             ( ( EventGroup_t * ) pvPortMalloc( sizeof( EventGroup_t ) ) )
+    #define eventFREE_EVENT_GROUP( pxEventBits )    vPortFree( pxEventBits )
+#endif
+
+/* Bits set and cleared from interrupts are accumulated in the event group,
+ * instead of being passed to the timer task in the parameter of a pended
+ * function call, if they may not fit in that parameter or if they may be
+ * applied by a task that has the event group locked. */
+#define eventACCUMULATE_BITS_FROM_ISR    ( ( configUSE_64_BIT_EVENT_GROUPS == 1 ) || ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 ) )
+
+/* If interrupts can access event groups directly then tasks lock an event
+ * group while accessing it with the scheduler suspended.  Interrupts only
+ * accumulate bits in an event group that is locked, and the task that unlocks
+ * the event group applies them. */
+#if ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 )
+    #define eventLOCK_EVENT_GROUP( pxEventBits )         prvLockEventGroup( pxEventBits )
+    #define eventUNLOCK_EVENT_GROUP( pxEventBits )       prvUnlockEventGroup( pxEventBits )
+    #define eventIS_EVENT_GROUP_LOCKED( pxEventBits )    ( ( ( pxEventBits )->uxLockCount != ( UBaseType_t ) 0 ) ? pdTRUE : pdFALSE )
+#else
+    #define eventLOCK_EVENT_GROUP( pxEventBits )
+    #define eventUNLOCK_EVENT_GROUP( pxEventBits )
+    #define eventIS_EVENT_GROUP_LOCKED( pxEventBits )    pdFALSE
+#endif
+
 typedef struct EventGroupDef_t
 {
     EventBits_t uxEventBits;
@@ -73,6 +126,19 @@ typedef struct EventGroupDef_t
     #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
         uint8_t ucStaticallyAllocated; /*< Set to pdTRUE if the event group is statically allocated to ensure no attempt is made to free the memory. */
     #endif
+
+    #if ( eventACCUMULATE_BITS_FROM_ISR )
+        EventBits_t uxBitsToSetFromISR;   /*< Bits set from interrupts that have not yet been applied. */
+        EventBits_t uxBitsToClearFromISR; /*< Bits cleared from interrupts that have not yet been applied. */
+    #endif
+
+    #if ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 )
+        volatile UBaseType_t uxLockCount; /*< Non-zero while a task is accessing the event group with the scheduler suspended. */
+    #endif
+
+    #if ( configEVENT_GROUP_WAITER_LISTS > 0 )
+        List_t xTasksWaitingForBit[ configEVENT_GROUP_WAITER_LISTS ]; /*< Lists of tasks indexed by a bit they are waiting for, so setting a bit only tests the tasks that could be unblocked by it. */
+    #endif
 } EventGroup_t;
 
 /*-----------------------------------------------------------*/
@@ -89,6 +155,97 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits,
                                         const EventBits_t uxBitsToWaitFor,
                                         const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
 
+/*
+ * Initialise the members of a newly created event group.
+ */
+static void prvInitialiseNewEventGroup( EventGroup_t * pxEventBits ) PRIVILEGED_FUNCTION;
+
+#if ( eventACCUMULATE_BITS_FROM_ISR && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+
+/*
+ * Executed in the context of the timer task to apply the bits that were set
+ * and cleared from interrupts since the last time it executed.  The bits are
+ * held in the event group rather than in the 32-bit parameter of the pended
+ * function call.
+ */
+    static void prvApplyBitsFromISR( void * pvEventGroup,
+                                     uint32_t ulUnused ) PRIVILEGED_FUNCTION;
+
+/*
+ * Set or clear bits from an interrupt.  If configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS
+ * allows then the bits are updated, and any tasks they unblock are unblocked,
+ * immediately.  Otherwise the bits are recorded in the event group, and a call
+ * to prvApplyBitsFromISR() is pended if one is not already pending and no task
+ * has the event group locked.
+ */
+    static BaseType_t prvUpdateBitsFromISR( EventGroup_t * pxEventBits,
+                                            const EventBits_t uxBitsToSet,
+                                            const EventBits_t uxBitsToClear,
+                                            BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 )
+
+/*
+ * Lock and unlock an event group as described by the definition of
+ * eventLOCK_EVENT_GROUP() above.  Unlocking the event group applies any bits
+ * that were set or cleared from interrupts while it was locked.
+ */
+    static void prvLockEventGroup( EventGroup_t * pxEventBits ) PRIVILEGED_FUNCTION;
+    static void prvUnlockEventGroup( EventGroup_t * pxEventBits ) PRIVILEGED_FUNCTION;
+
+/*
+ * Count the tasks that prvUnblockWaitingTasks() would test if uxBitsSet were
+ * set, so the time spent setting bits from an interrupt can be bounded.
+ */
+    static UBaseType_t prvCountWaitingTasks( EventGroup_t * pxEventBits,
+                                             const EventBits_t uxBitsSet ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Test the tasks in pxWaitingList against the current event bits, unblocking those
+ * whose wait condition is met.  Returns the bits that should be cleared because
+ * an unblocked task used the eventCLEAR_EVENTS_ON_EXIT_BIT option.  If
+ * pxHigherPriorityTaskWoken is NULL the tasks are unblocked with the scheduler
+ * suspended, otherwise they are unblocked from an interrupt or critical section
+ * and *pxHigherPriorityTaskWoken is set to pdTRUE if an unblocked task has a
+ * priority above that of the interrupted task.
+ */
+static EventBits_t prvTestWaitingTasks( EventGroup_t * pxEventBits,
+                                        List_t * pxWaitingList,
+                                        BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * Test every task that could have been unblocked by uxBitsSet being set, as
+ * described for prvTestWaitingTasks().
+ */
+static EventBits_t prvUnblockWaitingTasks( EventGroup_t * pxEventBits,
+                                           const EventBits_t uxBitsSet,
+                                           BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+#if ( configEVENT_GROUP_WAITER_LISTS > 0 )
+
+/*
+ * Return a bit mask with bit n set if waiting list n indexes any of the bits in
+ * uxBitsSet.
+ */
+    static EventBits_t prvGetListsToTest( const EventBits_t uxBitsSet ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return the list a task waiting with event list item value uxItemValue should
+ * be held in.  A task waiting for a single bit, or for all of a set of bits, is
+ * held in the list that indexes the bit it is waiting for, or the lowest of the
+ * bits it is waiting for that is still clear.  A task waiting for any one of
+ * several bits is held in xTasksWaitingForBits.
+ */
+    static List_t * prvGetWaitingList( EventGroup_t * pxEventBits,
+                                       const EventBits_t uxItemValue ) PRIVILEGED_FUNCTION;
+
+    #define eventGET_WAITING_LIST( pxEventBits, uxItemValue )    prvGetWaitingList( ( pxEventBits ), ( uxItemValue ) )
+#else
+    #define eventGET_WAITING_LIST( pxEventBits, uxItemValue )    ( &( ( pxEventBits )->xTasksWaitingForBits ) )
+#endif
+
 /*-----------------------------------------------------------*/
 
 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
@@ -115,8 +272,7 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits,
 
         if( pxEventBits != NULL )
         {
-            pxEventBits->uxEventBits = 0;
-            vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+            prvInitialiseNewEventGroup( pxEventBits );
 
             #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
             {
@@ -162,12 +318,11 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits,
          * sizeof( TickType_t ), the TickType_t variables will be accessed in two
          * or more reads operations, and the alignment requirements is only that
          * of each individual read. */
-        pxEventBits = ( EventGroup_t * ) pvPortMalloc( sizeof( EventGroup_t ) ); /*lint !e9087 !e9079 see comment above. */
+        pxEventBits = eventALLOCATE_EVENT_GROUP(); /*lint !e9087 !e9079 see comment above. */
 
         if( pxEventBits != NULL )
         {
-            pxEventBits->uxEventBits = 0;
-            vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+            prvInitialiseNewEventGroup( pxEventBits );
 
             #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
             {
@@ -210,6 +365,7 @@ EventBits_t xEventGroupSync( EventGroupHandle_t xEventGroup,
     #endif
 
     vTaskSuspendAll();
+    eventLOCK_EVENT_GROUP( pxEventBits );
     {
         uxOriginalBitValue = pxEventBits->uxEventBits;
 
@@ -235,7 +391,7 @@ EventBits_t xEventGroupSync( EventGroupHandle_t xEventGroup,
                 /* Store the bits that the calling task is waiting for in the
                  * task's event list item so the kernel knows when a match is
                  * found.  Then enter the blocked state. */
-                vTaskPlaceOnUnorderedEventList( &( pxEventBits->xTasksWaitingForBits ), ( uxBitsToWaitFor | eventCLEAR_EVENTS_ON_EXIT_BIT | eventWAIT_FOR_ALL_BITS ), xTicksToWait );
+                eventPLACE_ON_UNORDERED_EVENT_LIST( eventGET_WAITING_LIST( pxEventBits, ( uxBitsToWaitFor | eventCLEAR_EVENTS_ON_EXIT_BIT | eventWAIT_FOR_ALL_BITS ) ), ( uxBitsToWaitFor | eventCLEAR_EVENTS_ON_EXIT_BIT | eventWAIT_FOR_ALL_BITS ), xTicksToWait );
 
                 /* This assignment is obsolete as uxReturn will get set after
                  * the task unblocks, but some compilers mistakenly generate a
@@ -252,6 +408,7 @@ EventBits_t xEventGroupSync( EventGroupHandle_t xEventGroup,
             }
         }
     }
+    eventUNLOCK_EVENT_GROUP( pxEventBits );
     xAlreadyYielded = xTaskResumeAll();
 
     if( xTicksToWait != ( TickType_t ) 0 )
@@ -269,7 +426,7 @@ EventBits_t xEventGroupSync( EventGroupHandle_t xEventGroup,
          * point either the required bits were set or the block time expired.  If
          * the required bits were set they will have been stored in the task's
          * event list item, and they should now be retrieved then cleared. */
-        uxReturn = uxTaskResetEventItemValue();
+        uxReturn = eventRESET_EVENT_ITEM_VALUE();
 
         if( ( uxReturn & eventUNBLOCKED_DUE_TO_BIT_SET ) == ( EventBits_t ) 0 )
         {
@@ -337,6 +494,7 @@ EventBits_t xEventGroupWaitBits( EventGroupHandle_t xEventGroup,
     #endif
 
     vTaskSuspendAll();
+    eventLOCK_EVENT_GROUP( pxEventBits );
     {
         const EventBits_t uxCurrentEventBits = pxEventBits->uxEventBits;
 
@@ -394,7 +552,7 @@ EventBits_t xEventGroupWaitBits( EventGroupHandle_t xEventGroup,
             /* Store the bits that the calling task is waiting for in the
              * task's event list item so the kernel knows when a match is
              * found.  Then enter the blocked state. */
-            vTaskPlaceOnUnorderedEventList( &( pxEventBits->xTasksWaitingForBits ), ( uxBitsToWaitFor | uxControlBits ), xTicksToWait );
+            eventPLACE_ON_UNORDERED_EVENT_LIST( eventGET_WAITING_LIST( pxEventBits, ( uxBitsToWaitFor | uxControlBits ) ), ( uxBitsToWaitFor | uxControlBits ), xTicksToWait );
 
             /* This is obsolete as it will get set after the task unblocks, but
              * some compilers mistakenly generate a warning about the variable
@@ -404,6 +562,7 @@ EventBits_t xEventGroupWaitBits( EventGroupHandle_t xEventGroup,
             traceEVENT_GROUP_WAIT_BITS_BLOCK( xEventGroup, uxBitsToWaitFor );
         }
     }
+    eventUNLOCK_EVENT_GROUP( pxEventBits );
     xAlreadyYielded = xTaskResumeAll();
 
     if( xTicksToWait != ( TickType_t ) 0 )
@@ -421,7 +580,7 @@ EventBits_t xEventGroupWaitBits( EventGroupHandle_t xEventGroup,
          * point either the required bits were set or the block time expired.  If
          * the required bits were set they will have been stored in the task's
          * event list item, and they should now be retrieved then cleared. */
-        uxReturn = uxTaskResetEventItemValue();
+        uxReturn = eventRESET_EVENT_ITEM_VALUE();
 
         if( ( uxReturn & eventUNBLOCKED_DUE_TO_BIT_SET ) == ( EventBits_t ) 0 )
         {
@@ -498,20 +657,32 @@ EventBits_t xEventGroupClearBits( EventGroupHandle_t xEventGroup,
 }
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+#if ( ( ( configUSE_TRACE_FACILITY == 1 ) || eventACCUMULATE_BITS_FROM_ISR ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
     BaseType_t xEventGroupClearBitsFromISR( EventGroupHandle_t xEventGroup,
                                             const EventBits_t uxBitsToClear )
     {
         BaseType_t xReturn;
 
+        configASSERT( xEventGroup );
+        configASSERT( ( uxBitsToClear & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+
         traceEVENT_GROUP_CLEAR_BITS_FROM_ISR( xEventGroup, uxBitsToClear );
-        xReturn = xTimerPendFunctionCallFromISR( vEventGroupClearBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToClear, NULL ); /*lint !e9087 Can't avoid cast to void* as a generic callback function not specific to this use case. Callback casts back to original type so safe. */
+
+        #if ( eventACCUMULATE_BITS_FROM_ISR )
+        {
+            xReturn = prvUpdateBitsFromISR( xEventGroup, 0, uxBitsToClear, NULL );
+        }
+        #else
+        {
+            xReturn = xTimerPendFunctionCallFromISR( vEventGroupClearBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToClear, NULL ); /*lint !e9087 Can't avoid cast to void* as a generic callback function not specific to this use case. Callback casts back to original type so safe. */
+        }
+        #endif
 
         return xReturn;
     }
 
-#endif /* if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
+#endif /* if ( ( ( configUSE_TRACE_FACILITY == 1 ) || eventACCUMULATE_BITS_FROM_ISR ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
 /*-----------------------------------------------------------*/
 
 EventBits_t xEventGroupGetBitsFromISR( EventGroupHandle_t xEventGroup )
@@ -533,92 +704,30 @@ EventBits_t xEventGroupGetBitsFromISR( EventGroupHandle_t xEventGroup )
 EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup,
                                 const EventBits_t uxBitsToSet )
 {
-    ListItem_t * pxListItem, * pxNext;
-    ListItem_t const * pxListEnd;
-    List_t const * pxList;
-    EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
+    EventBits_t uxBitsToClear;
     EventGroup_t * pxEventBits = xEventGroup;
-    BaseType_t xMatchFound = pdFALSE;
 
     /* Check the user is not attempting to set the bits used by the kernel
      * itself. */
     configASSERT( xEventGroup );
     configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
 
-    pxList = &( pxEventBits->xTasksWaitingForBits );
-    pxListEnd = listGET_END_MARKER( pxList ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
     vTaskSuspendAll();
+    eventLOCK_EVENT_GROUP( pxEventBits );
     {
         traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet );
 
-        pxListItem = listGET_HEAD_ENTRY( pxList );
-
         /* Set the bits. */
         pxEventBits->uxEventBits |= uxBitsToSet;
 
         /* See if the new bit value should unblock any tasks. */
-        while( pxListItem != pxListEnd )
-        {
-            pxNext = listGET_NEXT( pxListItem );
-            uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
-            xMatchFound = pdFALSE;
-
-            /* Split the bits waited for from the control bits. */
-            uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
-            uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
-
-            if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
-            {
-                /* Just looking for single bit being set. */
-                if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
-                {
-                    xMatchFound = pdTRUE;
-                }
-                else
-                {
-                    mtCOVERAGE_TEST_MARKER();
-                }
-            }
-            else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
-            {
-                /* All bits are set. */
-                xMatchFound = pdTRUE;
-            }
-            else
-            {
-                /* Need all bits to be set, but not all the bits were set. */
-            }
-
-            if( xMatchFound != pdFALSE )
-            {
-                /* The bits match.  Should the bits be cleared on exit? */
-                if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
-                {
-                    uxBitsToClear |= uxBitsWaitedFor;
-                }
-                else
-                {
-                    mtCOVERAGE_TEST_MARKER();
-                }
-
-                /* Store the actual event flag value in the task's event list
-                 * item before removing the task from the event list.  The
-                 * eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
-                 * that is was unblocked due to its required bits matching, rather
-                 * than because it timed out. */
-                vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
-            }
-
-            /* Move onto the next list item.  Note pxListItem->pxNext is not
-             * used here as the list item may have been removed from the event list
-             * and inserted into the ready/pending reading list. */
-            pxListItem = pxNext;
-        }
+        uxBitsToClear = prvUnblockWaitingTasks( pxEventBits, uxBitsToSet, NULL );
 
         /* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
          * bit was set in the control word. */
         pxEventBits->uxEventBits &= ~uxBitsToClear;
     }
+    eventUNLOCK_EVENT_GROUP( pxEventBits );
     ( void ) xTaskResumeAll();
 
     return pxEventBits->uxEventBits;
@@ -629,30 +738,46 @@ void vEventGroupDelete( EventGroupHandle_t xEventGroup )
 {
     EventGroup_t * pxEventBits = xEventGroup;
     const List_t * pxTasksWaitingForBits;
+    UBaseType_t uxList;
 
     configASSERT( pxEventBits );
 
-    pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
-
     vTaskSuspendAll();
+    eventLOCK_EVENT_GROUP( pxEventBits );
     {
         traceEVENT_GROUP_DELETE( xEventGroup );
 
-        while( listCURRENT_LIST_LENGTH( pxTasksWaitingForBits ) > ( UBaseType_t ) 0 )
+        /* List 0 is xTasksWaitingForBits, lists 1 onwards are the lists
+         * indexed by bit, if any. */
+        for( uxList = 0; uxList <= ( UBaseType_t ) configEVENT_GROUP_WAITER_LISTS; uxList++ )
         {
-            /* Unblock the task, returning 0 as the event list is being deleted
-             * and cannot therefore have any bits set. */
-            configASSERT( pxTasksWaitingForBits->xListEnd.pxNext != ( const ListItem_t * ) &( pxTasksWaitingForBits->xListEnd ) );
-            vTaskRemoveFromUnorderedEventList( pxTasksWaitingForBits->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
+            #if ( configEVENT_GROUP_WAITER_LISTS > 0 )
+            {
+                pxTasksWaitingForBits = ( uxList == ( UBaseType_t ) 0 ) ? &( pxEventBits->xTasksWaitingForBits ) : &( pxEventBits->xTasksWaitingForBit[ uxList - ( UBaseType_t ) 1 ] );
+            }
+            #else
+            {
+                pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
+            }
+            #endif
+
+            while( listCURRENT_LIST_LENGTH( pxTasksWaitingForBits ) > ( UBaseType_t ) 0 )
+            {
+                /* Unblock the task, returning 0 as the event list is being deleted
+                 * and cannot therefore have any bits set. */
+                configASSERT( pxTasksWaitingForBits->xListEnd.pxNext != ( const ListItem_t * ) &( pxTasksWaitingForBits->xListEnd ) );
+                eventREMOVE_FROM_UNORDERED_EVENT_LIST( pxTasksWaitingForBits->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
+            }
         }
     }
+    eventUNLOCK_EVENT_GROUP( pxEventBits );
     ( void ) xTaskResumeAll();
 
     #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
     {
         /* The event group can only have been allocated dynamically - free
          * it again. */
-        vPortFree( pxEventBits );
+        eventFREE_EVENT_GROUP( pxEventBits );
     }
     #elif ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
     {
@@ -660,7 +785,7 @@ void vEventGroupDelete( EventGroupHandle_t xEventGroup )
          * dynamically, so check before attempting to free the memory. */
         if( pxEventBits->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
         {
-            vPortFree( pxEventBits );
+            eventFREE_EVENT_GROUP( pxEventBits );
         }
         else
         {
@@ -726,7 +851,7 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits,
 }
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+#if ( ( ( configUSE_TRACE_FACILITY == 1 ) || eventACCUMULATE_BITS_FROM_ISR ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
     BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup,
                                           const EventBits_t uxBitsToSet,
@@ -734,13 +859,582 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits,
     {
         BaseType_t xReturn;
 
+        configASSERT( xEventGroup );
+        configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+
         traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet );
-        xReturn = xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken ); /*lint !e9087 Can't avoid cast to void* as a generic callback function not specific to this use case. Callback casts back to original type so safe. */
+
+        #if ( eventACCUMULATE_BITS_FROM_ISR )
+        {
+            xReturn = prvUpdateBitsFromISR( xEventGroup, uxBitsToSet, 0, pxHigherPriorityTaskWoken );
+        }
+        #else
+        {
+            xReturn = xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken ); /*lint !e9087 Can't avoid cast to void* as a generic callback function not specific to this use case. Callback casts back to original type so safe. */
+        }
+        #endif
+
+        return xReturn;
+    }
+
+#endif /* if ( ( ( configUSE_TRACE_FACILITY == 1 ) || eventACCUMULATE_BITS_FROM_ISR ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( eventACCUMULATE_BITS_FROM_ISR && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+
+    static BaseType_t prvUpdateBitsFromISR( EventGroup_t * pxEventBits,
+                                            const EventBits_t uxBitsToSet,
+                                            const EventBits_t uxBitsToClear,
+                                            BaseType_t * pxHigherPriorityTaskWoken )
+    {
+        BaseType_t xReturn = pdPASS;
+        BaseType_t xUpdateDeferred = pdTRUE;
+        EventBits_t uxPreviousBitsToSet, uxPreviousBitsToClear;
+        UBaseType_t uxSavedInterruptStatus;
+
+        uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+        {
+            uxPreviousBitsToSet = pxEventBits->uxBitsToSetFromISR;
+            uxPreviousBitsToClear = pxEventBits->uxBitsToClearFromISR;
+
+            #if ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 )
+            {
+                /* The event group can only be updated from here if no task has
+                 * it locked, if no earlier update from an interrupt is still
+                 * waiting to be applied (so updates are applied in order), and
+                 * if there are few enough waiting tasks to keep the time spent
+                 * in the interrupt bounded. */
+                if( ( pxEventBits->uxLockCount == ( UBaseType_t ) 0 ) &&
+                    ( ( uxPreviousBitsToSet | uxPreviousBitsToClear ) == ( EventBits_t ) 0 ) &&
+                    ( prvCountWaitingTasks( pxEventBits, uxBitsToSet ) <= ( UBaseType_t ) configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS ) )
+                {
+                    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+                    EventBits_t uxBitsToClearOnExit;
+
+                    /* This performs the same function as xEventGroupSetBits(),
+                     * but from within a critical section rather than with the
+                     * scheduler suspended. */
+                    pxEventBits->uxEventBits &= ~uxBitsToClear;
+                    pxEventBits->uxEventBits |= uxBitsToSet;
+                    uxBitsToClearOnExit = prvUnblockWaitingTasks( pxEventBits, uxBitsToSet, &xHigherPriorityTaskWoken );
+                    pxEventBits->uxEventBits &= ~uxBitsToClearOnExit;
+
+                    if( xHigherPriorityTaskWoken != pdFALSE )
+                    {
+                        if( pxHigherPriorityTaskWoken != NULL )
+                        {
+                            *pxHigherPriorityTaskWoken = pdTRUE;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    xUpdateDeferred = pdFALSE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS */
+
+            if( xUpdateDeferred != pdFALSE )
+            {
+                /* Setting a bit cancels any pending clear of the same bit, as
+                 * the bit must end up set.  Clearing a bit does not cancel a
+                 * pending set of the same bit because tasks waiting for the bit
+                 * must still be unblocked - the set is applied before the
+                 * clear. */
+                pxEventBits->uxBitsToSetFromISR = uxPreviousBitsToSet | uxBitsToSet;
+                pxEventBits->uxBitsToClearFromISR = ( uxPreviousBitsToClear & ~uxBitsToSet ) | uxBitsToClear;
+
+                if( ( ( uxPreviousBitsToSet | uxPreviousBitsToClear ) == ( EventBits_t ) 0 ) &&
+                    ( eventIS_EVENT_GROUP_LOCKED( pxEventBits ) == pdFALSE ) )
+                {
+                    /* There is not already a call to prvApplyBitsFromISR()
+                     * pending, so pend one now. */
+                    xReturn = xTimerPendFunctionCallFromISR( prvApplyBitsFromISR, ( void * ) pxEventBits, 0UL, pxHigherPriorityTaskWoken ); /*lint !e9087 Can't avoid cast to void* as a generic callback function not specific to this use case. Callback casts back to original type so safe. */
+
+                    if( xReturn != pdPASS )
+                    {
+                        /* The timer command queue was full, so nothing will
+                         * apply the bits. */
+                        pxEventBits->uxBitsToSetFromISR = 0;
+                        pxEventBits->uxBitsToClearFromISR = 0;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    /* The bits will be applied by the call that is already
+                     * pending, or by the task that has the event group locked
+                     * when it unlocks the event group. */
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
 
         return xReturn;
     }
 
-#endif /* if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
+#endif /* if ( eventACCUMULATE_BITS_FROM_ISR && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( eventACCUMULATE_BITS_FROM_ISR && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+
+    static void prvApplyBitsFromISR( void * pvEventGroup,
+                                     uint32_t ulUnused )
+    {
+        EventGroup_t * pxEventBits = pvEventGroup; /*lint !e9079 Can't avoid cast to void* as a generic timer callback prototype. Callback casts back to original type so safe. */
+        EventBits_t uxBitsToSet, uxBitsToClear;
+
+        ( void ) ulUnused;
+
+        /* Take all the bits that have been set and cleared from interrupts so
+         * far - any set or cleared after this point will pend another call. */
+        taskENTER_CRITICAL();
+        {
+            uxBitsToSet = pxEventBits->uxBitsToSetFromISR;
+            uxBitsToClear = pxEventBits->uxBitsToClearFromISR;
+            pxEventBits->uxBitsToSetFromISR = 0;
+            pxEventBits->uxBitsToClearFromISR = 0;
+        }
+        taskEXIT_CRITICAL();
+
+        if( uxBitsToSet != ( EventBits_t ) 0 )
+        {
+            ( void ) xEventGroupSetBits( pxEventBits, uxBitsToSet );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( uxBitsToClear != ( EventBits_t ) 0 )
+        {
+            ( void ) xEventGroupClearBits( pxEventBits, uxBitsToClear );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* if ( eventACCUMULATE_BITS_FROM_ISR && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 )
+
+    static void prvLockEventGroup( EventGroup_t * pxEventBits )
+    {
+        taskENTER_CRITICAL();
+        {
+            ( pxEventBits->uxLockCount )++;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+#endif /* configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS */
+/*-----------------------------------------------------------*/
+
+#if ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 )
+
+    static void prvUnlockEventGroup( EventGroup_t * pxEventBits )
+    {
+        EventBits_t uxBitsToSet, uxBitsToClear;
+
+        /* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED. */
+
+        do
+        {
+            /* Take the bits set and cleared from interrupts while the event
+             * group was locked, and only unlock the event group once there are
+             * none left - otherwise bits set from an interrupt between taking
+             * them and unlocking would not be applied.  Only the outermost lock
+             * applies the bits. */
+            taskENTER_CRITICAL();
+            {
+                uxBitsToSet = 0;
+                uxBitsToClear = 0;
+
+                if( pxEventBits->uxLockCount == ( UBaseType_t ) 1 )
+                {
+                    uxBitsToSet = pxEventBits->uxBitsToSetFromISR;
+                    uxBitsToClear = pxEventBits->uxBitsToClearFromISR;
+                    pxEventBits->uxBitsToSetFromISR = 0;
+                    pxEventBits->uxBitsToClearFromISR = 0;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( ( uxBitsToSet | uxBitsToClear ) == ( EventBits_t ) 0 )
+                {
+                    ( pxEventBits->uxLockCount )--;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            /* The event group is still locked, so xEventGroupSetBits() will not
+             * call this function recursively. */
+            if( uxBitsToSet != ( EventBits_t ) 0 )
+            {
+                ( void ) xEventGroupSetBits( pxEventBits, uxBitsToSet );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( uxBitsToClear != ( EventBits_t ) 0 )
+            {
+                ( void ) xEventGroupClearBits( pxEventBits, uxBitsToClear );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        } while( ( uxBitsToSet | uxBitsToClear ) != ( EventBits_t ) 0 );
+    }
+
+#endif /* configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS */
+/*-----------------------------------------------------------*/
+
+static EventBits_t prvTestWaitingTasks( EventGroup_t * pxEventBits,
+                                        List_t * pxWaitingList,
+                                        BaseType_t * pxHigherPriorityTaskWoken )
+{
+    ListItem_t * pxListItem, * pxNext;
+    ListItem_t const * pxListEnd;
+    EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
+    BaseType_t xMatchFound = pdFALSE;
+
+    pxListEnd = listGET_END_MARKER( pxWaitingList ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+    pxListItem = listGET_HEAD_ENTRY( pxWaitingList );
+
+    while( pxListItem != pxListEnd )
+    {
+        pxNext = listGET_NEXT( pxListItem );
+        uxBitsWaitedFor = eventGET_EVENT_ITEM_VALUE( pxListItem );
+        xMatchFound = pdFALSE;
+
+        /* Split the bits waited for from the control bits. */
+        uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
+        uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+
+        if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
+        {
+            /* Just looking for single bit being set. */
+            if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
+            {
+                xMatchFound = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
+        {
+            /* All bits are set. */
+            xMatchFound = pdTRUE;
+        }
+        else
+        {
+            /* Need all bits to be set, but not all the bits were set. */
+        }
+
+        if( xMatchFound != pdFALSE )
+        {
+            /* The bits match.  Should the bits be cleared on exit? */
+            if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+            {
+                uxBitsToClear |= uxBitsWaitedFor;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* Store the actual event flag value in the task's event list
+             * item before removing the task from the event list.  The
+             * eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
+             * that is was unblocked due to its required bits matching, rather
+             * than because it timed out. */
+            #if ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 )
+            {
+                if( pxHigherPriorityTaskWoken != NULL )
+                {
+                    if( eventREMOVE_FROM_UNORDERED_EVENT_LIST_FROM_ISR( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET ) != pdFALSE )
+                    {
+                        *pxHigherPriorityTaskWoken = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    eventREMOVE_FROM_UNORDERED_EVENT_LIST( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
+                }
+            }
+            #else /* if ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 ) */
+            {
+                ( void ) pxHigherPriorityTaskWoken;
+                eventREMOVE_FROM_UNORDERED_EVENT_LIST( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
+            }
+            #endif /* if ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 ) */
+        }
+        else
+        {
+            #if ( configEVENT_GROUP_WAITER_LISTS > 0 )
+            {
+                List_t * pxNewWaitingList;
+
+                /* The bit the task was indexed by has been set but the task is
+                 * still waiting for other bits, so index it by one of the bits
+                 * that is still clear. */
+                pxNewWaitingList = prvGetWaitingList( pxEventBits, uxBitsWaitedFor | uxControlBits );
+
+                if( pxNewWaitingList != pxWaitingList )
+                {
+                    listREMOVE_ITEM( pxListItem );
+                    listINSERT_END( pxNewWaitingList, pxListItem );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configEVENT_GROUP_WAITER_LISTS */
+        }
+
+        /* Move onto the next list item.  Note pxListItem->pxNext is not
+         * used here as the list item may have been removed from the event list
+         * and inserted into the ready/pending reading list. */
+        pxListItem = pxNext;
+    }
+
+    return uxBitsToClear;
+}
+/*-----------------------------------------------------------*/
+
+static EventBits_t prvUnblockWaitingTasks( EventGroup_t * pxEventBits,
+                                           const EventBits_t uxBitsSet,
+                                           BaseType_t * pxHigherPriorityTaskWoken )
+{
+    EventBits_t uxBitsToClear;
+
+    /* Tasks that are waiting for any one of several bits are always tested. */
+    uxBitsToClear = prvTestWaitingTasks( pxEventBits, &( pxEventBits->xTasksWaitingForBits ), pxHigherPriorityTaskWoken );
+
+    #if ( configEVENT_GROUP_WAITER_LISTS > 0 )
+    {
+        EventBits_t uxListsToTest;
+        UBaseType_t uxList = 0;
+
+        /* Other tasks only need testing if a bit they are indexed by was
+         * set. */
+        uxListsToTest = prvGetListsToTest( uxBitsSet );
+
+        while( uxListsToTest != ( EventBits_t ) 0 )
+        {
+            if( ( uxListsToTest & ( EventBits_t ) 1 ) != ( EventBits_t ) 0 )
+            {
+                uxBitsToClear |= prvTestWaitingTasks( pxEventBits, &( pxEventBits->xTasksWaitingForBit[ uxList ] ), pxHigherPriorityTaskWoken );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            uxListsToTest >>= 1;
+            uxList++;
+        }
+    }
+    #else /* if ( configEVENT_GROUP_WAITER_LISTS > 0 ) */
+    {
+        ( void ) uxBitsSet;
+    }
+    #endif /* if ( configEVENT_GROUP_WAITER_LISTS > 0 ) */
+
+    return uxBitsToClear;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configEVENT_GROUP_WAITER_LISTS > 0 )
+
+    static EventBits_t prvGetListsToTest( const EventBits_t uxBitsSet )
+    {
+        EventBits_t uxBitsRemaining = uxBitsSet, uxListsToTest = 0;
+        UBaseType_t uxBit = 0;
+
+        /* Bit n is indexed by list n modulo configEVENT_GROUP_WAITER_LISTS. */
+        while( uxBitsRemaining != ( EventBits_t ) 0 )
+        {
+            if( ( uxBitsRemaining & ( EventBits_t ) 1 ) != ( EventBits_t ) 0 )
+            {
+                uxListsToTest |= ( EventBits_t ) 1 << ( uxBit % ( UBaseType_t ) configEVENT_GROUP_WAITER_LISTS );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            uxBitsRemaining >>= 1;
+            uxBit++;
+        }
+
+        return uxListsToTest;
+    }
+
+#endif /* configEVENT_GROUP_WAITER_LISTS */
+/*-----------------------------------------------------------*/
+
+#if ( configEVENT_GROUP_WAITER_LISTS > 0 )
+
+    static List_t * prvGetWaitingList( EventGroup_t * pxEventBits,
+                                       const EventBits_t uxItemValue )
+    {
+        List_t * pxList = &( pxEventBits->xTasksWaitingForBits );
+        EventBits_t uxBitsWaitedFor, uxIndexBits;
+        UBaseType_t uxBit = 0;
+
+        uxBitsWaitedFor = uxItemValue & ~eventEVENT_BITS_CONTROL_BYTES;
+
+        if( ( uxItemValue & eventWAIT_FOR_ALL_BITS ) != ( EventBits_t ) 0 )
+        {
+            /* The wait condition cannot be met until every bit that is still
+             * clear has been set, so the task only needs testing when one of
+             * those bits is set. */
+            uxIndexBits = uxBitsWaitedFor & ~( pxEventBits->uxEventBits );
+        }
+        else if( ( uxBitsWaitedFor & ( uxBitsWaitedFor - ( EventBits_t ) 1 ) ) == ( EventBits_t ) 0 )
+        {
+            /* Waiting for a single bit. */
+            uxIndexBits = uxBitsWaitedFor;
+        }
+        else
+        {
+            /* Waiting for any one of several bits, so the task remains in the
+             * list that is tested whenever bits are set. */
+            uxIndexBits = 0;
+        }
+
+        if( uxIndexBits != ( EventBits_t ) 0 )
+        {
+            /* Index the task by the lowest bit found above. */
+            while( ( uxIndexBits & ( EventBits_t ) 1 ) == ( EventBits_t ) 0 )
+            {
+                uxIndexBits >>= 1;
+                uxBit++;
+            }
+
+            pxList = &( pxEventBits->xTasksWaitingForBit[ uxBit % ( UBaseType_t ) configEVENT_GROUP_WAITER_LISTS ] );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pxList;
+    }
+
+#endif /* configEVENT_GROUP_WAITER_LISTS */
+/*-----------------------------------------------------------*/
+
+#if ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 )
+
+    static UBaseType_t prvCountWaitingTasks( EventGroup_t * pxEventBits,
+                                             const EventBits_t uxBitsSet )
+    {
+        UBaseType_t uxCount;
+
+        uxCount = listCURRENT_LIST_LENGTH( &( pxEventBits->xTasksWaitingForBits ) );
+
+        #if ( configEVENT_GROUP_WAITER_LISTS > 0 )
+        {
+            EventBits_t uxListsToTest;
+            UBaseType_t uxList = 0;
+
+            uxListsToTest = prvGetListsToTest( uxBitsSet );
+
+            while( uxListsToTest != ( EventBits_t ) 0 )
+            {
+                if( ( uxListsToTest & ( EventBits_t ) 1 ) != ( EventBits_t ) 0 )
+                {
+                    uxCount += listCURRENT_LIST_LENGTH( &( pxEventBits->xTasksWaitingForBit[ uxList ] ) );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                uxListsToTest >>= 1;
+                uxList++;
+            }
+        }
+        #else /* if ( configEVENT_GROUP_WAITER_LISTS > 0 ) */
+        {
+            ( void ) uxBitsSet;
+        }
+        #endif /* if ( configEVENT_GROUP_WAITER_LISTS > 0 ) */
+
+        return uxCount;
+    }
+
+#endif /* configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS */
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseNewEventGroup( EventGroup_t * pxEventBits )
+{
+    pxEventBits->uxEventBits = 0;
+    vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+
+    #if ( configEVENT_GROUP_WAITER_LISTS > 0 )
+    {
+        UBaseType_t uxList;
+
+        for( uxList = 0; uxList < ( UBaseType_t ) configEVENT_GROUP_WAITER_LISTS; uxList++ )
+        {
+            vListInitialise( &( pxEventBits->xTasksWaitingForBit[ uxList ] ) );
+        }
+    }
+    #endif
+
+    #if ( eventACCUMULATE_BITS_FROM_ISR )
+    {
+        pxEventBits->uxBitsToSetFromISR = 0;
+        pxEventBits->uxBitsToClearFromISR = 0;
+    }
+    #endif
+
+    #if ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 )
+    {
+        pxEventBits->uxLockCount = 0;
+    }
+    #endif
+}
 /*-----------------------------------------------------------*/
 
 #if ( configUSE_TRACE_FACILITY == 1 )
@@ -904,6 +904,102 @@
     #define configSUPPORT_DYNAMIC_ALLOCATION    1
 #endif
 
+#ifndef configUSE_SLAB_CACHES
+
+/* Set to 1 to allocate the control blocks of dynamically created tasks,
+ * semaphores, mutexes, software timers and event groups from slab caches, one
+ * for each type of control block, rather than directly from the heap.  See
+ * slab.h. */
+    #define configUSE_SLAB_CACHES    0
+#endif
+
+#ifndef configSLAB_CACHE_OBJECTS_PER_SLAB
+
+/* The number of control blocks held in each slab allocated by a slab cache. */
+    #define configSLAB_CACHE_OBJECTS_PER_SLAB    4
+#endif
+
+#if ( configUSE_SLAB_CACHES == 1 )
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION != 1 )
+        #error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 to use slab caches.
+    #endif
+
+    #if ( configSLAB_CACHE_OBJECTS_PER_SLAB < 1 )
+        #error configSLAB_CACHE_OBJECTS_PER_SLAB must be at least 1.
+    #endif
+#endif
+
+#ifndef configUSE_ARENAS
+
+/* Set to 1 to include the arena allocator, from which tasks, queues, software
+ * timers, stream buffers and message buffers can be created and then all freed
+ * at once by resetting the arena.  See arena.h. */
+    #define configUSE_ARENAS    0
+#endif
+
+#if ( configUSE_ARENAS == 1 )
+    #if ( configSUPPORT_STATIC_ALLOCATION != 1 )
+        #error configSUPPORT_STATIC_ALLOCATION must be set to 1 to use arenas.
+    #endif
+#endif
+
+#ifndef configHEAP_USE_CRITICAL_SECTIONS
+
+/* Set to 1 for heap_2.c, heap_4.c and heap_5.c to protect the heap with short
+ * critical sections rather than by suspending the scheduler.  A search of the
+ * free list leaves and re-enters its critical section after every
+ * configHEAP_CRITICAL_SECTION_BLOCKS blocks, so an allocation or free made by a
+ * low priority task only delays interrupts and higher priority tasks for that
+ * many steps at a time.  A search starts again if the free list changed while
+ * its critical section was left. */
+    #define configHEAP_USE_CRITICAL_SECTIONS    0
+#endif
+
+#ifndef configHEAP_CRITICAL_SECTION_BLOCKS
+
+/* The number of blocks a search of the heap steps over in each critical section
+ * when configHEAP_USE_CRITICAL_SECTIONS is 1. */
+    #define configHEAP_CRITICAL_SECTION_BLOCKS    8
+#endif
+
+#if ( configHEAP_CRITICAL_SECTION_BLOCKS < 1 )
+    #error configHEAP_CRITICAL_SECTION_BLOCKS must be at least 1.
+#endif
+
+#if ( configHEAP_USE_WATERMARKS == 1 )
+    #if ( ( configUSE_TIMERS != 1 ) || ( INCLUDE_xTimerPendFunctionCall != 1 ) )
+        #error configUSE_TIMERS and INCLUDE_xTimerPendFunctionCall must be set to 1 to use configHEAP_USE_WATERMARKS as the watermark callback runs in the timer service task.
+    #endif
+#endif
+
+#if ( configHEAP_USE_SHRINKERS == 1 )
+    #if ( ( INCLUDE_vTaskDelay != 1 ) || ( ( INCLUDE_xTaskGetSchedulerState != 1 ) && ( configUSE_TIMERS != 1 ) ) || ( ( INCLUDE_xTaskGetCurrentTaskHandle != 1 ) && ( configUSE_MUTEXES != 1 ) ) )
+        #error INCLUDE_vTaskDelay, INCLUDE_xTaskGetSchedulerState and INCLUDE_xTaskGetCurrentTaskHandle must be set to 1 to use configHEAP_USE_SHRINKERS as an allocation that fails while another task is running the shrinkers waits for that task to finish.
+    #endif
+#endif
+
+#ifndef configQUEUE_STORAGE_ALIGNMENT
+
+/* The alignment, in bytes, of the storage area of a queue that is created
+ * using dynamically allocated memory, or 0 to just follow the queue structure.
+ * Must be a power of two. */
+    #define configQUEUE_STORAGE_ALIGNMENT    0
+#endif
+
+#if ( configQUEUE_STORAGE_ALIGNMENT > 0 )
+    #if ( configUSE_ALIGNED_HEAP_ALLOCATION != 1 )
+        #error configUSE_ALIGNED_HEAP_ALLOCATION must be set to 1 to use configQUEUE_STORAGE_ALIGNMENT.
+    #endif
+
+    #if ( ( configQUEUE_STORAGE_ALIGNMENT & ( configQUEUE_STORAGE_ALIGNMENT - 1 ) ) != 0 )
+        #error configQUEUE_STORAGE_ALIGNMENT must be a power of two.
+    #endif
+
+    #if ( configHEAP_QUEUE_STORAGE_REGION >= 0 )
+        #error configQUEUE_STORAGE_ALIGNMENT cannot be used with configHEAP_QUEUE_STORAGE_REGION.
+    #endif
+#endif
+
 #ifndef configSTACK_DEPTH_TYPE
 
 /* Defaults to uint16_t for backward compatibility, but can be overridden
@@ -927,6 +1023,217 @@
     #define configMESSAGE_BUFFER_LENGTH_TYPE    size_t
 #endif
 
+#ifndef configSTREAM_BUFFER_STORAGE_ALIGNMENT
+
+/* The alignment, in bytes, of the storage area of a power of two ring stream
+ * buffer that is created using dynamically allocated memory.  Defaults to a
+ * common cache line size, but can be overridden in FreeRTOSConfig.h.  Must be a
+ * power of two. */
+    #define configSTREAM_BUFFER_STORAGE_ALIGNMENT    32
+#endif
+
+#if ( ( configSTREAM_BUFFER_STORAGE_ALIGNMENT & ( configSTREAM_BUFFER_STORAGE_ALIGNMENT - 1 ) ) != 0 )
+    #error configSTREAM_BUFFER_STORAGE_ALIGNMENT must be a power of two.
+#endif
+
+#ifndef configUSE_SHARED_STREAM_BUFFERS
+    #define configUSE_SHARED_STREAM_BUFFERS    0
+#endif
+
+#if ( configUSE_SHARED_STREAM_BUFFERS == 1 )
+    #if !defined( portSTREAM_BUFFER_SHARED_SEND_COMPLETED ) || !defined( portSTREAM_BUFFER_SHARED_RECEIVE_COMPLETED )
+        #error configUSE_SHARED_STREAM_BUFFERS is 1 but the port does not define portSTREAM_BUFFER_SHARED_SEND_COMPLETED() and portSTREAM_BUFFER_SHARED_RECEIVE_COMPLETED().  They can also be defined in FreeRTOSConfig.h.  See the description of xStreamBufferCreateShared() in stream_buffer.h.
+    #endif
+#endif
+
+#ifndef configUSE_64_BIT_EVENT_GROUPS
+
+/* Set to 1 to make EventBits_t a 64-bit type, independent of the width of
+ * TickType_t, giving 56 usable bits per event group. */
+    #define configUSE_64_BIT_EVENT_GROUPS    0
+#endif
+
+#ifndef configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS
+
+/* Set to the maximum number of waiting tasks that xEventGroupSetBitsFromISR()
+ * may examine, and therefore unblock, from within the interrupt itself.  Bits
+ * set in an event group that has more waiting tasks than this are applied by
+ * the timer task, and bits set in an event group that a task is accessing are
+ * applied by that task.  Set to 0 to always apply bits set from interrupts in
+ * the timer task. */
+    #define configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS    0
+#endif
+
+#ifndef configEVENT_GROUP_WAITER_LISTS
+
+/* Set to the number of lists, in addition to the list of tasks waiting for any
+ * one of several bits, used to index the tasks blocked on an event group by the
+ * bit they are waiting for.  Bit n is indexed by list n modulo
+ * configEVENT_GROUP_WAITER_LISTS, and setting a bit only tests the tasks in the
+ * lists that index it.  Set to 0 to hold all waiting tasks in a single list. */
+    #define configEVENT_GROUP_WAITER_LISTS    0
+#endif
+
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+    #if ( configEVENT_GROUP_WAITER_LISTS > 56 )
+        #error configEVENT_GROUP_WAITER_LISTS cannot exceed the 56 usable bits in an event group.
+    #endif
+#elif ( configUSE_16_BIT_TICKS == 1 )
+    #if ( configEVENT_GROUP_WAITER_LISTS > 8 )
+        #error configEVENT_GROUP_WAITER_LISTS cannot exceed the 8 usable bits in an event group.
+    #endif
+#else
+    #if ( configEVENT_GROUP_WAITER_LISTS > 24 )
+        #error configEVENT_GROUP_WAITER_LISTS cannot exceed the 24 usable bits in an event group.
+    #endif
+#endif
+
+#ifndef configTIMER_WHEEL_SLOTS
+
+/* Set to the number of slots in a hashed timing wheel to hold active software
+ * timers in the timing wheel rather than in a list sorted by expiry time.  That
+ * makes starting, resetting and stopping a timer O(1) in the timer service
+ * task, rather than O(n) in the number of active timers.  Must be a power of
+ * two.  Set to 0 to use sorted lists. */
+    #define configTIMER_WHEEL_SLOTS    0
+#endif
+
+#if ( ( configTIMER_WHEEL_SLOTS & ( configTIMER_WHEEL_SLOTS - 1 ) ) != 0 )
+    #error configTIMER_WHEEL_SLOTS must be 0 or a power of two.
+#endif
+
+#ifndef configUSE_TIMER_DIRECT_COMMANDS
+
+/* Set to 1 to allow xTimerStart(), xTimerReset(), xTimerStop() and
+ * xTimerChangePeriod() to update the active timers directly from the calling
+ * task, rather than by sending a command to the timer service task, when the
+ * timer service task is blocked.  Commands sent from interrupts always use the
+ * timer command queue. */
+    #define configUSE_TIMER_DIRECT_COMMANDS    0
+#endif
+
+#ifndef configUSE_TIMER_COMMAND_COALESCING
+
+/* Set to 1 to hold the most recent command sent to each software timer in the
+ * timer itself, rather than sending every command through the timer command
+ * queue.  Commands sent to a timer before the timer service task has processed
+ * the previous one then replace it, so the work done by the timer service task
+ * depends on the number of timers rather than on the rate at which commands
+ * are sent. */
+    #define configUSE_TIMER_COMMAND_COALESCING    0
+#endif
+
+#ifndef configTIMER_SERVICE_TASKS
+
+/* Set to the number of timer service tasks.  Each timer is serviced by the
+ * timer service task selected by vTimerSetServiceTask(), or by timer service
+ * task 0 if vTimerSetServiceTask() is not called, and each timer service task
+ * has its own priority, stack and timer command queue.  Pended function calls
+ * are executed by timer service task 0. */
+    #define configTIMER_SERVICE_TASKS    1
+#endif
+
+#if ( configTIMER_SERVICE_TASKS < 1 )
+    #error configTIMER_SERVICE_TASKS must be at least 1.
+#endif
+
+#ifndef configTIMER_SERVICE_TASK_PRIORITY
+
+/* The priority of the timer service task with index uxServiceTask.  Timer
+ * service task 0 always uses configTIMER_TASK_PRIORITY. */
+    #define configTIMER_SERVICE_TASK_PRIORITY( uxServiceTask )    configTIMER_TASK_PRIORITY
+#endif
+
+#ifndef configTIMER_SERVICE_TASK_STACK_DEPTH
+
+/* The stack depth of the timer service task with index uxServiceTask when it is
+ * created dynamically.  Timer service task 0 always uses
+ * configTIMER_TASK_STACK_DEPTH. */
+    #define configTIMER_SERVICE_TASK_STACK_DEPTH( uxServiceTask )    configTIMER_TASK_STACK_DEPTH
+#endif
+
+#ifndef configTIMER_PEND_FUNCTION_RING_LENGTH
+
+/* Set to the number of function calls that can be held in the ring of pended
+ * function calls of each timer service task.  xTimerPendFunctionCall() and
+ * xTimerPendFunctionCallFromISR() add the function and its parameters to the
+ * ring rather than sending a message on the timer command queue, unless the
+ * ring is full.  Must be a power of two.  Set to 0 to always use the timer
+ * command queue. */
+    #define configTIMER_PEND_FUNCTION_RING_LENGTH    0
+#endif
+
+#if ( ( configTIMER_PEND_FUNCTION_RING_LENGTH & ( configTIMER_PEND_FUNCTION_RING_LENGTH - 1 ) ) != 0 )
+    #error configTIMER_PEND_FUNCTION_RING_LENGTH must be 0 or a power of two.
+#endif
+
+#ifndef configUSE_TIMER_SLACK
+
+/* Set to 1 to allow vTimerSetSlack() to give a software timer a slack time.
+ * The callback of a timer with slack can be called up to the slack time after
+ * the timer expires, so the timer service task can process the expiry of
+ * several timers each time it unblocks, rather than unblocking for each timer
+ * in turn.  Blocking for longer also allows longer tickless idle periods. */
+    #define configUSE_TIMER_SLACK    0
+#endif
+
+#ifndef configUSE_HARD_TIMERS
+
+/* Set to 1 to allow vTimerSetHardTimer() to make a software timer a hard timer.
+ * The callback function of a hard timer is called from the tick interrupt,
+ * rather than by a timer service task, so it must be short and must only use
+ * interrupt safe API functions.  Set to 2 to instead process hard timers each
+ * time the application calls vTimerProcessHardTimersFromISR(), normally from a
+ * dedicated hardware timer interrupt, in which case hard timer periods are
+ * counted in calls to vTimerProcessHardTimersFromISR() rather than in ticks. */
+    #define configUSE_HARD_TIMERS    0
+#endif
+
+#ifndef configHARD_TIMER_WHEEL_SLOTS
+
+/* The number of slots in the timing wheel that holds active hard timers.  Must
+ * be a power of two. */
+    #define configHARD_TIMER_WHEEL_SLOTS    16
+#endif
+
+#if ( configUSE_HARD_TIMERS != 0 )
+    #if ( configUSE_TIMERS != 1 )
+        #error configUSE_TIMERS must be set to 1 to use hard timers.
+    #endif
+
+    #if ( ( configUSE_HARD_TIMERS == 1 ) && ( configUSE_TICKLESS_IDLE != 0 ) )
+        #error Hard timers processed from the tick interrupt cannot be used when the tick interrupt is suppressed.  Set configUSE_HARD_TIMERS to 2 instead.
+    #endif
+
+    #if ( ( configHARD_TIMER_WHEEL_SLOTS < 1 ) || ( ( configHARD_TIMER_WHEEL_SLOTS & ( configHARD_TIMER_WHEEL_SLOTS - 1 ) ) != 0 ) )
+        #error configHARD_TIMER_WHEEL_SLOTS must be a power of two.
+    #endif
+#endif
+
+#ifndef configUSE_HIGH_RESOLUTION_TIMERS
+
+/* Set to 1 to include the high resolution timer API - see
+ * vTimerInitialiseHighResolution() and vTimerDelayHighResolution() in timers.h.
+ * High resolution timers measure time in nanoseconds using a one-shot compare
+ * interrupt provided by the port, so can expire between ticks without the tick
+ * rate being raised. */
+    #define configUSE_HIGH_RESOLUTION_TIMERS    0
+#endif
+
+#if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+    #if ( configUSE_TIMERS != 1 )
+        #error configUSE_TIMERS must be set to 1 to use high resolution timers.
+    #endif
+
+    #if ( configUSE_TASK_NOTIFICATIONS != 1 )
+        #error configUSE_TASK_NOTIFICATIONS must be set to 1 to use high resolution timers.
+    #endif
+
+    #if !defined( portGET_HIGH_RESOLUTION_TIME_NS ) || !defined( portSET_HIGH_RESOLUTION_COMPARE )
+        #error configUSE_HIGH_RESOLUTION_TIMERS is 1 but the port does not define portGET_HIGH_RESOLUTION_TIME_NS() and portSET_HIGH_RESOLUTION_COMPARE().  portGET_HIGH_RESOLUTION_TIME_NS() must return a 64-bit monotonic time in nanoseconds.  portSET_HIGH_RESOLUTION_COMPARE( ullTimeNs ) must arrange for xTimerProcessHighResolutionTimersFromISR() to be called from an interrupt once that time is reached, or immediately if it has already passed, replacing any earlier compare time.
+    #endif
+#endif
+
 /* Sanity check the configuration. */
 #if ( ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 0 ) )
     #error configSUPPORT_STATIC_ALLOCATION and configSUPPORT_DYNAMIC_ALLOCATION cannot both be 0, but can both be 1.
@@ -1228,6 +1535,12 @@ typedef struct xSTATIC_TCB
     #if ( configUSE_POSIX_ERRNO == 1 )
         int iDummy22;
     #endif
+    #if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+        uint64_t ullDummy23;
+    #endif
+    #if ( configHEAP_TRACK_TASK_ALLOCATIONS == 1 )
+        size_t xDummy24;
+    #endif
 } StaticTask_t;
 
 /*
@@ -1289,7 +1602,11 @@ typedef StaticQueue_t StaticSemaphore_t;
  */
 typedef struct xSTATIC_EVENT_GROUP
 {
-    TickType_t xDummy1;
+    #if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+        uint64_t ullDummy1;
+    #else
+        TickType_t xDummy1;
+    #endif
     StaticList_t xDummy2;
 
     #if ( configUSE_TRACE_FACILITY == 1 )
@@ -1299,6 +1616,20 @@ typedef struct xSTATIC_EVENT_GROUP
     #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
         uint8_t ucDummy4;
     #endif
+
+    #if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+        uint64_t ullDummy5[ 2 ];
+    #elif ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 )
+        TickType_t xDummy5[ 2 ];
+    #endif
+
+    #if ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 )
+        UBaseType_t uxDummy6;
+    #endif
+
+    #if ( configEVENT_GROUP_WAITER_LISTS > 0 )
+        StaticList_t xDummy7[ configEVENT_GROUP_WAITER_LISTS ];
+    #endif
 } StaticEventGroup_t;
 
 /*
@@ -1326,6 +1657,17 @@ typedef struct xSTATIC_TIMER
         UBaseType_t uxDummy7;
     #endif
     uint8_t ucDummy8;
+    #if ( configUSE_TIMER_COMMAND_COALESCING == 1 )
+        BaseType_t xDummy9;
+        TickType_t xDummy10[ 2 ];
+        void * pvDummy11;
+    #endif
+    #if ( configTIMER_SERVICE_TASKS > 1 )
+        void * pvDummy12;
+    #endif
+    #if ( configUSE_TIMER_SLACK == 1 )
+        TickType_t xDummy13;
+    #endif
 } StaticTimer_t;
 
 /*
@@ -1344,7 +1686,7 @@ typedef struct xSTATIC_TIMER
  */
 typedef struct xSTATIC_STREAM_BUFFER
 {
-    size_t uxDummy1[ 4 ];
+    size_t uxDummy1[ 5 ];
     void * pvDummy2[ 3 ];
     uint8_t ucDummy3;
     #if ( configUSE_TRACE_FACILITY == 1 )
@@ -1355,6 +1697,23 @@ typedef struct xSTATIC_STREAM_BUFFER
 /* Message buffers are built on stream buffers. */
 typedef StaticStreamBuffer_t StaticMessageBuffer_t;
 
+/*
+ * In line with software engineering best practice, FreeRTOS implements a strict
+ * data hiding policy, so the real arena structure is not accessible to
+ * application code.  However, if the application writer wants to statically
+ * allocate the memory required to create an arena then the size of the arena
+ * object needs to be known.  The StaticArena_t structure below is provided for
+ * this purpose.  Its size and alignment requirements are guaranteed to match
+ * those of the genuine structure, no matter which architecture is being used,
+ * and no matter how the values in FreeRTOSConfig.h are set.
+ */
+typedef struct xSTATIC_ARENA
+{
+    void * pvDummy1;
+    size_t uxDummy2[ 3 ];
+    uint8_t ucDummy3;
+} StaticArena_t;
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     }
@@ -0,0 +1,269 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include arena.h"
+#endif
+
+#include "task.h"
+#include "queue.h"
+#include "timers.h"
+#include "stream_buffer.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * When configUSE_ARENAS is set to 1 in FreeRTOSConfig.h an application can
+ * create arenas.  An arena is a single region of memory from which memory is
+ * allocated by advancing a pointer, so allocating takes constant time and the
+ * memory allocated is contiguous.  Memory is not returned to an arena
+ * individually.  Instead vArenaReset() returns all the memory allocated from
+ * the arena at once, also in constant time.
+ *
+ * Tasks, queues, software timers, stream buffers and message buffers can be
+ * created in an arena by the xArenaCreate...() functions below, which
+ * allocate the memory for the object from the arena then create the object
+ * using the matching static creation function.  The objects are deleted with
+ * the normal delete functions, which do not free their memory.  Once every
+ * object created in an arena has been deleted, and the kernel no longer
+ * references any of them (a task that deletes itself is only cleaned up by
+ * the idle task), the arena can be reset and reused, for example by the next
+ * phase of the application, which then starts with the same memory layout.
+ *
+ * An arena that is reset while objects created in it still exist will hand
+ * out their memory again - the kernel cannot detect this.
+ */
+
+/**
+ * Type by which arenas are referenced.  For example, a call to xArenaCreate()
+ * returns an ArenaHandle_t variable that can then be used as a parameter to
+ * pvArenaAllocate(), vArenaReset(), etc.
+ */
+struct ArenaDefinition;
+typedef struct ArenaDefinition * ArenaHandle_t;
+
+/**
+ * ArenaHandle_t xArenaCreate( size_t xSizeInBytes );
+ *
+ * Creates an arena of xSizeInBytes bytes, allocating both the arena structure
+ * and the arena's memory from the heap in a single allocation.
+ *
+ * @param xSizeInBytes The number of bytes that can be allocated from the
+ * arena.
+ *
+ * @return The handle of the arena, or NULL if the heap does not have enough
+ * space.
+ */
+#if ( ( configUSE_ARENAS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+    ArenaHandle_t xArenaCreate( size_t xSizeInBytes ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * ArenaHandle_t xArenaCreateStatic( size_t xSizeInBytes,
+ *                                   uint8_t * pucArenaStorage,
+ *                                   StaticArena_t * pxStaticArena );
+ *
+ * Creates an arena using memory provided by the application.
+ *
+ * @param xSizeInBytes The size, in bytes, of the array pointed to by
+ * pucArenaStorage.  Bytes at the start of the array are lost if the array is
+ * not aligned to portBYTE_ALIGNMENT.
+ *
+ * @param pucArenaStorage The memory from which the arena allocates.
+ *
+ * @param pxStaticArena A variable of type StaticArena_t, which is used to hold
+ * the arena's data structure.
+ *
+ * @return The handle of the arena, or NULL if pucArenaStorage or
+ * pxStaticArena is NULL.
+ */
+#if ( configUSE_ARENAS == 1 )
+    ArenaHandle_t xArenaCreateStatic( size_t xSizeInBytes,
+                                      uint8_t * pucArenaStorage,
+                                      StaticArena_t * pxStaticArena ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * void vArenaDelete( ArenaHandle_t xArena );
+ *
+ * Deletes an arena, returning its memory to the heap if it was created by
+ * xArenaCreate().  Every object created in the arena must already have been
+ * deleted.
+ */
+#if ( configUSE_ARENAS == 1 )
+    void vArenaDelete( ArenaHandle_t xArena ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * void * pvArenaAllocate( ArenaHandle_t xArena, size_t xSize );
+ *
+ * Allocates xSize bytes, aligned to portBYTE_ALIGNMENT, from an arena in
+ * constant time.  Can be used to allocate buffers that are used together with
+ * the objects created in the arena.
+ *
+ * @return A pointer to the memory, or NULL if the arena does not have enough
+ * space.
+ */
+#if ( configUSE_ARENAS == 1 )
+    void * pvArenaAllocate( ArenaHandle_t xArena,
+                            size_t xSize ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * void vArenaReset( ArenaHandle_t xArena );
+ *
+ * Returns all the memory allocated from an arena to the arena in constant
+ * time.  Every object created in the arena must already have been deleted.
+ * xTimerDelete() only sends the delete command to the timer service task, so a
+ * timer created in the arena is not deleted until the timer service task has
+ * processed that command, which it does at its own priority.  The arena must
+ * not be reset before then.
+ */
+#if ( configUSE_ARENAS == 1 )
+    void vArenaReset( ArenaHandle_t xArena ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * size_t xArenaGetFreeSize( ArenaHandle_t xArena );
+ * size_t xArenaGetMinimumEverFreeSize( ArenaHandle_t xArena );
+ *
+ * Return the number of bytes that can still be allocated from an arena, and
+ * the smallest number there has been since the arena was created, which shows
+ * how much of the arena the most demanding phase of the application used.
+ */
+#if ( configUSE_ARENAS == 1 )
+    size_t xArenaGetFreeSize( ArenaHandle_t xArena ) PRIVILEGED_FUNCTION;
+    size_t xArenaGetMinimumEverFreeSize( ArenaHandle_t xArena ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * TaskHandle_t xArenaCreateTask( ArenaHandle_t xArena,
+ *                                TaskFunction_t pxTaskCode,
+ *                                const char * const pcName,
+ *                                const uint32_t ulStackDepth,
+ *                                void * const pvParameters,
+ *                                UBaseType_t uxPriority );
+ *
+ * QueueHandle_t xArenaCreateQueue( ArenaHandle_t xArena,
+ *                                  const UBaseType_t uxQueueLength,
+ *                                  const UBaseType_t uxItemSize );
+ *
+ * TimerHandle_t xArenaCreateTimer( ArenaHandle_t xArena,
+ *                                  const char * const pcTimerName,
+ *                                  const TickType_t xTimerPeriodInTicks,
+ *                                  const BaseType_t xAutoReload,
+ *                                  void * const pvTimerID,
+ *                                  TimerCallbackFunction_t pxCallbackFunction );
+ *
+ * StreamBufferHandle_t xArenaCreateStreamBuffer( ArenaHandle_t xArena,
+ *                                                size_t xBufferSizeBytes,
+ *                                                size_t xTriggerLevelBytes );
+ *
+ * MessageBufferHandle_t xArenaCreateMessageBuffer( ArenaHandle_t xArena,
+ *                                                  size_t xBufferSizeBytes );
+ *
+ * Create a task, queue, software timer, stream buffer or message buffer with
+ * the memory it needs allocated from an arena.  The parameters after xArena
+ * are the same as those of xTaskCreate(), xQueueCreate(), xTimerCreate(),
+ * xStreamBufferCreate() and xMessageBufferCreate(), and the buffers can hold
+ * the same number of bytes as those created by xStreamBufferCreate() and
+ * xMessageBufferCreate().  Each returns NULL, and allocates nothing from the
+ * arena, if the arena does not have enough space.
+ *
+ * Example usage:
+ * @verbatim
+ * static uint8_t ucPhaseMemory[ 8192 ];
+ * static StaticArena_t xPhaseArena;
+ *
+ * void vRunPhase( void )
+ * {
+ *  ArenaHandle_t xArena;
+ *  TaskHandle_t xWorker;
+ *  QueueHandle_t xQueue;
+ *
+ *  xArena = xArenaCreateStatic( sizeof( ucPhaseMemory ), ucPhaseMemory, &xPhaseArena );
+ *  xQueue = xArenaCreateQueue( xArena, 10, sizeof( uint32_t ) );
+ *  xWorker = xArenaCreateTask( xArena, vWorker, "Worker", 256, xQueue, 2 );
+ *
+ *  // ... run the phase, then delete everything created in the arena ...
+ *  vTaskDelete( xWorker );
+ *  vQueueDelete( xQueue );
+ *
+ *  // The next phase starts with the whole arena free.
+ *  vArenaReset( xArena );
+ * }
+ * @endverbatim
+ */
+#if ( configUSE_ARENAS == 1 )
+    TaskHandle_t xArenaCreateTask( ArenaHandle_t xArena,
+                                   TaskFunction_t pxTaskCode,
+                                   const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                   const uint32_t ulStackDepth,
+                                   void * const pvParameters,
+                                   UBaseType_t uxPriority ) PRIVILEGED_FUNCTION;
+
+    QueueHandle_t xArenaCreateQueue( ArenaHandle_t xArena,
+                                     const UBaseType_t uxQueueLength,
+                                     const UBaseType_t uxItemSize ) PRIVILEGED_FUNCTION;
+
+    #if ( configUSE_TIMERS == 1 )
+        TimerHandle_t xArenaCreateTimer( ArenaHandle_t xArena,
+                                         const char * const pcTimerName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                         const TickType_t xTimerPeriodInTicks,
+                                         const BaseType_t xAutoReload,
+                                         void * const pvTimerID,
+                                         TimerCallbackFunction_t pxCallbackFunction ) PRIVILEGED_FUNCTION;
+    #endif
+
+    StreamBufferHandle_t xArenaStreamBufferGenericCreate( ArenaHandle_t xArena,
+                                                          size_t xBufferSizeBytes,
+                                                          size_t xTriggerLevelBytes,
+                                                          BaseType_t xStreamBufferType ) PRIVILEGED_FUNCTION;
+
+    #define xArenaCreateStreamBuffer( xArena, xBufferSizeBytes, xTriggerLevelBytes ) \
+    xArenaStreamBufferGenericCreate( ( xArena ), ( xBufferSizeBytes ), ( xTriggerLevelBytes ), sbTYPE_STREAM_BUFFER )
+
+    #define xArenaCreateMessageBuffer( xArena, xBufferSizeBytes ) \
+    ( MessageBufferHandle_t ) xArenaStreamBufferGenericCreate( ( xArena ), ( xBufferSizeBytes ), ( size_t ) 0, sbTYPE_MESSAGE_BUFFER )
+#endif /* configUSE_ARENAS */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* ARENA_H */
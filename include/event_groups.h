@@ -83,14 +83,19 @@ struct EventGroupDef_t;
 typedef struct EventGroupDef_t   * EventGroupHandle_t;
 
 /*
- * The type that holds event bits always matches TickType_t - therefore the
- * number of bits it holds is set by configUSE_16_BIT_TICKS (16 bits if set to 1,
- * 32 bits if set to 0.
+ * The type that holds event bits matches TickType_t unless
+ * configUSE_64_BIT_EVENT_GROUPS is set to 1 - therefore the number of bits it
+ * holds is set by configUSE_16_BIT_TICKS (16 bits if set to 1, 32 bits if set
+ * to 0), or is 64 bits if configUSE_64_BIT_EVENT_GROUPS is set to 1.
  *
  * \defgroup EventBits_t EventBits_t
  * \ingroup EventGroup
  */
-typedef TickType_t               EventBits_t;
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+    typedef uint64_t             EventBits_t;
+#else
+    typedef TickType_t           EventBits_t;
+#endif
 
 /**
  * event_groups.h
@@ -115,7 +120,9 @@ typedef TickType_t               EventBits_t;
  * on the configUSE_16_BIT_TICKS setting in FreeRTOSConfig.h.  If
  * configUSE_16_BIT_TICKS is 1 then each event group contains 8 usable bits (bit
  * 0 to bit 7).  If configUSE_16_BIT_TICKS is set to 0 then each event group has
- * 24 usable bits (bit 0 to bit 23).  The EventBits_t type is used to store
+ * 24 usable bits (bit 0 to bit 23).  If configUSE_64_BIT_EVENT_GROUPS is set
+ * to 1 then each event group has 56 usable bits (bit 0 to bit 55), whatever
+ * the configUSE_16_BIT_TICKS setting.  The EventBits_t type is used to store
  * event bits within an event group.
  *
  * @return If the event group was created then a handle to the event group is
@@ -171,7 +178,9 @@ typedef TickType_t               EventBits_t;
  * on the configUSE_16_BIT_TICKS setting in FreeRTOSConfig.h.  If
  * configUSE_16_BIT_TICKS is 1 then each event group contains 8 usable bits (bit
  * 0 to bit 7).  If configUSE_16_BIT_TICKS is set to 0 then each event group has
- * 24 usable bits (bit 0 to bit 23).  The EventBits_t type is used to store
+ * 24 usable bits (bit 0 to bit 23).  If configUSE_64_BIT_EVENT_GROUPS is set
+ * to 1 then each event group has 56 usable bits (bit 0 to bit 55), whatever
+ * the configUSE_16_BIT_TICKS setting.  The EventBits_t type is used to store
  * event bits within an event group.
  *
  * @param pxEventGroupBuffer pxEventGroupBuffer must point to a variable of type
@@ -418,7 +427,7 @@ EventBits_t xEventGroupClearBits( EventGroupHandle_t xEventGroup,
  * \defgroup xEventGroupClearBitsFromISR xEventGroupClearBitsFromISR
  * \ingroup EventGroup
  */
-#if ( configUSE_TRACE_FACILITY == 1 )
+#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( configUSE_64_BIT_EVENT_GROUPS == 1 ) || ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 ) )
     BaseType_t xEventGroupClearBitsFromISR( EventGroupHandle_t xEventGroup,
                                             const EventBits_t uxBitsToClear ) PRIVILEGED_FUNCTION;
 #else
@@ -439,6 +448,12 @@ EventBits_t xEventGroupClearBits( EventGroupHandle_t xEventGroup,
  * Setting bits in an event group will automatically unblock tasks that are
  * blocked waiting for the bits.
  *
+ * If configEVENT_GROUP_WAITER_LISTS is greater than 0 then blocked tasks are
+ * indexed by a bit they are waiting for, and only tasks indexed by one of the
+ * bits being set, or waiting for any one of several bits, are tested.  Tasks
+ * unblocked by the same call are then unblocked in the order of the lists they
+ * are indexed by rather than strictly in the order in which they blocked.
+ *
  * @param xEventGroup The event group in which the bits are to be set.
  *
  * @param uxBitsToSet A bitwise value that indicates the bit or bits to set.
@@ -517,6 +532,26 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup,
  * context of the timer task - where a scheduler lock is used in place of a
  * critical section.
  *
+ * If configUSE_64_BIT_EVENT_GROUPS is set to 1 then the bits cannot be passed
+ * to the timer task in the 32-bit parameter of a pended function call.
+ * Instead they are accumulated within the event group and applied together,
+ * so all the bits set by one call still become visible at the same time.  Bits
+ * set and cleared from interrupts before the timer task runs are applied in a
+ * single pended function call, with the bits that were set being applied
+ * before the bits that were cleared.  Setting a bit from an interrupt cancels
+ * any earlier clear of the same bit that is still pending.
+ *
+ * If configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS is greater than 0 then the bits
+ * are set, and the tasks waiting for them are unblocked, within
+ * xEventGroupSetBitsFromISR() itself - without involving the timer task -
+ * provided no more than configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS tasks are
+ * waiting on the event group (or, if configEVENT_GROUP_WAITER_LISTS is greater
+ * than 0, would be tested by setting the bits) and no task is accessing the event group at the
+ * time.  If a task is accessing the event group then that task sets the bits
+ * when it has finished.  Otherwise the operation is deferred to the timer task
+ * as described above, in the same way as when configUSE_64_BIT_EVENT_GROUPS is
+ * set to 1.  xEventGroupClearBitsFromISR() behaves in the same way.
+ *
  * @param xEventGroup The event group in which the bits are to be set.
  *
  * @param uxBitsToSet A bitwise value that indicates the bit or bits to set.
@@ -573,7 +608,7 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup,
  * \defgroup xEventGroupSetBitsFromISR xEventGroupSetBitsFromISR
  * \ingroup EventGroup
  */
-#if ( configUSE_TRACE_FACILITY == 1 )
+#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( configUSE_64_BIT_EVENT_GROUPS == 1 ) || ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 ) )
     BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup,
                                           const EventBits_t uxBitsToSet,
                                           BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
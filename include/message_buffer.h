@@ -212,6 +212,52 @@ typedef void * MessageBufferHandle_t;
 #define xMessageBufferCreateStatic( xBufferSizeBytes, pucMessageBufferStorageArea, pxStaticMessageBuffer ) \
     ( MessageBufferHandle_t ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, 0, pdTRUE, pucMessageBufferStorageArea, pxStaticMessageBuffer )
 
+/**
+ * message_buffer.h
+ *
+ * @code{c}
+ * MessageBufferHandle_t xMessageBufferCreateShared( size_t xBufferSizeBytes,
+ *                                                void *pvSharedMemory );
+ * @endcode
+ *
+ * Creates a new message buffer in memory that is shared with a second
+ * FreeRTOS instance.  The other instance obtains its handle to the message
+ * buffer using xMessageBufferOpenShared().  See xStreamBufferCreateShared() in
+ * stream_buffer.h for the requirements on the shared memory and the port.
+ *
+ * configUSE_SHARED_STREAM_BUFFERS must be set to 1 in FreeRTOSConfig.h for
+ * xMessageBufferCreateShared() to be available.
+ *
+ * @param xBufferSizeBytes The size, in bytes, of the storage area.
+ *
+ * @param pvSharedMemory Must point to at least
+ * sbSHARED_MEMORY_SIZE_BYTES( xBufferSizeBytes ) bytes of shared memory.
+ *
+ * @return A handle to the created message buffer, or NULL if pvSharedMemory is
+ * NULL.
+ *
+ * \defgroup xMessageBufferCreateShared xMessageBufferCreateShared
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferCreateShared( xBufferSizeBytes, pvSharedMemory ) \
+    ( MessageBufferHandle_t ) xStreamBufferGenericCreateShared( xBufferSizeBytes, 0, sbTYPE_MESSAGE_BUFFER, pvSharedMemory )
+
+/**
+ * message_buffer.h
+ *
+ * @code{c}
+ * MessageBufferHandle_t xMessageBufferOpenShared( void *pvSharedMemory );
+ * @endcode
+ *
+ * Obtains a handle to a message buffer that another FreeRTOS instance created
+ * using xMessageBufferCreateShared().  See xStreamBufferOpenShared().
+ *
+ * \defgroup xMessageBufferOpenShared xMessageBufferOpenShared
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferOpenShared( pvSharedMemory ) \
+    ( MessageBufferHandle_t ) xStreamBufferOpenShared( pvSharedMemory )
+
 /**
  * message_buffer.h
  *
@@ -155,6 +155,7 @@
         #define xStreamBufferSpacesAvailable           MPU_xStreamBufferSpacesAvailable
         #define xStreamBufferBytesAvailable            MPU_xStreamBufferBytesAvailable
         #define xStreamBufferSetTriggerLevel           MPU_xStreamBufferSetTriggerLevel
+        #define xStreamBufferSetSpaceTriggerLevel      MPU_xStreamBufferSetSpaceTriggerLevel
         #define xStreamBufferGenericCreate             MPU_xStreamBufferGenericCreate
         #define xStreamBufferGenericCreateStatic       MPU_xStreamBufferGenericCreateStatic
 
@@ -150,11 +150,104 @@ typedef struct xHeapStats
     size_t xNumberOfSuccessfulFrees;        /* The number of calls to vPortFree() that has successfully freed a block of memory. */
 } HeapStats_t;
 
+#ifndef configHEAP_HISTOGRAM_BUCKETS
+    /* Set to the number of power of two buckets in which heap_4.c and heap_5.c
+     * count their free blocks, or 0 to not keep a histogram of free blocks. */
+    #define configHEAP_HISTOGRAM_BUCKETS    0
+#endif
+
+#if ( configHEAP_HISTOGRAM_BUCKETS > 32 )
+    #error configHEAP_HISTOGRAM_BUCKETS must not be greater than 32.
+#endif
+
+#if ( configHEAP_HISTOGRAM_BUCKETS > 0 )
+
+/* Used to pass the histogram of free blocks out of vPortGetHeapHistogram().
+ * Bucket n holds the free blocks of at least 2^n bytes and less than 2^(n+1)
+ * bytes, except the last bucket also holds all larger free blocks. */
+    typedef struct xHeapHistogram
+    {
+        size_t xNumberOfFreeBlocks[ configHEAP_HISTOGRAM_BUCKETS ]; /* The number of free blocks in each bucket. */
+        size_t xFreeBytes[ configHEAP_HISTOGRAM_BUCKETS ];          /* The sum of the sizes of the free blocks in each bucket. */
+        size_t xAvailableHeapSpaceInBytes;                          /* The sum of the sizes of all the free blocks. */
+        UBaseType_t uxFragmentationIndex;                           /* The percentage of the free bytes held in blocks outside the bucket of the largest free block.  0 if the free bytes are all in blocks of about the same size as the largest block, approaching 100 as more of them are in much smaller blocks. */
+    } HeapHistogram_t;
+#endif
+
+#ifndef configHEAP_TRACK_TASK_ALLOCATIONS
+    /* Set to 1 for heap_4.c and heap_5.c to record in each allocated block the
+     * task that allocated it, count the bytes each task has allocated and not
+     * freed, and list the allocated blocks with uxPortGetHeapAllocations() to
+     * find leaks.  heap_5.c must also have configHEAP_MAX_REGIONS set.  If
+     * configHEAP_CALL_SITE() is also defined, for example as
+     * __builtin_return_address( 0 ), the value it returns when a block is
+     * allocated is recorded in the block too. */
+    #define configHEAP_TRACK_TASK_ALLOCATIONS    0
+#endif
+
+#if ( configHEAP_TRACK_TASK_ALLOCATIONS == 1 )
+
+/* Used to pass information about the allocated blocks out of
+ * uxPortGetHeapAllocations(). */
+    typedef struct xHeapAllocation
+    {
+        void * pvAddress;                    /* The address of the memory that was returned by the allocation. */
+        size_t xSizeInBytes;                 /* The size of the block, including the structure the heap places at its start. */
+        struct tskTaskControlBlock * xOwner; /* The handle of the task that allocated the block, or NULL if the block was allocated before the scheduler was started or the task has since been deleted. */
+        void * pvCallSite;                   /* The value returned by configHEAP_CALL_SITE() when the block was allocated, or NULL if configHEAP_CALL_SITE() is not defined. */
+    } HeapAllocation_t;
+#endif
+
+#ifndef configHEAP_USE_WATERMARKS
+    /* Set to 1 for heap_4.c and heap_5.c to call the function registered with
+     * vPortSetHeapWatermarks() when the free heap space falls below a low
+     * watermark and when it then rises back above a high watermark. */
+    #define configHEAP_USE_WATERMARKS    0
+#endif
+
+#if ( configHEAP_USE_WATERMARKS == 1 )
+
+/* The watermark that has been crossed, passed to a HeapWatermarkCallback_t
+ * function. */
+    typedef enum
+    {
+        eHeapLowWatermark = 0, /* The free heap space has fallen below the low watermark. */
+        eHeapHighWatermark     /* The free heap space has risen back above the high watermark. */
+    } eHeapWatermark;
+
+    typedef void (* HeapWatermarkCallback_t)( eHeapWatermark eWatermark );
+#endif
+
+#ifndef configHEAP_USE_SHRINKERS
+    /* Set to 1 for heap_4.c and heap_5.c to call the shrinkers registered with
+     * vPortRegisterHeapShrinker() when an allocation fails, and retry the
+     * allocation if they free any memory, before reporting the failure. */
+    #define configHEAP_USE_SHRINKERS    0
+#endif
+
+#if ( configHEAP_USE_SHRINKERS == 1 )
+
+/* A shrinker function frees memory that the application can do without, such
+ * as the unused part of a cache, and returns the number of bytes it freed, or 0
+ * if it had nothing to free.  xBytesWanted is the size of the allocation that
+ * failed, so the shrinker can stop once it has freed about that much. */
+    typedef size_t (* HeapShrinkerFunction_t)( size_t xBytesWanted );
+
+/* Registers a shrinker function.  The structure is provided by the application
+ * so registering a shrinker does not use the heap, and must remain in scope
+ * while the shrinker is registered.  Its contents are private to the heap. */
+    typedef struct xHeapShrinker
+    {
+        HeapShrinkerFunction_t pxShrink;
+        struct xHeapShrinker * pxNext;
+    } HeapShrinker_t;
+#endif
+
 /*
- * Used to define multiple heap regions for use by heap_5.c.  This function
- * must be called before any calls to pvPortMalloc() - not creating a task,
- * queue, semaphore, mutex, software timer, event group, etc. will result in
- * pvPortMalloc being called.
+ * Used to define multiple heap regions for use by heap_5.c and heap_6.c.  This
+ * function must be called before any calls to pvPortMalloc() - not creating a
+ * task, queue, semaphore, mutex, software timer, event group, etc. will result
+ * in pvPortMalloc being called.
  *
  * pxHeapRegions passes in an array of HeapRegion_t structures - each of which
  * defines a region of memory that can be used as the heap.  The array is
@@ -169,6 +262,75 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) PRIVILEG
  */
 void vPortGetHeapStats( HeapStats_t * pxHeapStats );
 
+/*
+ * Returns a HeapHistogram_t structure filled with the histogram of free blocks
+ * kept by heap_4.c and heap_5.c when configHEAP_HISTOGRAM_BUCKETS is greater
+ * than 0.  The histogram is updated as blocks are allocated and freed, so
+ * unlike vPortGetHeapStats() this does not walk the list of free blocks.
+ */
+#if ( configHEAP_HISTOGRAM_BUCKETS > 0 )
+    void vPortGetHeapHistogram( HeapHistogram_t * pxHeapHistogram );
+#endif
+
+/*
+ * Fills the array pxAllocations with information about up to uxArraySize of
+ * the blocks allocated from heap_4.c or heap_5.c, in address order, and returns
+ * the total number of allocated blocks.  Only available when
+ * configHEAP_TRACK_TASK_ALLOCATIONS is 1.  Blocks that are still owned by a
+ * task that should have freed them, or that are owned by no task, point to
+ * memory leaks.  The whole heap is walked with the heap locked, so this is
+ * intended for debugging.
+ *
+ * vPortHeapDisownTask() is called by the kernel when a task is deleted so
+ * freeing the blocks it did not free does not update the deleted task.
+ */
+#if ( configHEAP_TRACK_TASK_ALLOCATIONS == 1 )
+    UBaseType_t uxPortGetHeapAllocations( HeapAllocation_t * const pxAllocations,
+                                          const UBaseType_t uxArraySize ) PRIVILEGED_FUNCTION;
+    void vPortHeapDisownTask( struct tskTaskControlBlock * xTask ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Set the watermarks of heap_4.c or heap_5.c.  When the free heap space falls
+ * below xLowWatermark pxCallback is called with eHeapLowWatermark, and when it
+ * then rises to xHighWatermark or above pxCallback is called with
+ * eHeapHighWatermark, so an application can shrink its caches before
+ * allocations start to fail and grow them again once memory is available.
+ * Setting xHighWatermark above xLowWatermark stops the callback being called
+ * repeatedly as the free heap space moves back and forth across one level.
+ *
+ * pxCallback runs in the timer service task, deferred with
+ * xTimerPendFunctionCall(), so it runs in task context even when the heap was
+ * used from the idle task or with the scheduler suspended.  If the watermarks
+ * are crossed again before the callback runs it is only called for the
+ * watermark crossed most recently.  Passing NULL as pxCallback stops the
+ * callback being called.  Only available when configHEAP_USE_WATERMARKS is 1,
+ * which also requires configUSE_TIMERS and INCLUDE_xTimerPendFunctionCall to
+ * be 1.
+ */
+#if ( configHEAP_USE_WATERMARKS == 1 )
+    void vPortSetHeapWatermarks( size_t xLowWatermark,
+                                 size_t xHighWatermark,
+                                 HeapWatermarkCallback_t pxCallback ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Register a shrinker with heap_4.c or heap_5.c.  When an allocation fails the
+ * registered shrinkers are called in the order they were registered, until
+ * they have freed at least the size of the allocation, and the allocation is
+ * retried for as long as they free memory.  vApplicationMallocFailedHook() is
+ * only called if the allocation still fails.  A shrinker runs in the task that
+ * made the allocation, with the heap unlocked, so can call vPortFree(), but
+ * must not allocate memory.  An allocation that fails in one task while another
+ * task is running the shrinkers waits for that task to finish and is then
+ * retried, unless the scheduler is suspended, in which case it fails.  Only
+ * available when configHEAP_USE_SHRINKERS is 1.
+ */
+#if ( configHEAP_USE_SHRINKERS == 1 )
+    void vPortRegisterHeapShrinker( HeapShrinker_t * const pxShrinker,
+                                    HeapShrinkerFunction_t pxShrinkFunction ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Map to the memory management routines required for the port.
  */
@@ -180,14 +342,102 @@ void vPortInitialiseBlocks( void ) PRIVILEGED_FUNCTION;
 size_t xPortGetFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 size_t xPortGetMinimumEverFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 
+#ifndef configHEAP_MAX_REGIONS
+    /* Set to the maximum number of regions passed to vPortDefineHeapRegions()
+     * to allow heap_5.c to allocate from a given region, or 0 to not record
+     * where the regions are. */
+    #define configHEAP_MAX_REGIONS    0
+#endif
+
+#ifndef configHEAP_TASK_STACK_REGION
+    /* The index of the heap_5.c region from which to allocate task stacks if
+     * it has space, or -1 to allocate task stacks from any region. */
+    #define configHEAP_TASK_STACK_REGION    ( -1 )
+#endif
+
+#ifndef configHEAP_QUEUE_STORAGE_REGION
+    /* The index of the heap_5.c region from which to allocate queues,
+     * together with their storage area, and semaphores if it has space, or -1
+     * to allocate them from any region. */
+    #define configHEAP_QUEUE_STORAGE_REGION    ( -1 )
+#endif
+
+#if ( ( configHEAP_TASK_STACK_REGION >= configHEAP_MAX_REGIONS ) || ( configHEAP_QUEUE_STORAGE_REGION >= configHEAP_MAX_REGIONS ) )
+    #error configHEAP_TASK_STACK_REGION and configHEAP_QUEUE_STORAGE_REGION must be less than configHEAP_MAX_REGIONS.
+#endif
+
+/*
+ * Allocate memory from one heap_5.c region, where xRegion is the index of the
+ * region in the array passed to vPortDefineHeapRegions().
+ * pvPortMallocFromRegion() returns NULL if the region does not have enough
+ * space, whereas pvPortMallocFromPreferredRegion() then allocates from any
+ * region.  The memory is freed with vPortFree().
+ */
+#if ( configHEAP_MAX_REGIONS > 0 )
+    void * pvPortMallocFromRegion( size_t xWantedSize,
+                                   BaseType_t xRegion ) PRIVILEGED_FUNCTION;
+    void * pvPortMallocFromPreferredRegion( size_t xWantedSize,
+                                            BaseType_t xRegion ) PRIVILEGED_FUNCTION;
+#endif
+
 #if ( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
     void * pvPortMallocStack( size_t xSize ) PRIVILEGED_FUNCTION;
     void vPortFreeStack( void * pv ) PRIVILEGED_FUNCTION;
+#elif ( configHEAP_TASK_STACK_REGION >= 0 )
+    #define pvPortMallocStack( xSize )    pvPortMallocFromPreferredRegion( ( xSize ), configHEAP_TASK_STACK_REGION )
+    #define vPortFreeStack                vPortFree
 #else
     #define pvPortMallocStack    pvPortMalloc
     #define vPortFreeStack       vPortFree
 #endif
 
+#ifndef configUSE_ALIGNED_HEAP_ALLOCATION
+    /* Set to 1 if the heap provides pvPortMallocAligned(), as heap_4.c, heap_5.c
+     * and heap_7.c do, to allocate the aligned storage areas of power of two
+     * ring stream buffers and, if configQUEUE_STORAGE_ALIGNMENT is set, queues
+     * with pvPortMallocAligned() rather than over-allocating them with
+     * pvPortMalloc(). */
+    #define configUSE_ALIGNED_HEAP_ALLOCATION    0
+#endif
+
+/*
+ * Allocate memory the start of which is aligned to xAlignment, which must be a
+ * power of two, from heap_4.c, heap_5.c or heap_7.c.  heap_4.c and heap_5.c
+ * carve the block directly from a free block, and return the bytes before the
+ * aligned address to the list of free blocks, so no more memory is used than
+ * the block needs.  heap_7.c blocks are aligned to their own size, so it
+ * allocates a block no smaller than xAlignment.  The memory is freed with
+ * vPortFreeAligned().  The other heaps do not provide these functions, so they
+ * are only declared when configUSE_ALIGNED_HEAP_ALLOCATION is 1.
+ */
+#if ( configUSE_ALIGNED_HEAP_ALLOCATION == 1 )
+    void * pvPortMallocAligned( size_t xWantedSize,
+                                size_t xAlignment ) PRIVILEGED_FUNCTION;
+    void vPortFreeAligned( void * pv ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Change the size of a block allocated from heap_4.c, heap_5.c or heap_7.c to
+ * xWantedSize bytes, keeping its contents up to the smaller of the two sizes.
+ * The block is shrunk in place, and heap_4.c and heap_5.c grow it in place if
+ * the block after it is free and large enough, otherwise its contents are
+ * moved to a new block.
+ * Returns the resized block, or NULL if there is not enough memory, in which
+ * case the original block is left allocated.  As with realloc(), pv may be
+ * NULL to allocate a new block, and xWantedSize may be 0 to free the block.
+ * heap_1.c, heap_2.c, heap_3.c and heap_6.c do not provide this function, so
+ * an application that calls it with one of those heaps fails to link.
+ */
+void * pvPortRealloc( void * pv,
+                      size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/* Used by queue.c to allocate a queue together with its storage area. */
+#if ( configHEAP_QUEUE_STORAGE_REGION >= 0 )
+    #define pvPortMallocQueue( xSize )    pvPortMallocFromPreferredRegion( ( xSize ), configHEAP_QUEUE_STORAGE_REGION )
+#else
+    #define pvPortMallocQueue    pvPortMalloc
+#endif
+
 /*
  * Setup the hardware ready for the scheduler to take control.  This generally
  * sets up a tick interrupt and sets timers for the correct tick frequency.
@@ -0,0 +1,126 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef SLAB_H
+#define SLAB_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include slab.h"
+#endif
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * When configUSE_SLAB_CACHES is set to 1 in FreeRTOSConfig.h the kernel does
+ * not allocate the fixed size control blocks of dynamically created kernel
+ * objects directly from the heap.  Instead each type of control block has its
+ * own slab cache.  A slab is a single heap allocation that holds
+ * configSLAB_CACHE_OBJECTS_PER_SLAB control blocks of the same type, so
+ * creating and deleting objects of different types does not fragment the heap
+ * with small blocks.  Taking a control block from a slab, and returning it,
+ * takes constant time.  The control block of a deleted object is kept in its
+ * slab and reused by the next object of the same type.  A slab is returned to
+ * the heap when all of its control blocks are free, unless it is the only slab
+ * of its cache that has no control blocks in use.
+ *
+ * Queues that have a storage area are still allocated from the heap, as the
+ * size of the storage area varies, so the queue cache only holds the control
+ * blocks of semaphores and mutexes.  Task stacks are also allocated from the
+ * heap.
+ */
+
+/* The slab caches.  Each holds one type of control block. */
+typedef enum
+{
+    eSlabCacheTask = 0,  /* Task control blocks. */
+    eSlabCacheQueue,     /* Control blocks of semaphores and mutexes. */
+    eSlabCacheTimer,     /* Software timers. */
+    eSlabCacheEventGroup /* Event groups. */
+} eSlabCache;
+
+/* Used to pass information about a slab cache out of vSlabGetStats(). */
+typedef struct xSLAB_STATS
+{
+    size_t xObjectSize;                    /* The size, in bytes, of each control block in the cache.  Zero until the first control block is allocated. */
+    UBaseType_t uxObjectsPerSlab;          /* The number of control blocks in each slab (configSLAB_CACHE_OBJECTS_PER_SLAB). */
+    UBaseType_t uxNumberOfSlabs;           /* The number of slabs the cache has allocated from the heap at the time vSlabGetStats() is called. */
+    UBaseType_t uxObjectsInUse;            /* The number of control blocks in use at the time vSlabGetStats() is called. */
+    UBaseType_t uxMaximumObjectsInUse;     /* The maximum number of control blocks there have been in use since the system booted. */
+    size_t xNumberOfSuccessfulAllocations; /* The number of control blocks that have been taken from the cache. */
+    size_t xNumberOfSuccessfulFrees;       /* The number of control blocks that have been returned to the cache. */
+} SlabStats_t;
+
+/**
+ * void vSlabGetStats( eSlabCache eCache, SlabStats_t * pxSlabStats );
+ *
+ * Returns information about the use of a slab cache.
+ *
+ * @param eCache The slab cache being queried.
+ *
+ * @param pxSlabStats The structure into which the information is written.
+ *
+ * Example usage:
+ * @verbatim
+ * SlabStats_t xStats;
+ *
+ * vSlabGetStats( eSlabCacheTask, &xStats );
+ * printf( "%u tasks in %u slabs\n", xStats.uxObjectsInUse, xStats.uxNumberOfSlabs );
+ * @endverbatim
+ */
+#if ( configUSE_SLAB_CACHES == 1 )
+    void vSlabGetStats( eSlabCache eCache,
+                        SlabStats_t * pxSlabStats ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * THE FOLLOWING FUNCTIONS ARE FOR THE KERNEL'S OWN USE WHEN ALLOCATING THE
+ * CONTROL BLOCKS OF KERNEL OBJECTS.  THEY SHOULD NOT BE CALLED FROM
+ * APPLICATION CODE.
+ *
+ * pvSlabAllocate() returns a control block of xObjectSize bytes from the given
+ * cache, or NULL if a new slab is needed and cannot be allocated from the
+ * heap.  Every allocation from a cache must use the same size.  vSlabFree()
+ * returns a control block to the slab it was taken from.
+ */
+#if ( configUSE_SLAB_CACHES == 1 )
+    void * pvSlabAllocate( eSlabCache eCache,
+                           size_t xObjectSize ) PRIVILEGED_FUNCTION;
+    void vSlabFree( void * pv ) PRIVILEGED_FUNCTION;
+#endif
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* SLAB_H */
@@ -71,6 +71,17 @@
 struct StreamBufferDef_t;
 typedef struct StreamBufferDef_t * StreamBufferHandle_t;
 
+/**
+ * Values that can be passed as the xStreamBufferType parameter of
+ * xStreamBufferGenericCreate() and xStreamBufferGenericCreateStatic().
+ * sbTYPE_FLAG_POWER_OF_TWO_RING can be bitwise ORed with either buffer type.
+ * Use the xStreamBufferCreate...() and xMessageBufferCreate...() macros rather
+ * than passing these values directly.
+ */
+#define sbTYPE_STREAM_BUFFER             ( ( BaseType_t ) 0 )
+#define sbTYPE_MESSAGE_BUFFER            ( ( BaseType_t ) 1 )
+#define sbTYPE_FLAG_POWER_OF_TWO_RING    ( ( BaseType_t ) 2 )
+
 
 /**
  * stream_buffer.h
@@ -221,6 +232,177 @@ typedef struct StreamBufferDef_t * StreamBufferHandle_t;
 #define xStreamBufferCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, pucStreamBufferStorageArea, pxStaticStreamBuffer ) \
     xStreamBufferGenericCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, pdFALSE, pucStreamBufferStorageArea, pxStaticStreamBuffer )
 
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * StreamBufferHandle_t xStreamBufferCreatePowerOfTwo( size_t xBufferSizeBytes, size_t xTriggerLevelBytes );
+ * @endcode
+ *
+ * Creates a new stream buffer, the length of which must be a power of two,
+ * using dynamically allocated memory.
+ *
+ * A power of two ring stream buffer is used exactly like a stream buffer
+ * created using xStreamBufferCreate(), but its read and write positions are
+ * free running counters that are masked to index the storage area.  That
+ * removes the wrap arithmetic from calculating the number of bytes and spaces
+ * in the buffer, and allows the whole storage area to be used, so the buffer
+ * can hold xBufferSizeBytes bytes rather than ( xBufferSizeBytes - 1 ).  The
+ * storage area is aligned to configSTREAM_BUFFER_STORAGE_ALIGNMENT bytes, which
+ * defaults to 32 - a common cache line size.
+ *
+ * configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 or left undefined in
+ * FreeRTOSConfig.h for xStreamBufferCreatePowerOfTwo() to be available.
+ *
+ * @param xBufferSizeBytes The total number of bytes the stream buffer will be
+ * able to hold at any one time.  Must be a power of two.
+ *
+ * @param xTriggerLevelBytes The number of bytes that must be in the stream
+ * buffer before a task that is blocked on the stream buffer to wait for data is
+ * moved out of the blocked state.  See xStreamBufferCreate().
+ *
+ * @return If NULL is returned, then the stream buffer cannot be created
+ * because there is insufficient heap memory available for FreeRTOS to allocate
+ * the stream buffer data structures and storage area.  A non-NULL value being
+ * returned indicates that the stream buffer has been created successfully.
+ *
+ * \defgroup xStreamBufferCreatePowerOfTwo xStreamBufferCreatePowerOfTwo
+ * \ingroup StreamBufferManagement
+ */
+#define xStreamBufferCreatePowerOfTwo( xBufferSizeBytes, xTriggerLevelBytes ) \
+    xStreamBufferGenericCreate( xBufferSizeBytes, xTriggerLevelBytes, sbTYPE_STREAM_BUFFER | sbTYPE_FLAG_POWER_OF_TWO_RING )
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * StreamBufferHandle_t xStreamBufferCreatePowerOfTwoStatic( size_t xBufferSizeBytes,
+ *                                                        size_t xTriggerLevelBytes,
+ *                                                        uint8_t *pucStreamBufferStorageArea,
+ *                                                        StaticStreamBuffer_t *pxStaticStreamBuffer );
+ * @endcode
+ *
+ * Creates a new power of two ring stream buffer using statically allocated
+ * memory.  See xStreamBufferCreatePowerOfTwo() for a description of power of
+ * two ring stream buffers.  Unlike xStreamBufferCreateStatic(), the stream
+ * buffer can hold xBufferSizeBytes bytes.  Align pucStreamBufferStorageArea to
+ * a cache line to get the full benefit.
+ *
+ * configSUPPORT_STATIC_ALLOCATION must be set to 1 in FreeRTOSConfig.h for
+ * xStreamBufferCreatePowerOfTwoStatic() to be available.
+ *
+ * @param xBufferSizeBytes The size, in bytes, of the buffer pointed to by the
+ * pucStreamBufferStorageArea parameter.  Must be a power of two.
+ *
+ * @param xTriggerLevelBytes See xStreamBufferCreateStatic().
+ *
+ * @param pucStreamBufferStorageArea Must point to a uint8_t array that is at
+ * least xBufferSizeBytes big.
+ *
+ * @param pxStaticStreamBuffer Must point to a variable of type
+ * StaticStreamBuffer_t, which will be used to hold the stream buffer's data
+ * structure.
+ *
+ * @return If the stream buffer is created successfully then a handle to the
+ * created stream buffer is returned. If either pucStreamBufferStorageArea or
+ * pxStaticstreamBuffer are NULL then NULL is returned.
+ *
+ * \defgroup xStreamBufferCreatePowerOfTwoStatic xStreamBufferCreatePowerOfTwoStatic
+ * \ingroup StreamBufferManagement
+ */
+#define xStreamBufferCreatePowerOfTwoStatic( xBufferSizeBytes, xTriggerLevelBytes, pucStreamBufferStorageArea, pxStaticStreamBuffer ) \
+    xStreamBufferGenericCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, sbTYPE_STREAM_BUFFER | sbTYPE_FLAG_POWER_OF_TWO_RING, pucStreamBufferStorageArea, pxStaticStreamBuffer )
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t sbSHARED_MEMORY_SIZE_BYTES( size_t xBufferSizeBytes );
+ * @endcode
+ *
+ * The number of bytes of shared memory needed to hold a stream buffer created
+ * by xStreamBufferCreateShared() or xMessageBufferCreateShared() that has a
+ * buffer size of xBufferSizeBytes.
+ */
+#define sbSHARED_MEMORY_SIZE_BYTES( xBufferSizeBytes )    ( sizeof( StaticStreamBuffer_t ) + ( size_t ) ( xBufferSizeBytes ) )
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * StreamBufferHandle_t xStreamBufferCreateShared( size_t xBufferSizeBytes,
+ *                                              size_t xTriggerLevelBytes,
+ *                                              void *pvSharedMemory );
+ * @endcode
+ *
+ * Creates a new stream buffer in memory that is shared with a second FreeRTOS
+ * instance - for example another core of an asymmetric multiprocessor, or
+ * another process running the Posix port.  Both the stream buffer's data
+ * structure and its storage area are placed in the shared memory, so data is
+ * written straight into memory the other instance can read.  One instance
+ * creates the stream buffer using xStreamBufferCreateShared(), and the other
+ * obtains its own handle to it using xStreamBufferOpenShared().  One instance
+ * must only write to the stream buffer, and the other must only read from it.
+ *
+ * Task handles cannot be used across FreeRTOS instances, so when data is
+ * written to or read from a shared stream buffer the kernel calls the
+ * portSTREAM_BUFFER_SHARED_SEND_COMPLETED( xStreamBuffer ) or
+ * portSTREAM_BUFFER_SHARED_RECEIVE_COMPLETED( xStreamBuffer ) port hook in
+ * place of sbSEND_COMPLETED() or sbRECEIVE_COMPLETED().  The hook must
+ * interrupt the other instance, which must then call
+ * xStreamBufferSendCompletedFromISR() or xStreamBufferReceiveCompletedFromISR()
+ * with its own handle to the stream buffer.  The hooks are called from both
+ * tasks and interrupts.  The Posix port implements them using a real time
+ * signal - see xPortSharedStreamBufferConnect() in its portmacro.h.
+ *
+ * configUSE_SHARED_STREAM_BUFFERS must be set to 1 in FreeRTOSConfig.h for
+ * xStreamBufferCreateShared() to be available.
+ *
+ * @param xBufferSizeBytes The size, in bytes, of the storage area.  As with
+ * xStreamBufferCreateStatic() the stream buffer can hold one byte less than
+ * this.
+ *
+ * @param xTriggerLevelBytes See xStreamBufferCreate().
+ *
+ * @param pvSharedMemory Must point to at least
+ * sbSHARED_MEMORY_SIZE_BYTES( xBufferSizeBytes ) bytes of shared memory that
+ * are aligned to portBYTE_ALIGNMENT.  The memory is not freed when the stream
+ * buffer is deleted.
+ *
+ * @return A handle to the created stream buffer, or NULL if pvSharedMemory is
+ * NULL.
+ *
+ * \defgroup xStreamBufferCreateShared xStreamBufferCreateShared
+ * \ingroup StreamBufferManagement
+ */
+#define xStreamBufferCreateShared( xBufferSizeBytes, xTriggerLevelBytes, pvSharedMemory ) \
+    xStreamBufferGenericCreateShared( xBufferSizeBytes, xTriggerLevelBytes, sbTYPE_STREAM_BUFFER, pvSharedMemory )
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * StreamBufferHandle_t xStreamBufferOpenShared( void *pvSharedMemory );
+ * @endcode
+ *
+ * Obtains a handle to a stream buffer or message buffer that another FreeRTOS
+ * instance created in shared memory using xStreamBufferCreateShared() or
+ * xMessageBufferCreateShared().  The stream buffer is not modified.
+ *
+ * configUSE_SHARED_STREAM_BUFFERS must be set to 1 in FreeRTOSConfig.h for
+ * xStreamBufferOpenShared() to be available.
+ *
+ * @param pvSharedMemory The address at which this instance maps the shared
+ * memory passed to xStreamBufferCreateShared() by the other instance.
+ *
+ * @return A handle to the stream buffer that is valid in this instance, or NULL
+ * if the memory does not hold a shared stream buffer.
+ *
+ * \defgroup xStreamBufferOpenShared xStreamBufferOpenShared
+ * \ingroup StreamBufferManagement
+ */
+StreamBufferHandle_t xStreamBufferOpenShared( void * const pvSharedMemory ) PRIVILEGED_FUNCTION;
+
 /**
  * stream_buffer.h
  *
@@ -759,6 +941,44 @@ size_t xStreamBufferBytesAvailable( StreamBufferHandle_t xStreamBuffer ) PRIVILE
 BaseType_t xStreamBufferSetTriggerLevel( StreamBufferHandle_t xStreamBuffer,
                                          size_t xTriggerLevel ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * BaseType_t xStreamBufferSetSpaceTriggerLevel( StreamBufferHandle_t xStreamBuffer, size_t xTriggerLevel );
+ * @endcode
+ *
+ * A stream buffer's space trigger level is the number of bytes that must be
+ * free in the stream buffer before a task that is blocked on the stream buffer
+ * to wait for space is moved out of the blocked state.  It is the writer side
+ * equivalent of the trigger level set by xStreamBufferSetTriggerLevel().  For
+ * example, if a task is blocked on a write to a full stream buffer that has a
+ * space trigger level of 1 then the task will be unblocked when a single byte
+ * is read from the buffer.  If the space trigger level is 64 then the task will
+ * not be unblocked until at least 64 bytes are free or the task's block time
+ * expires, which avoids repeatedly waking a writer that cannot make useful
+ * progress.  Setting a space trigger level of 0 will result in a space trigger
+ * level of 1 being used, which is also the level used when a stream buffer is
+ * created.
+ *
+ * Note a writer that needs fewer bytes than the space trigger level is still
+ * only unblocked when the space trigger level is reached, or its block time
+ * expires.
+ *
+ * @param xStreamBuffer The handle of the stream buffer being updated.
+ *
+ * @param xTriggerLevel The new space trigger level for the stream buffer.
+ *
+ * @return If xTriggerLevel was less than or equal to the number of bytes the
+ * stream buffer can hold then the space trigger level will be updated and
+ * pdTRUE is returned.  Otherwise pdFALSE is returned.
+ *
+ * \defgroup xStreamBufferSetSpaceTriggerLevel xStreamBufferSetSpaceTriggerLevel
+ * \ingroup StreamBufferManagement
+ */
+BaseType_t xStreamBufferSetSpaceTriggerLevel( StreamBufferHandle_t xStreamBuffer,
+                                              size_t xTriggerLevel ) PRIVILEGED_FUNCTION;
+
 /**
  * stream_buffer.h
  *
@@ -843,14 +1063,19 @@ BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuf
 /* Functions below here are not part of the public API. */
 StreamBufferHandle_t xStreamBufferGenericCreate( size_t xBufferSizeBytes,
                                                  size_t xTriggerLevelBytes,
-                                                 BaseType_t xIsMessageBuffer ) PRIVILEGED_FUNCTION;
+                                                 BaseType_t xStreamBufferType ) PRIVILEGED_FUNCTION;
 
 StreamBufferHandle_t xStreamBufferGenericCreateStatic( size_t xBufferSizeBytes,
                                                        size_t xTriggerLevelBytes,
-                                                       BaseType_t xIsMessageBuffer,
+                                                       BaseType_t xStreamBufferType,
                                                        uint8_t * const pucStreamBufferStorageArea,
                                                        StaticStreamBuffer_t * const pxStaticStreamBuffer ) PRIVILEGED_FUNCTION;
 
+StreamBufferHandle_t xStreamBufferGenericCreateShared( size_t xBufferSizeBytes,
+                                                       size_t xTriggerLevelBytes,
+                                                       BaseType_t xStreamBufferType,
+                                                       void * const pvSharedMemory ) PRIVILEGED_FUNCTION;
+
 size_t xStreamBufferNextMessageLengthBytes( StreamBufferHandle_t xStreamBuffer ) PRIVILEGED_FUNCTION;
 
 #if ( configUSE_TRACE_FACILITY == 1 )
@@ -166,6 +166,9 @@ typedef struct xTASK_STATUS
         StackType_t * pxEndOfStack;               /* Points to the end address of the task's stack area. */
     #endif
     configSTACK_DEPTH_TYPE usStackHighWaterMark;  /* The minimum amount of stack space that has remained for the task since the task was created.  The closer this value is to zero the closer the task has come to overflowing its stack. */
+    #if ( configHEAP_TRACK_TASK_ALLOCATIONS == 1 )
+        size_t xHeapBytesInUse;                   /* The number of bytes the task has allocated from the heap and not yet freed, including the structure the heap places at the start of each block. */
+    #endif
 } TaskStatus_t;
 
 /* Possible return values for eTaskConfirmSleepModeStatus(). */
@@ -2959,6 +2962,11 @@ void vTaskPlaceOnEventList( List_t * const pxEventList,
 void vTaskPlaceOnUnorderedEventList( List_t * pxEventList,
                                      const TickType_t xItemValue,
                                      const TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+    void vTaskPlaceOnUnorderedEventList64( List_t * pxEventList,
+                                           const uint64_t ullItemValue,
+                                           const TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#endif
 
 /*
  * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS AN
@@ -3002,6 +3010,35 @@ void vTaskPlaceOnEventListRestricted( List_t * const pxEventList,
 BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList ) PRIVILEGED_FUNCTION;
 void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
                                         const TickType_t xItemValue ) PRIVILEGED_FUNCTION;
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+    void vTaskRemoveFromUnorderedEventList64( ListItem_t * pxEventListItem,
+                                              const uint64_t ullItemValue ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS AN
+ * INTERFACE WHICH IS FOR THE EXCLUSIVE USE OF THE SCHEDULER.
+ *
+ * THIS FUNCTION MUST BE CALLED WITH INTERRUPTS DISABLED.
+ *
+ * A version of vTaskRemoveFromUnorderedEventList() that can be called from an
+ * interrupt, or from a critical section, without the scheduler being
+ * suspended.  If the scheduler is suspended the task is held in the pending
+ * ready list until the scheduler is resumed.  Used by event groups when
+ * configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS is greater than 0.
+ *
+ * @return pdTRUE if the task being removed has a higher priority than the task
+ * making the call, otherwise pdFALSE.
+ */
+#if ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 )
+    BaseType_t xTaskRemoveFromUnorderedEventListFromISR( ListItem_t * pxEventListItem,
+                                                         const TickType_t xItemValue ) PRIVILEGED_FUNCTION;
+
+    #if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+        BaseType_t xTaskRemoveFromUnorderedEventListFromISR64( ListItem_t * pxEventListItem,
+                                                               const uint64_t ullItemValue ) PRIVILEGED_FUNCTION;
+    #endif
+#endif
 
 /*
  * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS ONLY
@@ -3019,6 +3056,19 @@ portDONT_DISCARD void vTaskSwitchContext( void ) PRIVILEGED_FUNCTION;
  */
 TickType_t uxTaskResetEventItemValue( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * THESE FUNCTIONS MUST NOT BE USED FROM APPLICATION CODE.  THEY ARE USED BY
+ * THE EVENT BITS MODULE WHEN configUSE_64_BIT_EVENT_GROUPS IS 1.
+ *
+ * A TickType_t list item value cannot hold 64 event bits plus the control
+ * bits, so the *64() variants of the unordered event list functions keep the
+ * full width value in the TCB of the task that owns the event list item.
+ */
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+    uint64_t ullTaskGetEventItemValue64( const ListItem_t * pxEventListItem ) PRIVILEGED_FUNCTION;
+    uint64_t ullTaskResetEventItemValue64( void ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Return the handle of the calling task.
  */
@@ -3103,6 +3153,17 @@ eSleepModeStatus eTaskConfirmSleepModeStatus( void ) PRIVILEGED_FUNCTION;
  */
 TaskHandle_t pvTaskIncrementMutexHeldCount( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * For internal use only.  Called by the heap, with the heap locked, to add the
+ * size of a block being allocated to the heap bytes in use by the calling task
+ * and return the handle of the task, or NULL if the scheduler has not been
+ * started, and to subtract the size of a block being freed from the heap bytes
+ * in use by the task that allocated it.
+ */
+TaskHandle_t pvTaskAddHeapBytesInUse( size_t xBytes ) PRIVILEGED_FUNCTION;
+void vTaskRemoveHeapBytesInUse( TaskHandle_t xTask,
+                                size_t xBytes ) PRIVILEGED_FUNCTION;
+
 /*
  * For internal use only.  Same as vTaskSetTimeOutState(), but without a critical
  * section.
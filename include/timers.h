@@ -69,6 +69,11 @@
 #define tmrCOMMAND_STOP_FROM_ISR                ( ( BaseType_t ) 8 )
 #define tmrCOMMAND_CHANGE_PERIOD_FROM_ISR       ( ( BaseType_t ) 9 )
 
+/* Sent by the kernel itself, not through the public API, to unblock the timer
+ * service task when it has work to do that is not held in the timer command
+ * queue. */
+#define tmrCOMMAND_WAKE_TIMER_TASK              ( ( BaseType_t ) 10 )
+
 
 /**
  * Type by which software timers are referenced.  For example, a call to
@@ -91,6 +96,36 @@ typedef void (* TimerCallbackFunction_t)( TimerHandle_t xTimer );
 typedef void (* PendedFunction_t)( void *,
                                    uint32_t );
 
+/* Used to pass information about the ring of pended function calls of a timer
+ * service task out of vTimerGetPendedFunctionRingStats(). */
+typedef struct xPendedFunctionRingStats
+{
+    UBaseType_t uxRingLength;         /* The number of function calls the ring can hold (configTIMER_PEND_FUNCTION_RING_LENGTH). */
+    UBaseType_t uxEntriesUsed;        /* The number of function calls in the ring at the time vTimerGetPendedFunctionRingStats() is called. */
+    UBaseType_t uxMaximumEntriesUsed; /* The maximum number of function calls there have been in the ring since the system booted. */
+    UBaseType_t uxOverflows;          /* The number of function calls that found the ring full, so were sent on the timer command queue instead. */
+} PendedFunctionRingStats_t;
+
+/*
+ * Defines the prototype to which high resolution timer callback functions must
+ * conform.
+ */
+struct xHIGH_RESOLUTION_TIMER;
+typedef void (* HighResolutionTimerCallbackFunction_t)( struct xHIGH_RESOLUTION_TIMER * pxTimer );
+
+/* A high resolution timer.  The application provides the memory for each high
+ * resolution timer and initialises it with vTimerInitialiseHighResolution().
+ * Only pvTimerID can be accessed by the application - the other members are
+ * for use by the kernel only. */
+typedef struct xHIGH_RESOLUTION_TIMER
+{
+    uint64_t ullExpiryTime;                                   /* The time, in nanoseconds, at which the timer expires. */
+    struct xHIGH_RESOLUTION_TIMER * pxNext;                   /* The next active high resolution timer, in order of expiry time. */
+    HighResolutionTimerCallbackFunction_t pxCallbackFunction; /* The function called when the timer expires. */
+    void * pvTimerID;                                         /* An identifier for the timer, for use by the callback function. */
+    volatile BaseType_t xIsActive;                            /* pdTRUE while the timer is waiting to expire. */
+} HighResolutionTimer_t;
+
 /**
  * TimerHandle_t xTimerCreate(  const char * const pcTimerName,
  *                              TickType_t xTimerPeriodInTicks,
@@ -411,6 +446,308 @@ void * pvTimerGetTimerID( const TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
 void vTimerSetTimerID( TimerHandle_t xTimer,
                        void * pvNewID ) PRIVILEGED_FUNCTION;
 
+/**
+ * void vTimerSetServiceTask( TimerHandle_t xTimer, UBaseType_t uxServiceTask );
+ *
+ * Selects the timer service task that services a timer, and therefore the
+ * priority at which the timer's callback function executes.
+ * configTIMER_SERVICE_TASKS must be greater than 1 for this function to be
+ * available.
+ *
+ * Timer service task 0 runs at configTIMER_TASK_PRIORITY.  Timer service task
+ * n, where n is greater than 0, runs at configTIMER_SERVICE_TASK_PRIORITY( n ).
+ * A callback that takes a long time to execute only delays the timers that are
+ * serviced by the same timer service task.  Timers are serviced by timer
+ * service task 0 until this function is called.  Pended functions (see
+ * xTimerPendFunctionCall()) are always executed by timer service task 0.
+ *
+ * The timer must not be active, and no command can be pending for the timer,
+ * when this function is called.  A command sent to the timer before this
+ * function is called, and not yet processed, would be processed by the old
+ * timer service task against the new timer service task's lists.  When
+ * configUSE_TIMER_COMMAND_COALESCING is 1 a pending command is caught by an
+ * assert, but a command still in the timer command queue cannot be detected.
+ * Normally this function is called once, after the timer is created and before
+ * the timer is started.
+ *
+ * @param xTimer The timer being updated.
+ *
+ * @param uxServiceTask The index of the timer service task that will service
+ * the timer, from 0 to ( configTIMER_SERVICE_TASKS - 1 ).
+ *
+ * Example usage:
+ * @verbatim
+ * xTimer = xTimerCreate( "Fast", pdMS_TO_TICKS( 5 ), pdTRUE, NULL, vFastCallback );
+ * vTimerSetServiceTask( xTimer, 1 );
+ * xTimerStart( xTimer, 0 );
+ * @endverbatim
+ */
+#if ( configTIMER_SERVICE_TASKS > 1 )
+    void vTimerSetServiceTask( TimerHandle_t xTimer,
+                               UBaseType_t uxServiceTask ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * void vTimerSetSlack( TimerHandle_t xTimer, const TickType_t xSlackInTicks );
+ *
+ * Sets the slack time of a timer.  configUSE_TIMER_SLACK must be set to 1 in
+ * FreeRTOSConfig.h for this function to be available.
+ *
+ * The callback function of a timer is normally called as soon as possible
+ * after the timer expires.  The callback function of a timer that has a slack
+ * time can be called at any time from when the timer expires until the slack
+ * time after that.  The timer service task uses the slack to process the
+ * expiry of many timers each time it unblocks, rather than unblocking for each
+ * timer in turn, which saves processing time and, when configUSE_TICKLESS_IDLE
+ * is used, allows the processor to stay in its low power state for longer.
+ *
+ * Timers are created with a slack time of 0.  Slack is intended for timers
+ * that do not need to expire at a precise time, such as timeouts and periodic
+ * housekeeping.  The slack time of an auto-reload timer does not accumulate -
+ * each period is still measured from when the timer should have expired.
+ *
+ * @param xTimer The timer being updated.
+ *
+ * @param xSlackInTicks The maximum time, in ticks, by which calling the timer's
+ * callback function can be delayed.
+ *
+ * Example usage:
+ * @verbatim
+ * xTimer = xTimerCreate( "Housekeeping", pdMS_TO_TICKS( 1000 ), pdTRUE, NULL, vHousekeepingCallback );
+ * vTimerSetSlack( xTimer, pdMS_TO_TICKS( 100 ) );
+ * xTimerStart( xTimer, 0 );
+ * @endverbatim
+ */
+#if ( configUSE_TIMER_SLACK == 1 )
+    void vTimerSetSlack( TimerHandle_t xTimer,
+                         const TickType_t xSlackInTicks ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * TickType_t xTimerGetSlack( TimerHandle_t xTimer );
+ *
+ * Returns the slack time of a timer, as set by vTimerSetSlack().
+ * configUSE_TIMER_SLACK must be set to 1 in FreeRTOSConfig.h for this function
+ * to be available.
+ *
+ * @param xTimer The timer being queried.
+ *
+ * @return The slack time of the timer in ticks.
+ */
+#if ( configUSE_TIMER_SLACK == 1 )
+    TickType_t xTimerGetSlack( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * void vTimerSetHardTimer( TimerHandle_t xTimer );
+ *
+ * Makes a timer a hard timer.  configUSE_HARD_TIMERS must be set to 1 or 2 in
+ * FreeRTOSConfig.h for this function to be available.
+ *
+ * The callback function of a hard timer is called directly from the tick
+ * interrupt (configUSE_HARD_TIMERS set to 1), or from the interrupt that calls
+ * vTimerProcessHardTimersFromISR() (configUSE_HARD_TIMERS set to 2), rather
+ * than from a timer service task, so it is not delayed by the timer service
+ * task being preempted or by the callbacks of other timers.  Hard timers are
+ * held in their own timing wheel, so starting, stopping and expiring a hard
+ * timer takes constant time.
+ *
+ * A hard timer callback executes in an interrupt so it must be short, must not
+ * block, and must only call API functions that end in "FromISR".  Pass NULL as
+ * the pxHigherPriorityTaskWoken parameter of those functions - if a task of
+ * higher priority than the interrupted task is unblocked then a context switch
+ * is performed when the interrupt exits.
+ *
+ * The standard timer API functions are used to start, stop, reset and change
+ * the period of a hard timer.  They update the timer immediately rather than
+ * sending a command to the timer service task, so never block and never fail.
+ * xTimerDelete() still uses the timer service task to free the timer.  When
+ * configUSE_HARD_TIMERS is set to 2, the period of a hard timer is counted in
+ * calls to vTimerProcessHardTimersFromISR() rather than in ticks, and the
+ * value returned by xTimerGetExpiryTime() is in the same units.
+ *
+ * The timer must not be active when this function is called.  Normally it is
+ * called once, after the timer is created and before the timer is started.
+ *
+ * @param xTimer The timer being made a hard timer.
+ *
+ * Example usage:
+ * @verbatim
+ * static void vSampleCallback( TimerHandle_t xTimer )
+ * {
+ *     vStartConversion();
+ *     vTaskNotifyGiveFromISR( xSamplingTask, NULL );
+ * }
+ *
+ * xTimer = xTimerCreate( "Sample", 1, pdTRUE, NULL, vSampleCallback );
+ * vTimerSetHardTimer( xTimer );
+ * xTimerStart( xTimer, 0 );
+ * @endverbatim
+ */
+#if ( configUSE_HARD_TIMERS != 0 )
+    void vTimerSetHardTimer( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * void vTimerProcessHardTimersFromISR( void );
+ *
+ * Advances the hard timer time by one, then calls the callback of each hard
+ * timer that expires.  When configUSE_HARD_TIMERS is set to 1 this is called
+ * by the kernel from the tick interrupt.  When configUSE_HARD_TIMERS is set to 2
+ * the application must call it at a fixed rate, normally from a hardware timer
+ * interrupt that runs at a higher rate or with less latency than the tick.
+ */
+#if ( configUSE_HARD_TIMERS != 0 )
+    void vTimerProcessHardTimersFromISR( void ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * void vTimerInitialiseHighResolution( HighResolutionTimer_t * pxTimer,
+ *                                      HighResolutionTimerCallbackFunction_t pxCallbackFunction,
+ *                                      void * pvTimerID );
+ *
+ * Initialises a high resolution timer.  configUSE_HIGH_RESOLUTION_TIMERS must
+ * be set to 1 in FreeRTOSConfig.h for the high resolution timer functions to be
+ * available.
+ *
+ * High resolution timers are one-shot timers that measure time in nanoseconds
+ * rather than in ticks, so they can expire between two ticks without the tick
+ * rate being raised.  They use a one-shot compare interrupt provided by the
+ * port - see portGET_HIGH_RESOLUTION_TIME_NS() and
+ * portSET_HIGH_RESOLUTION_COMPARE() - and the callback function of a high
+ * resolution timer is called from that interrupt, so the same restrictions
+ * apply as to the callback function of a hard timer (see vTimerSetHardTimer()).
+ * A callback function can restart its own timer to create a periodic timer.
+ *
+ * The timer is dormant until it is started by vTimerStartHighResolution() or
+ * vTimerStartHighResolutionFromISR().  The memory used by the timer must remain
+ * valid until the timer is no longer active.
+ *
+ * @param pxTimer The timer being initialised.
+ *
+ * @param pxCallbackFunction The function to call when the timer expires.
+ *
+ * @param pvTimerID An identifier for the timer, stored in the pvTimerID member
+ * of the timer so the callback function can access it.
+ *
+ * Example usage:
+ * @verbatim
+ * static HighResolutionTimer_t xStepTimer;
+ *
+ * static void vStepCallback( HighResolutionTimer_t * pxTimer )
+ * {
+ *     vStepMotor();
+ *     vTimerStartHighResolutionFromISR( pxTimer, ulStepIntervalNs );
+ * }
+ *
+ * vTimerInitialiseHighResolution( &xStepTimer, vStepCallback, NULL );
+ * vTimerStartHighResolution( &xStepTimer, ulStepIntervalNs );
+ * @endverbatim
+ */
+#if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+    void vTimerInitialiseHighResolution( HighResolutionTimer_t * pxTimer,
+                                         HighResolutionTimerCallbackFunction_t pxCallbackFunction,
+                                         void * pvTimerID ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * void vTimerStartHighResolution( HighResolutionTimer_t * pxTimer,
+ *                                 uint64_t ullDelayNs );
+ *
+ * Starts a high resolution timer so it expires ullDelayNs nanoseconds after the
+ * function is called.  If the timer is already active it is restarted.  The
+ * timer is started immediately, without using a timer service task, so this
+ * function never blocks.  The version with the "FromISR" suffix can be called
+ * from an interrupt, including from the callback function of a high resolution
+ * timer or a hard timer.
+ *
+ * @param pxTimer The timer being started.
+ *
+ * @param ullDelayNs The time, in nanoseconds, after which the timer expires.
+ */
+#if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+    void vTimerStartHighResolution( HighResolutionTimer_t * pxTimer,
+                                    uint64_t ullDelayNs ) PRIVILEGED_FUNCTION;
+    void vTimerStartHighResolutionFromISR( HighResolutionTimer_t * pxTimer,
+                                           uint64_t ullDelayNs ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * void vTimerStopHighResolution( HighResolutionTimer_t * pxTimer );
+ *
+ * Stops a high resolution timer.  Stopping a timer that is not active has no
+ * effect.  The version with the "FromISR" suffix can be called from an
+ * interrupt.
+ *
+ * @param pxTimer The timer being stopped.
+ */
+#if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+    void vTimerStopHighResolution( HighResolutionTimer_t * pxTimer ) PRIVILEGED_FUNCTION;
+    void vTimerStopHighResolutionFromISR( HighResolutionTimer_t * pxTimer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * BaseType_t xTimerIsHighResolutionTimerActive( const HighResolutionTimer_t * pxTimer );
+ *
+ * @param pxTimer The timer being queried.
+ *
+ * @return pdFALSE if the timer is dormant, otherwise pdTRUE.
+ */
+#if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+    BaseType_t xTimerIsHighResolutionTimerActive( const HighResolutionTimer_t * pxTimer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * uint64_t ullTimerGetHighResolutionTime( void );
+ *
+ * @return The time, in nanoseconds, used by high resolution timers.  The time
+ * is provided by the port so is not related to the tick count.
+ */
+#if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+    uint64_t ullTimerGetHighResolutionTime( void ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * void vTimerDelayHighResolution( uint64_t ullDelayNs );
+ *
+ * Places the calling task into the Blocked state for ullDelayNs nanoseconds,
+ * measured with a high resolution timer rather than in ticks.  The task is
+ * unblocked by the timer giving it a direct to task notification at array
+ * index 0, as if by vTaskNotifyGiveFromISR().  Notifications given to the task
+ * by other code while it is delayed do not end the delay early and are still
+ * pending when the delay ends.
+ *
+ * @param ullDelayNs The time, in nanoseconds, for which the calling task
+ * blocks.
+ *
+ * Example usage:
+ * @verbatim
+ * // Pulse an output for 50 microseconds.
+ * vSetOutput( pdTRUE );
+ * vTimerDelayHighResolution( 50000 );
+ * vSetOutput( pdFALSE );
+ * @endverbatim
+ */
+#if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+    void vTimerDelayHighResolution( uint64_t ullDelayNs ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * BaseType_t xTimerProcessHighResolutionTimersFromISR( void );
+ *
+ * Calls the callback of each high resolution timer that has expired, then
+ * sets the port's compare for the next timer to expire.  Called by the port
+ * from the interrupt generated when the time set by
+ * portSET_HIGH_RESOLUTION_COMPARE() is reached.  It is safe for the interrupt
+ * to occur when no timer has expired.
+ *
+ * @return pdTRUE if a callback function was called, in which case the port
+ * must request a context switch before the interrupt exits, otherwise pdFALSE.
+ */
+#if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+    BaseType_t xTimerProcessHighResolutionTimersFromISR( void ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * BaseType_t xTimerIsTimerActive( TimerHandle_t xTimer );
  *
@@ -466,6 +803,20 @@ TaskHandle_t xTimerGetTimerDaemonTaskHandle( void ) PRIVILEGED_FUNCTION;
  * code.  The length of the timer command queue is set by the
  * configTIMER_QUEUE_LENGTH configuration constant.
  *
+ * If configUSE_TIMER_DIRECT_COMMANDS is set to 1 then xTimerStart(),
+ * xTimerReset(), xTimerStop() and xTimerChangePeriod() update the timer
+ * directly, without using the timer command queue, whenever the timer service
+ * task is blocked and no earlier commands are waiting in the queue.  The timer
+ * service task is then only unblocked if the timer expires before the time at
+ * which the timer service task was already going to unblock.
+ *
+ * If configUSE_TIMER_COMMAND_COALESCING is set to 1 then commands are held in
+ * the timer itself rather than in the timer command queue, and a command
+ * replaces any command sent to the same timer that the timer service task has
+ * not yet processed.  Sending a command therefore never blocks, so xTicksToWait
+ * is not used.  A change of period is always applied, even if it is replaced by
+ * a later start, reset or stop command.
+ *
  * xTimerStart() starts a timer that was previously created using the
  * xTimerCreate() API function.  If the timer had already been started and was
  * already in the active state, then xTimerStart() has equivalent functionality
@@ -1229,7 +1580,9 @@ BaseType_t xTimerPendFunctionCallFromISR( PendedFunction_t xFunctionToPend,
  * sent to the timer daemon task on a queue.  xTicksToWait is the amount of
  * time the calling task should remain in the Blocked state (so not using any
  * processing time) for space to become available on the timer queue if the
- * queue is found to be full.
+ * queue is found to be full.  When configTIMER_PEND_FUNCTION_RING_LENGTH is
+ * greater than 0 the function call is added to a ring of pended function calls
+ * instead, and the queue is only used if the ring is full.
  *
  * @return pdPASS is returned if the message was successfully sent to the
  * timer daemon task, otherwise pdFALSE is returned.
@@ -1240,6 +1593,67 @@ BaseType_t xTimerPendFunctionCall( PendedFunction_t xFunctionToPend,
                                    uint32_t ulParameter2,
                                    TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 
+/**
+ * BaseType_t xTimerPendFunctionCallOnServiceTaskFromISR( UBaseType_t uxServiceTask,
+ *                                                        PendedFunction_t xFunctionToPend,
+ *                                                        void *pvParameter1,
+ *                                                        uint32_t ulParameter2,
+ *                                                        BaseType_t *pxHigherPriorityTaskWoken );
+ *
+ * BaseType_t xTimerPendFunctionCallOnServiceTask( UBaseType_t uxServiceTask,
+ *                                                 PendedFunction_t xFunctionToPend,
+ *                                                 void *pvParameter1,
+ *                                                 uint32_t ulParameter2,
+ *                                                 TickType_t xTicksToWait );
+ *
+ * Versions of xTimerPendFunctionCallFromISR() and xTimerPendFunctionCall() that
+ * defer the execution of a function to the timer service task with index
+ * uxServiceTask, rather than to timer service task 0, so the function executes
+ * at the priority of that timer service task.  configTIMER_SERVICE_TASKS must
+ * be greater than 1 for these functions to be available.
+ *
+ * When configTIMER_PEND_FUNCTION_RING_LENGTH is greater than 0 each timer
+ * service task has its own ring of pended function calls, so work deferred to
+ * one timer service task never waits behind work deferred to another.
+ */
+#if ( configTIMER_SERVICE_TASKS > 1 )
+    BaseType_t xTimerPendFunctionCallOnServiceTaskFromISR( UBaseType_t uxServiceTask,
+                                                           PendedFunction_t xFunctionToPend,
+                                                           void * pvParameter1,
+                                                           uint32_t ulParameter2,
+                                                           BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+    BaseType_t xTimerPendFunctionCallOnServiceTask( UBaseType_t uxServiceTask,
+                                                    PendedFunction_t xFunctionToPend,
+                                                    void * pvParameter1,
+                                                    uint32_t ulParameter2,
+                                                    TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * void vTimerGetPendedFunctionRingStats( UBaseType_t uxServiceTask, PendedFunctionRingStats_t *pxRingStats );
+ *
+ * Returns information on the ring of pended function calls of the timer
+ * service task with index uxServiceTask.  configTIMER_PEND_FUNCTION_RING_LENGTH
+ * must be greater than 0 for this function to be available.
+ *
+ * Pended function calls are added to the ring, and removed in batches by the
+ * timer service task, without using the timer command queue.  A function call
+ * that finds the ring full is sent on the timer command queue instead, and
+ * counted in the uxOverflows member of the returned structure.  A function
+ * call sent on the queue can execute before function calls that were already
+ * in the ring.  If overflows occur then configTIMER_PEND_FUNCTION_RING_LENGTH
+ * should be increased, or the priority of the timer service task raised.
+ *
+ * @param uxServiceTask The index of the timer service task being queried, from
+ * 0 to ( configTIMER_SERVICE_TASKS - 1 ).
+ *
+ * @param pxRingStats The structure into which the information is written.
+ */
+#if ( configTIMER_PEND_FUNCTION_RING_LENGTH > 0 )
+    void vTimerGetPendedFunctionRingStats( UBaseType_t uxServiceTask,
+                                           PendedFunctionRingStats_t * pxRingStats ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * const char * const pcTimerGetName( TimerHandle_t xTimer );
  *
@@ -1359,6 +1773,29 @@ BaseType_t xTimerGenericCommand( TimerHandle_t xTimer,
                                          StackType_t ** ppxTimerTaskStackBuffer,
                                          uint32_t * pulTimerTaskStackSize );
 
+    #if ( configTIMER_SERVICE_TASKS > 1 )
+
+/**
+ * task.h
+ * @code{c}
+ * void vApplicationGetTimerServiceTaskMemory( UBaseType_t uxServiceTask, StaticTask_t ** ppxTimerTaskTCBBuffer, StackType_t ** ppxTimerTaskStackBuffer, uint32_t *pulTimerTaskStackSize )
+ * @endcode
+ *
+ * This function is used to provide a statically allocated block of memory to FreeRTOS to hold the TCB of each additional timer service task.  This function is
+ * required when configSUPPORT_STATIC_ALLOCATION is set and configTIMER_SERVICE_TASKS is greater than 1.  It is called once for each timer service task other
+ * than timer service task 0, which uses vApplicationGetTimerTaskMemory().
+ *
+ * @param uxServiceTask           The index of the timer service task, from 1 to ( configTIMER_SERVICE_TASKS - 1 )
+ * @param ppxTimerTaskTCBBuffer   A handle to a statically allocated TCB buffer
+ * @param ppxTimerTaskStackBuffer A handle to a statically allocated Stack buffer for the timer service task
+ * @param pulTimerTaskStackSize   A pointer to the number of elements that will fit in the allocated stack buffer
+ */
+        void vApplicationGetTimerServiceTaskMemory( UBaseType_t uxServiceTask,
+                                                    StaticTask_t ** ppxTimerTaskTCBBuffer,
+                                                    StackType_t ** ppxTimerTaskStackBuffer,
+                                                    uint32_t * pulTimerTaskStackSize );
+    #endif
+
 #endif
 
 /* *INDENT-OFF* */
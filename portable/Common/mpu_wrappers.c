@@ -1426,16 +1426,29 @@
     }
 /*-----------------------------------------------------------*/
 
+    BaseType_t MPU_xStreamBufferSetSpaceTriggerLevel( StreamBufferHandle_t xStreamBuffer,
+                                                      size_t xTriggerLevel ) /* FREERTOS_SYSTEM_CALL */
+    {
+        BaseType_t xReturn, xRunningPrivileged;
+
+        xPortRaisePrivilege( xRunningPrivileged );
+        xReturn = xStreamBufferSetSpaceTriggerLevel( xStreamBuffer, xTriggerLevel );
+        vPortResetPrivilege( xRunningPrivileged );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
     #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
         StreamBufferHandle_t MPU_xStreamBufferGenericCreate( size_t xBufferSizeBytes,
                                                              size_t xTriggerLevelBytes,
-                                                             BaseType_t xIsMessageBuffer ) /* FREERTOS_SYSTEM_CALL */
+                                                             BaseType_t xStreamBufferType ) /* FREERTOS_SYSTEM_CALL */
         {
             StreamBufferHandle_t xReturn;
             BaseType_t xRunningPrivileged;
 
             xPortRaisePrivilege( xRunningPrivileged );
-            xReturn = xStreamBufferGenericCreate( xBufferSizeBytes, xTriggerLevelBytes, xIsMessageBuffer );
+            xReturn = xStreamBufferGenericCreate( xBufferSizeBytes, xTriggerLevelBytes, xStreamBufferType );
             vPortResetPrivilege( xRunningPrivileged );
 
             return xReturn;
@@ -1446,7 +1459,7 @@
     #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
         StreamBufferHandle_t MPU_xStreamBufferGenericCreateStatic( size_t xBufferSizeBytes,
                                                                    size_t xTriggerLevelBytes,
-                                                                   BaseType_t xIsMessageBuffer,
+                                                                   BaseType_t xStreamBufferType,
                                                                    uint8_t * const pucStreamBufferStorageArea,
                                                                    StaticStreamBuffer_t * const pxStaticStreamBuffer ) /* FREERTOS_SYSTEM_CALL */
         {
@@ -1454,7 +1467,7 @@
             BaseType_t xRunningPrivileged;
 
             xPortRaisePrivilege( xRunningPrivileged );
-            xReturn = xStreamBufferGenericCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, xIsMessageBuffer, pucStreamBufferStorageArea, pxStaticStreamBuffer );
+            xReturn = xStreamBufferGenericCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, xStreamBufferType, pucStreamBufferStorageArea, pxStaticStreamBuffer );
             vPortResetPrivilege( xRunningPrivileged );
 
             return xReturn;
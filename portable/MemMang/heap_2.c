@@ -56,6 +56,24 @@
     #define configHEAP_CLEAR_MEMORY_ON_FREE    0
 #endif
 
+/* The heap is protected by critical sections when
+ * configHEAP_USE_CRITICAL_SECTIONS is 1, otherwise by suspending the scheduler.
+ * heapWALK_MUST_RESTART() is called for each block a walk of the free list
+ * steps over, and returns pdTRUE if the walk must start again from the
+ * beginning because the list changed while the critical section was left (see
+ * prvHeapWalkStep()). */
+#if ( configHEAP_USE_CRITICAL_SECTIONS == 1 )
+    #define heapLOCK()                          taskENTER_CRITICAL()
+    #define heapUNLOCK()                        taskEXIT_CRITICAL()
+    #define heapFREE_LIST_CHANGED()             ( uxFreeListChanges++ )
+    #define heapWALK_MUST_RESTART( uxSteps )    prvHeapWalkStep( &( uxSteps ) )
+#else
+    #define heapLOCK()                          vTaskSuspendAll()
+    #define heapUNLOCK()                        ( void ) xTaskResumeAll()
+    #define heapFREE_LIST_CHANGED()
+    #define heapWALK_MUST_RESTART( uxSteps )    ( ( void ) ( uxSteps ), pdFALSE )
+#endif
+
 /* A few bytes might be lost to byte aligning the heap start address. */
 #define configADJUSTED_HEAP_SIZE    ( configTOTAL_HEAP_SIZE - portBYTE_ALIGNMENT )
 
@@ -113,6 +131,14 @@ PRIVILEGED_DATA static BlockLink_t xStart, xEnd;
  * fragmentation. */
 PRIVILEGED_DATA static size_t xFreeBytesRemaining = configADJUSTED_HEAP_SIZE;
 
+#if ( configHEAP_USE_CRITICAL_SECTIONS == 1 )
+
+/* Incremented each time a block is added to or removed from the list of free
+ * blocks, so a walk that left its critical section can tell whether the blocks
+ * it has reached are still valid. */
+    PRIVILEGED_DATA static UBaseType_t uxFreeListChanges = 0U;
+#endif
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -120,6 +146,18 @@ PRIVILEGED_DATA static size_t xFreeBytesRemaining = configADJUSTED_HEAP_SIZE;
  */
 static void prvHeapInit( void ) PRIVILEGED_FUNCTION;
 
+#if ( configHEAP_USE_CRITICAL_SECTIONS == 1 )
+
+/*
+ * Count a step of a walk of the free list made in a critical section.  After
+ * every configHEAP_CRITICAL_SECTION_BLOCKS steps the critical section is left
+ * and entered again, so interrupts and higher priority tasks can run.  Returns
+ * pdTRUE if the free list was changed meanwhile, in which case the blocks the
+ * walk has reached may no longer be free.
+ */
+    static BaseType_t prvHeapWalkStep( UBaseType_t * puxSteps ) PRIVILEGED_FUNCTION;
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* STATIC FUNCTIONS ARE DEFINED AS MACROS TO MINIMIZE THE FUNCTION CALL DEPTH. */
@@ -129,24 +167,35 @@ static void prvHeapInit( void ) PRIVILEGED_FUNCTION;
  * the block.  Small blocks at the start of the list and large blocks at the end
  * of the list.
  */
-#define prvInsertBlockIntoFreeList( pxBlockToInsert )                                                                               \
-    {                                                                                                                               \
-        BlockLink_t * pxIterator;                                                                                                   \
-        size_t xBlockSize;                                                                                                          \
-                                                                                                                                    \
-        xBlockSize = pxBlockToInsert->xBlockSize;                                                                                   \
-                                                                                                                                    \
-        /* Iterate through the list until a block is found that has a larger size */                                                \
-        /* than the block we are inserting. */                                                                                      \
-        for( pxIterator = &xStart; pxIterator->pxNextFreeBlock->xBlockSize < xBlockSize; pxIterator = pxIterator->pxNextFreeBlock ) \
-        {                                                                                                                           \
-            /* There is nothing to do here - just iterate to the correct position. */                                               \
-        }                                                                                                                           \
-                                                                                                                                    \
-        /* Update the list to include the block being inserted in the correct */                                                    \
-        /* position. */                                                                                                             \
-        pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock;                                                             \
-        pxIterator->pxNextFreeBlock = pxBlockToInsert;                                                                              \
+#define prvInsertBlockIntoFreeList( pxBlockToInsert )                                \
+    {                                                                                \
+        BlockLink_t * pxIterator;                                                    \
+        size_t xBlockSize;                                                           \
+        UBaseType_t uxInsertSteps = 0U;                                              \
+                                                                                     \
+        xBlockSize = pxBlockToInsert->xBlockSize;                                    \
+                                                                                     \
+        /* Iterate through the list until a block is found that has a larger size */ \
+        /* than the block we are inserting. */                                       \
+        pxIterator = &xStart;                                                        \
+                                                                                     \
+        while( pxIterator->pxNextFreeBlock->xBlockSize < xBlockSize )                \
+        {                                                                            \
+            if( heapWALK_MUST_RESTART( uxInsertSteps ) != pdFALSE )                  \
+            {                                                                        \
+                pxIterator = &xStart;                                                \
+            }                                                                        \
+            else                                                                     \
+            {                                                                        \
+                pxIterator = pxIterator->pxNextFreeBlock;                            \
+            }                                                                        \
+        }                                                                            \
+                                                                                     \
+        /* Update the list to include the block being inserted in the correct */     \
+        /* position. */                                                              \
+        pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock;              \
+        pxIterator->pxNextFreeBlock = pxBlockToInsert;                               \
+        heapFREE_LIST_CHANGED();                                                     \
     }
 /*-----------------------------------------------------------*/
 
@@ -156,8 +205,9 @@ void * pvPortMalloc( size_t xWantedSize )
     PRIVILEGED_DATA static BaseType_t xHeapHasBeenInitialised = pdFALSE;
     void * pvReturn = NULL;
     size_t xAdditionalRequiredSize;
+    UBaseType_t uxSteps = 0U;
 
-    vTaskSuspendAll();
+    heapLOCK();
     {
         /* If this is the first call to malloc then the heap will require
          * initialisation to setup the list of free blocks. */
@@ -199,8 +249,16 @@ void * pvPortMalloc( size_t xWantedSize )
 
                 while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != NULL ) )
                 {
-                    pxPreviousBlock = pxBlock;
-                    pxBlock = pxBlock->pxNextFreeBlock;
+                    if( heapWALK_MUST_RESTART( uxSteps ) != pdFALSE )
+                    {
+                        pxPreviousBlock = &xStart;
+                        pxBlock = xStart.pxNextFreeBlock;
+                    }
+                    else
+                    {
+                        pxPreviousBlock = pxBlock;
+                        pxBlock = pxBlock->pxNextFreeBlock;
+                    }
                 }
 
                 /* If we found the end marker then a block of adequate size was not found. */
@@ -213,6 +271,7 @@ void * pvPortMalloc( size_t xWantedSize )
                     /* This block is being returned for use so must be taken out of the
                      * list of free blocks. */
                     pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+                    heapFREE_LIST_CHANGED();
 
                     /* If the block is larger than required it can be split into two. */
                     if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
@@ -243,7 +302,7 @@ void * pvPortMalloc( size_t xWantedSize )
 
         traceMALLOC( pvReturn, xWantedSize );
     }
-    ( void ) xTaskResumeAll();
+    heapUNLOCK();
 
     #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
     {
@@ -290,14 +349,14 @@ void vPortFree( void * pv )
                 }
                 #endif
 
-                vTaskSuspendAll();
+                heapLOCK();
                 {
                     /* Add this block to the list of free blocks. */
                     prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
                     xFreeBytesRemaining += pxLink->xBlockSize;
                     traceFREE( pv, pxLink->xBlockSize );
                 }
-                ( void ) xTaskResumeAll();
+                heapUNLOCK();
             }
         }
     }
@@ -359,3 +418,42 @@ static void prvHeapInit( void ) /* PRIVILEGED_FUNCTION */
     pxFirstFreeBlock->pxNextFreeBlock = &xEnd;
 }
 /*-----------------------------------------------------------*/
+
+#if ( configHEAP_USE_CRITICAL_SECTIONS == 1 )
+
+    static BaseType_t prvHeapWalkStep( UBaseType_t * puxSteps ) /* PRIVILEGED_FUNCTION */
+    {
+        BaseType_t xRestart = pdFALSE;
+        UBaseType_t uxChanges;
+
+        ( *puxSteps )++;
+
+        if( *puxSteps >= ( UBaseType_t ) configHEAP_CRITICAL_SECTION_BLOCKS )
+        {
+            *puxSteps = 0U;
+            uxChanges = uxFreeListChanges;
+
+            /* Let any pending interrupt, or a task that it unblocked, run
+             * before the walk continues. */
+            taskEXIT_CRITICAL();
+            taskENTER_CRITICAL();
+
+            if( uxChanges != uxFreeListChanges )
+            {
+                xRestart = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xRestart;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configHEAP_USE_CRITICAL_SECTIONS */
@@ -67,6 +67,17 @@
  *
  * Note 0x80000000 is the lower address so appears in the array first.
  *
+ * If configHEAP_MAX_REGIONS is greater than 0 then pvPortMallocFromRegion()
+ * allocates from one region only, identified by its index in the array passed
+ * to vPortDefineHeapRegions() - 0 for the block at 0x80000000 and 1 for the
+ * block at 0x90000000 in the example above - so, for example, frequently used
+ * buffers can be kept in fast internal RAM when the heap also spans slower
+ * external RAM.  pvPortMallocFromPreferredRegion() tries the given region
+ * first then the rest of the heap.  Task stacks and the storage of queues
+ * created with xQueueCreate() are allocated from a preferred region when
+ * configHEAP_TASK_STACK_REGION and configHEAP_QUEUE_STORAGE_REGION
+ * respectively are set to the index of the region.
+ *
  */
 #include <stdlib.h>
 #include <string.h>
@@ -79,16 +90,89 @@
 #include "FreeRTOS.h"
 #include "task.h"
 
+#if ( configHEAP_USE_WATERMARKS == 1 )
+    #include "timers.h"
+#endif
+
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
 #if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
     #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
 #endif
 
+#if ( ( configHEAP_TRACK_TASK_ALLOCATIONS == 1 ) && ( configHEAP_MAX_REGIONS == 0 ) )
+    #error configHEAP_MAX_REGIONS must be set so the regions can be walked when configHEAP_TRACK_TASK_ALLOCATIONS is 1.
+#endif
+
 #ifndef configHEAP_CLEAR_MEMORY_ON_FREE
     #define configHEAP_CLEAR_MEMORY_ON_FREE    0
 #endif
 
+/* The heap is protected by critical sections when
+ * configHEAP_USE_CRITICAL_SECTIONS is 1, otherwise by suspending the scheduler.
+ * heapWALK_MUST_RESTART() is called for each block a walk of the heap steps
+ * over, and returns pdTRUE if the walk must start again from the beginning
+ * because the free list changed while the critical section was left (see
+ * prvHeapWalkStep()). */
+#if ( configHEAP_USE_CRITICAL_SECTIONS == 1 )
+    #define heapLOCK()                          taskENTER_CRITICAL()
+    #define heapUNLOCK()                        taskEXIT_CRITICAL()
+    #define heapFREE_LIST_CHANGED()             ( uxFreeListChanges++ )
+    #define heapWALK_MUST_RESTART( uxSteps )    prvHeapWalkStep( &( uxSteps ) )
+#else
+    #define heapLOCK()                          vTaskSuspendAll()
+    #define heapUNLOCK()                        ( void ) xTaskResumeAll()
+    #define heapFREE_LIST_CHANGED()
+    #define heapWALK_MUST_RESTART( uxSteps )    ( ( void ) ( uxSteps ), pdFALSE )
+#endif
+
+/* Keep the histogram of free blocks up to date as blocks are added to and
+ * removed from the list of free blocks. */
+#if ( configHEAP_HISTOGRAM_BUCKETS > 0 )
+    #define heapHISTOGRAM_ADD_BLOCK( xBlockSize )       prvHistogramAddBlock( xBlockSize )
+    #define heapHISTOGRAM_REMOVE_BLOCK( xBlockSize )    prvHistogramRemoveBlock( xBlockSize )
+#else
+    #define heapHISTOGRAM_ADD_BLOCK( xBlockSize )
+    #define heapHISTOGRAM_REMOVE_BLOCK( xBlockSize )
+#endif
+
+/* Record the task that allocated each block, and count the block's size in
+ * the task's heap bytes in use until the block is freed. */
+#if ( configHEAP_TRACK_TASK_ALLOCATIONS == 1 )
+    #define heapTRACK_ALLOCATION( pxBlock )    ( ( pxBlock )->xOwner = pvTaskAddHeapBytesInUse( ( pxBlock )->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK ) )
+    #define heapTRACK_FREE( pxBlock )          vTaskRemoveHeapBytesInUse( ( pxBlock )->xOwner, ( pxBlock )->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK )
+#else
+    #define heapTRACK_ALLOCATION( pxBlock )
+    #define heapTRACK_FREE( pxBlock )
+#endif
+
+/* Record where each block was allocated.  configHEAP_CALL_SITE() is evaluated
+ * in the function the application called to allocate the block. */
+#if ( ( configHEAP_TRACK_TASK_ALLOCATIONS == 1 ) && defined( configHEAP_CALL_SITE ) )
+    #define heapSET_CALL_SITE( pv )    prvSetCallSite( ( pv ), configHEAP_CALL_SITE() )
+#else
+    #define heapSET_CALL_SITE( pv )
+#endif
+
+/* Check whether the free heap space has crossed a watermark each time it
+ * changes.  A pending watermark event is taken while the heap is still locked,
+ * and the watermark callback deferred to the timer service task once the heap
+ * has been unlocked. */
+#define heapNO_WATERMARK_EVENT    ( ( BaseType_t ) -1 )
+
+#if ( configHEAP_USE_WATERMARKS == 1 )
+    #define heapUPDATE_WATERMARKS()               prvUpdateWatermarks()
+    #define heapTAKE_WATERMARK_EVENT( xEvent )    ( xEvent ) = prvTakeWatermarkEvent()
+    #define heapSEND_WATERMARK_EVENT( xEvent )    prvSendWatermarkEvent( xEvent )
+#else
+    #define heapUPDATE_WATERMARKS()
+    #define heapTAKE_WATERMARK_EVENT( xEvent )
+    #define heapSEND_WATERMARK_EVENT( xEvent )    ( void ) ( xEvent )
+#endif
+
+/* Passed as the region to prvHeapAllocate() to allocate from any region. */
+#define heapANY_REGION    ( ( BaseType_t ) -1 )
+
 /* Block sizes must not get too small. */
 #define heapMINIMUM_BLOCK_SIZE    ( ( size_t ) ( xHeapStructSize << 1 ) )
 
@@ -114,6 +198,9 @@
 #define heapALLOCATE_BLOCK( pxBlock )            ( ( pxBlock->xBlockSize ) |= heapBLOCK_ALLOCATED_BITMASK )
 #define heapFREE_BLOCK( pxBlock )                ( ( pxBlock->xBlockSize ) &= ~heapBLOCK_ALLOCATED_BITMASK )
 
+/* The block that follows pxBlock in memory. */
+#define heapNEXT_BLOCK( pxBlock )                ( ( BlockLink_t * ) ( ( ( uint8_t * ) ( pxBlock ) ) + ( ( pxBlock )->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK ) ) )
+
 /*-----------------------------------------------------------*/
 
 /* Define the linked list structure.  This is used to link free blocks in order
@@ -122,6 +209,12 @@ typedef struct A_BLOCK_LINK
 {
     struct A_BLOCK_LINK * pxNextFreeBlock; /*<< The next free block in the list. */
     size_t xBlockSize;                     /*<< The size of the free block. */
+    #if ( configHEAP_TRACK_TASK_ALLOCATIONS == 1 )
+        TaskHandle_t xOwner;               /*<< The task that allocated the block, or NULL. */
+        #ifdef configHEAP_CALL_SITE
+            void * pvCallSite;             /*<< Where the block was allocated. */
+        #endif
+    #endif
 } BlockLink_t;
 
 /*-----------------------------------------------------------*/
@@ -134,6 +227,124 @@ typedef struct A_BLOCK_LINK
  */
 static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert );
 
+/*
+ * Allocate a block of xWantedSize bytes, the start of which is aligned to
+ * xAlignment, from region xRegion, or from any region if xRegion is
+ * heapANY_REGION.  If xFallBackToAnyRegion is pdTRUE and the region does not
+ * have a large enough free block then the block is allocated from any region
+ * instead.
+ */
+static void * prvHeapAllocate( size_t xWantedSize,
+                               size_t xAlignment,
+                               BaseType_t xRegion,
+                               BaseType_t xFallBackToAnyRegion );
+
+/*
+ * Take a block for prvHeapAllocate() from the list of free blocks.  Returns
+ * NULL if there is no large enough free block, without calling the shrinkers or
+ * the malloc failed hook.
+ */
+static void * prvAllocateFromFreeList( size_t xWantedSize,
+                                       size_t xAlignment,
+                                       BaseType_t xRegion,
+                                       BaseType_t xFallBackToAnyRegion ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the first free block in region xRegion, or in any region if xRegion
+ * is heapANY_REGION, that can hold a block of xWantedSize bytes aligned to
+ * xAlignment.  Sets *ppxPreviousBlock to the free block before it and
+ * *pxLeadingBytes to the number of bytes at its start that must be left free
+ * to align the allocated block.  Returns NULL if there is no such block.
+ */
+static BlockLink_t * prvFindFreeBlock( size_t xWantedSize,
+                                       size_t xAlignment,
+                                       BaseType_t xRegion,
+                                       BlockLink_t ** ppxPreviousBlock,
+                                       size_t * pxLeadingBytes );
+
+/*
+ * Returns the number of bytes at the start of the free block pxBlock that must
+ * be left free for the memory allocated from it to be aligned to xAlignment, or
+ * heapSIZE_MAX if pxBlock is too small for an aligned block of xWantedSize
+ * bytes.
+ */
+static size_t prvLeadingBytes( const BlockLink_t * pxBlock,
+                               size_t xWantedSize,
+                               size_t xAlignment );
+
+#if ( configHEAP_HISTOGRAM_BUCKETS > 0 )
+
+/*
+ * Count a block that has been added to, or removed from, the list of free
+ * blocks in the histogram of free blocks.
+ */
+    static void prvHistogramAddBlock( size_t xBlockSize ) PRIVILEGED_FUNCTION;
+    static void prvHistogramRemoveBlock( size_t xBlockSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the histogram bucket that counts free blocks of xBlockSize bytes.
+ */
+    static UBaseType_t prvHistogramBucket( size_t xBlockSize ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( ( configHEAP_TRACK_TASK_ALLOCATIONS == 1 ) && defined( configHEAP_CALL_SITE ) )
+
+/*
+ * Record pvCallSite in the block that holds the memory pv, if pv is not NULL.
+ */
+    static void prvSetCallSite( void * pv,
+                                void * pvCallSite );
+#endif
+
+#if ( configHEAP_USE_CRITICAL_SECTIONS == 1 )
+
+/*
+ * Count a step of a walk of the heap made in a critical section.  After every
+ * configHEAP_CRITICAL_SECTION_BLOCKS steps the critical section is left and
+ * entered again, so interrupts and higher priority tasks can run.  Returns
+ * pdTRUE if the free list was changed meanwhile, in which case the blocks the
+ * walk has reached may no longer exist.
+ */
+    static BaseType_t prvHeapWalkStep( UBaseType_t * puxSteps ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configHEAP_USE_WATERMARKS == 1 )
+
+/*
+ * Record that the watermark callback must be called if the free heap space has
+ * crossed a watermark.  Must be called with the heap locked.
+ */
+    static void prvUpdateWatermarks( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Clear and return the pending watermark event, as the watermark that was
+ * crossed most recently, or heapNO_WATERMARK_EVENT if there is none or the
+ * scheduler has not been started.  Must be called with the heap locked.
+ */
+    static BaseType_t prvTakeWatermarkEvent( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Defer the watermark callback for an event returned by prvTakeWatermarkEvent()
+ * to the timer service task.  Must be called with the heap unlocked.
+ */
+    static void prvSendWatermarkEvent( BaseType_t xWatermarkEvent ) PRIVILEGED_FUNCTION;
+
+/*
+ * The function run by the timer service task to call the watermark callback.
+ */
+    static void prvWatermarkCallback( void * pvParameter1,
+                                      uint32_t ulParameter2 ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configHEAP_USE_SHRINKERS == 1 )
+
+/*
+ * Call the registered shrinkers until they have freed at least xWantedSize
+ * bytes.  Returns pdTRUE if they freed any memory.
+ */
+    static BaseType_t prvRunShrinkers( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* The size of the structure placed at the beginning of each allocated memory
@@ -150,19 +361,188 @@ static size_t xMinimumEverFreeBytesRemaining = 0U;
 static size_t xNumberOfSuccessfulAllocations = 0;
 static size_t xNumberOfSuccessfulFrees = 0;
 
+#if ( configHEAP_MAX_REGIONS > 0 )
+
+/* The start address and the address of the end marker of each region, in the
+ * order the regions were passed to vPortDefineHeapRegions(). */
+    static size_t xRegionStartAddresses[ configHEAP_MAX_REGIONS ];
+    static size_t xRegionEndAddresses[ configHEAP_MAX_REGIONS ];
+    static BaseType_t xNumberOfRegions = 0;
+#endif
+
+#if ( configHEAP_HISTOGRAM_BUCKETS > 0 )
+
+/* The number and total size of the free blocks in each histogram bucket. */
+    static size_t xHistogramFreeBlocks[ configHEAP_HISTOGRAM_BUCKETS ] = { 0U };
+    static size_t xHistogramFreeBytes[ configHEAP_HISTOGRAM_BUCKETS ] = { 0U };
+#endif
+
+#if ( configHEAP_USE_CRITICAL_SECTIONS == 1 )
+
+/* Incremented each time a block is added to or removed from the list of free
+ * blocks, so a walk that left its critical section can tell whether the blocks
+ * it has reached are still valid. */
+    static UBaseType_t uxFreeListChanges = 0U;
+#endif
+
+#if ( configHEAP_USE_WATERMARKS == 1 )
+
+/* The watermarks and the function called when they are crossed, whether the
+ * free heap space is below the low watermark, and whether the callback still
+ * has to be deferred to the timer service task. */
+    static size_t xHeapLowWatermark = 0U;
+    static size_t xHeapHighWatermark = 0U;
+    static HeapWatermarkCallback_t pxWatermarkCallback = NULL;
+    static BaseType_t xBelowLowWatermark = pdFALSE;
+    static BaseType_t xWatermarkEventPending = pdFALSE;
+#endif
+
+#if ( configHEAP_USE_SHRINKERS == 1 )
+
+/* The registered shrinkers, in the order they were registered, whether a task
+ * is running them, and the task that is running them. */
+    static HeapShrinker_t * pxShrinkers = NULL;
+    static volatile BaseType_t xShrinkersRunning = pdFALSE;
+    static TaskHandle_t xShrinkerTask = NULL;
+#endif
+
 /*-----------------------------------------------------------*/
 
 void * pvPortMalloc( size_t xWantedSize )
+{
+    void * pvReturn;
+
+    pvReturn = prvHeapAllocate( xWantedSize, ( size_t ) portBYTE_ALIGNMENT, heapANY_REGION, pdFALSE );
+    heapSET_CALL_SITE( pvReturn );
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_ALIGNED_HEAP_ALLOCATION == 1 )
+
+    void * pvPortMallocAligned( size_t xWantedSize,
+                                size_t xAlignment )
+    {
+        void * pvReturn;
+
+        /* The alignment must be a power of two. */
+        configASSERT( ( xAlignment != ( size_t ) 0 ) && ( ( xAlignment & ( xAlignment - ( size_t ) 1 ) ) == ( size_t ) 0 ) );
+
+        if( xAlignment < ( size_t ) portBYTE_ALIGNMENT )
+        {
+            xAlignment = ( size_t ) portBYTE_ALIGNMENT;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pvReturn = prvHeapAllocate( xWantedSize, xAlignment, heapANY_REGION, pdFALSE );
+        heapSET_CALL_SITE( pvReturn );
+
+        return pvReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortFreeAligned( void * pv )
+    {
+        /* An aligned block is a heap block in its own right, with its
+         * BlockLink_t structure immediately before it, so is freed in the same
+         * way. */
+        vPortFree( pv );
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_ALIGNED_HEAP_ALLOCATION */
+
+#if ( configHEAP_MAX_REGIONS > 0 )
+
+    void * pvPortMallocFromRegion( size_t xWantedSize,
+                                   BaseType_t xRegion )
+    {
+        void * pvReturn;
+
+        configASSERT( ( xRegion >= 0 ) && ( xRegion < xNumberOfRegions ) );
+
+        pvReturn = prvHeapAllocate( xWantedSize, ( size_t ) portBYTE_ALIGNMENT, xRegion, pdFALSE );
+        heapSET_CALL_SITE( pvReturn );
+
+        return pvReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void * pvPortMallocFromPreferredRegion( size_t xWantedSize,
+                                            BaseType_t xRegion )
+    {
+        void * pvReturn;
+
+        configASSERT( ( xRegion >= 0 ) && ( xRegion < xNumberOfRegions ) );
+
+        pvReturn = prvHeapAllocate( xWantedSize, ( size_t ) portBYTE_ALIGNMENT, xRegion, pdTRUE );
+        heapSET_CALL_SITE( pvReturn );
+
+        return pvReturn;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configHEAP_MAX_REGIONS */
+
+static void * prvHeapAllocate( size_t xWantedSize,
+                               size_t xAlignment,
+                               BaseType_t xRegion,
+                               BaseType_t xFallBackToAnyRegion )
+{
+    void * pvReturn;
+
+    pvReturn = prvAllocateFromFreeList( xWantedSize, xAlignment, xRegion, xFallBackToAnyRegion );
+
+    #if ( configHEAP_USE_SHRINKERS == 1 )
+    {
+        /* Ask the shrinkers to free memory, or wait for another task that is
+         * already running them, and try again for as long as memory is freed,
+         * before reporting that the allocation failed. */
+        while( ( pvReturn == NULL ) && ( xWantedSize > ( size_t ) 0 ) && ( prvRunShrinkers( xWantedSize ) != pdFALSE ) )
+        {
+            pvReturn = prvAllocateFromFreeList( xWantedSize, xAlignment, xRegion, xFallBackToAnyRegion );
+        }
+    }
+    #endif /* configHEAP_USE_SHRINKERS */
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if( pvReturn == NULL )
+        {
+            extern void vApplicationMallocFailedHook( void );
+            vApplicationMallocFailedHook();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* if ( configUSE_MALLOC_FAILED_HOOK == 1 ) */
+
+    configASSERT( ( ( ( size_t ) pvReturn ) & ( xAlignment - ( size_t ) 1 ) ) == 0 );
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void * prvAllocateFromFreeList( size_t xWantedSize,
+                                       size_t xAlignment,
+                                       BaseType_t xRegion,
+                                       BaseType_t xFallBackToAnyRegion )
 {
     BlockLink_t * pxBlock, * pxPreviousBlock, * pxNewBlockLink;
     void * pvReturn = NULL;
-    size_t xAdditionalRequiredSize;
+    size_t xAdditionalRequiredSize, xLeadingBytes;
+    BaseType_t xWatermarkEvent = heapNO_WATERMARK_EVENT;
 
     /* The heap must be initialised before the first call to
      * prvPortMalloc(). */
     configASSERT( pxEnd );
 
-    vTaskSuspendAll();
+    heapLOCK();
     {
         if( xWantedSize > 0 )
         {
@@ -193,28 +573,44 @@ void * pvPortMalloc( size_t xWantedSize )
         {
             if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
             {
-                /* Traverse the list from the start (lowest address) block until
-                 * one of adequate size is found. */
-                pxPreviousBlock = &xStart;
-                pxBlock = xStart.pxNextFreeBlock;
+                pxBlock = prvFindFreeBlock( xWantedSize, xAlignment, xRegion, &pxPreviousBlock, &xLeadingBytes );
 
-                while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != NULL ) )
+                if( ( pxBlock == NULL ) && ( xRegion != heapANY_REGION ) && ( xFallBackToAnyRegion != pdFALSE ) )
                 {
-                    pxPreviousBlock = pxBlock;
-                    pxBlock = pxBlock->pxNextFreeBlock;
+                    pxBlock = prvFindFreeBlock( xWantedSize, xAlignment, heapANY_REGION, &pxPreviousBlock, &xLeadingBytes );
                 }
-
-                /* If the end marker was reached then a block of adequate size
-                 * was not found. */
-                if( pxBlock != pxEnd )
+                else
                 {
-                    /* Return the memory space pointed to - jumping over the
-                     * BlockLink_t structure at its start. */
-                    pvReturn = ( void * ) ( ( ( uint8_t * ) pxPreviousBlock->pxNextFreeBlock ) + xHeapStructSize );
+                    mtCOVERAGE_TEST_MARKER();
+                }
 
+                if( pxBlock != NULL )
+                {
                     /* This block is being returned for use so must be taken out
                      * of the list of free blocks. */
                     pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+                    heapHISTOGRAM_REMOVE_BLOCK( pxBlock->xBlockSize );
+                    heapFREE_LIST_CHANGED();
+
+                    /* If the allocation is aligned to more than
+                     * portBYTE_ALIGNMENT then the bytes before the aligned
+                     * block are returned to the list of free blocks. */
+                    if( xLeadingBytes != ( size_t ) 0 )
+                    {
+                        pxNewBlockLink = pxBlock;
+                        pxBlock = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xLeadingBytes );
+                        pxBlock->xBlockSize = pxNewBlockLink->xBlockSize - xLeadingBytes;
+                        pxNewBlockLink->xBlockSize = xLeadingBytes;
+                        prvInsertBlockIntoFreeList( pxNewBlockLink );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    /* Return the memory space pointed to - jumping over the
+                     * BlockLink_t structure at its start. */
+                    pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
 
                     /* If the block is larger than required it can be split into
                      * two. */
@@ -240,6 +636,7 @@ void * pvPortMalloc( size_t xWantedSize )
                     }
 
                     xFreeBytesRemaining -= pxBlock->xBlockSize;
+                    heapUPDATE_WATERMARKS();
 
                     if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
                     {
@@ -253,6 +650,7 @@ void * pvPortMalloc( size_t xWantedSize )
                     /* The block is being returned - it is allocated and owned
                      * by the application and has no "next" block. */
                     heapALLOCATE_BLOCK( pxBlock );
+                    heapTRACK_ALLOCATION( pxBlock );
                     pxBlock->pxNextFreeBlock = NULL;
                     xNumberOfSuccessfulAllocations++;
                 }
@@ -272,24 +670,122 @@ void * pvPortMalloc( size_t xWantedSize )
         }
 
         traceMALLOC( pvReturn, xWantedSize );
+        heapTAKE_WATERMARK_EVENT( xWatermarkEvent );
     }
-    ( void ) xTaskResumeAll();
+    heapUNLOCK();
 
-    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+    heapSEND_WATERMARK_EVENT( xWatermarkEvent );
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BlockLink_t * prvFindFreeBlock( size_t xWantedSize,
+                                       size_t xAlignment,
+                                       BaseType_t xRegion,
+                                       BlockLink_t ** ppxPreviousBlock,
+                                       size_t * pxLeadingBytes )
+{
+    BlockLink_t * pxBlock, * pxPreviousBlock;
+    size_t xRegionStart = ( size_t ) 0, xRegionEnd = heapSIZE_MAX, xLeadingBytes;
+    UBaseType_t uxSteps = 0U;
+
+    #if ( configHEAP_MAX_REGIONS > 0 )
     {
-        if( pvReturn == NULL )
+        if( xRegion != heapANY_REGION )
         {
-            extern void vApplicationMallocFailedHook( void );
-            vApplicationMallocFailedHook();
+            xRegionStart = xRegionStartAddresses[ xRegion ];
+            xRegionEnd = xRegionEndAddresses[ xRegion ];
         }
         else
         {
             mtCOVERAGE_TEST_MARKER();
         }
     }
-    #endif /* if ( configUSE_MALLOC_FAILED_HOOK == 1 ) */
+    #else
+    {
+        ( void ) xRegion;
+    }
+    #endif /* configHEAP_MAX_REGIONS */
+
+    /* Traverse the list from the start (lowest address) block until one of
+     * adequate size is found within the region.  Free blocks never span more
+     * than one region, and the list is in address order so the search can
+     * stop at the end of the region. */
+    pxPreviousBlock = &xStart;
+    pxBlock = xStart.pxNextFreeBlock;
+    xLeadingBytes = prvLeadingBytes( pxBlock, xWantedSize, xAlignment );
+
+    while( ( ( ( size_t ) pxBlock < xRegionStart ) || ( xLeadingBytes == heapSIZE_MAX ) ) &&
+           ( ( size_t ) pxBlock < xRegionEnd ) &&
+           ( pxBlock->pxNextFreeBlock != NULL ) )
+    {
+        if( heapWALK_MUST_RESTART( uxSteps ) != pdFALSE )
+        {
+            pxPreviousBlock = &xStart;
+            pxBlock = xStart.pxNextFreeBlock;
+        }
+        else
+        {
+            pxPreviousBlock = pxBlock;
+            pxBlock = pxBlock->pxNextFreeBlock;
+        }
 
-    return pvReturn;
+        xLeadingBytes = prvLeadingBytes( pxBlock, xWantedSize, xAlignment );
+    }
+
+    /* If the end marker or the end of the region was reached then a block of
+     * adequate size was not found. */
+    if( ( pxBlock == pxEnd ) || ( ( size_t ) pxBlock >= xRegionEnd ) )
+    {
+        pxBlock = NULL;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    *ppxPreviousBlock = pxPreviousBlock;
+    *pxLeadingBytes = xLeadingBytes;
+
+    return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvLeadingBytes( const BlockLink_t * pxBlock,
+                               size_t xWantedSize,
+                               size_t xAlignment )
+{
+    size_t xLeadingBytes = ( size_t ) 0;
+
+    if( xAlignment > ( size_t ) portBYTE_ALIGNMENT )
+    {
+        /* The number of bytes from the end of the block's BlockLink_t
+         * structure to the next aligned address.  The bytes before the aligned
+         * block become a free block, so there must be enough of them to hold
+         * one. */
+        xLeadingBytes = ( ( size_t ) 0 - ( ( size_t ) pxBlock + xHeapStructSize ) ) & ( xAlignment - ( size_t ) 1 );
+
+        while( ( xLeadingBytes != ( size_t ) 0 ) && ( xLeadingBytes < heapMINIMUM_BLOCK_SIZE ) )
+        {
+            xLeadingBytes += xAlignment;
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( ( xLeadingBytes >= pxBlock->xBlockSize ) || ( ( pxBlock->xBlockSize - xLeadingBytes ) < xWantedSize ) )
+    {
+        xLeadingBytes = heapSIZE_MAX;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xLeadingBytes;
 }
 /*-----------------------------------------------------------*/
 
@@ -297,6 +793,7 @@ void vPortFree( void * pv )
 {
     uint8_t * puc = ( uint8_t * ) pv;
     BlockLink_t * pxLink;
+    BaseType_t xWatermarkEvent = heapNO_WATERMARK_EVENT;
 
     if( pv != NULL )
     {
@@ -323,15 +820,20 @@ void vPortFree( void * pv )
                 }
                 #endif
 
-                vTaskSuspendAll();
+                heapLOCK();
                 {
                     /* Add this block to the list of free blocks. */
                     xFreeBytesRemaining += pxLink->xBlockSize;
+                    heapUPDATE_WATERMARKS();
                     traceFREE( pv, pxLink->xBlockSize );
+                    heapTRACK_FREE( pxLink );
                     prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
                     xNumberOfSuccessfulFrees++;
+                    heapTAKE_WATERMARK_EVENT( xWatermarkEvent );
                 }
-                ( void ) xTaskResumeAll();
+                heapUNLOCK();
+
+                heapSEND_WATERMARK_EVENT( xWatermarkEvent );
             }
             else
             {
@@ -371,51 +873,247 @@ void * pvPortCalloc( size_t xNum,
         {
             ( void ) memset( pv, 0, xNum * xSize );
         }
+
+        heapSET_CALL_SITE( pv );
     }
 
     return pv;
 }
 /*-----------------------------------------------------------*/
 
-static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert )
+void * pvPortRealloc( void * pv,
+                      size_t xWantedSize )
 {
-    BlockLink_t * pxIterator;
-    uint8_t * puc;
+    uint8_t * puc = ( uint8_t * ) pv;
+    BlockLink_t * pxLink, * pxIterator, * pxNewBlockLink;
+    size_t xBlockSize, xAdditionalRequiredSize;
+    void * pvReturn = NULL;
+    BaseType_t xResized = pdFALSE, xWatermarkEvent = heapNO_WATERMARK_EVENT;
+    UBaseType_t uxSteps = 0U;
 
-    /* Iterate through the list until a block is found that has a higher address
-     * than the block being inserted. */
-    for( pxIterator = &xStart; pxIterator->pxNextFreeBlock < pxBlockToInsert; pxIterator = pxIterator->pxNextFreeBlock )
+    if( pv == NULL )
     {
-        /* Nothing to do here, just iterate to the right position. */
+        pvReturn = pvPortMalloc( xWantedSize );
     }
-
-    /* Do the block being inserted, and the block it is being inserted after
-     * make a contiguous block of memory? */
-    puc = ( uint8_t * ) pxIterator;
-
-    if( ( puc + pxIterator->xBlockSize ) == ( uint8_t * ) pxBlockToInsert )
+    else if( xWantedSize == ( size_t ) 0 )
     {
-        pxIterator->xBlockSize += pxBlockToInsert->xBlockSize;
-        pxBlockToInsert = pxIterator;
+        vPortFree( pv );
     }
     else
     {
-        mtCOVERAGE_TEST_MARKER();
-    }
+        /* The memory being resized will have an BlockLink_t structure
+         * immediately before it. */
+        puc -= xHeapStructSize;
+        pxLink = ( void * ) puc;
 
-    /* Do the block being inserted, and the block it is being inserted before
-     * make a contiguous block of memory? */
-    puc = ( uint8_t * ) pxBlockToInsert;
+        configASSERT( heapBLOCK_IS_ALLOCATED( pxLink ) != 0 );
+        configASSERT( pxLink->pxNextFreeBlock == NULL );
 
-    if( ( puc + pxBlockToInsert->xBlockSize ) == ( uint8_t * ) pxIterator->pxNextFreeBlock )
-    {
-        if( pxIterator->pxNextFreeBlock != pxEnd )
+        /* Increase the wanted size in the same way as pvPortMalloc(). */
+        xAdditionalRequiredSize = xHeapStructSize + portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK );
+
+        if( ( heapADD_WILL_OVERFLOW( xWantedSize, xAdditionalRequiredSize ) == 0 ) &&
+            ( heapBLOCK_SIZE_IS_VALID( xWantedSize + xAdditionalRequiredSize ) != 0 ) )
         {
-            /* Form one big block from the two blocks. */
-            pxBlockToInsert->xBlockSize += pxIterator->pxNextFreeBlock->xBlockSize;
-            pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock->pxNextFreeBlock;
-        }
-        else
+            xWantedSize += xAdditionalRequiredSize;
+
+            heapLOCK();
+            {
+                xBlockSize = pxLink->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK;
+
+                if( xWantedSize > xBlockSize )
+                {
+                    /* Find the first free block after the block being resized.
+                     * If it starts where the block ends, and the two together
+                     * are large enough, it is absorbed into the block.  The end
+                     * marker has a size of zero so is never absorbed. */
+                    pxIterator = &xStart;
+
+                    while( pxIterator->pxNextFreeBlock < pxLink )
+                    {
+                        if( heapWALK_MUST_RESTART( uxSteps ) != pdFALSE )
+                        {
+                            pxIterator = &xStart;
+                        }
+                        else
+                        {
+                            pxIterator = pxIterator->pxNextFreeBlock;
+                        }
+                    }
+
+                    pxNewBlockLink = pxIterator->pxNextFreeBlock;
+
+                    if( ( ( puc + xBlockSize ) == ( uint8_t * ) pxNewBlockLink ) &&
+                        ( ( xWantedSize - xBlockSize ) <= pxNewBlockLink->xBlockSize ) )
+                    {
+                        pxIterator->pxNextFreeBlock = pxNewBlockLink->pxNextFreeBlock;
+                        heapHISTOGRAM_REMOVE_BLOCK( pxNewBlockLink->xBlockSize );
+                        heapFREE_LIST_CHANGED();
+                        xFreeBytesRemaining -= pxNewBlockLink->xBlockSize;
+                        xBlockSize += pxNewBlockLink->xBlockSize;
+                        xResized = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    /* The block is already large enough. */
+                    xResized = pdTRUE;
+                }
+
+                if( xResized != pdFALSE )
+                {
+                    /* If the block is now larger than required then the surplus
+                     * is split off and returned to the list of free blocks, where
+                     * it is merged with any free block that follows it. */
+                    if( ( xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
+                    {
+                        pxNewBlockLink = ( void * ) ( puc + xWantedSize );
+                        pxNewBlockLink->xBlockSize = xBlockSize - xWantedSize;
+                        xBlockSize = xWantedSize;
+
+                        #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+                        {
+                            ( void ) memset( ( ( uint8_t * ) pxNewBlockLink ) + xHeapStructSize, 0, pxNewBlockLink->xBlockSize - xHeapStructSize );
+                        }
+                        #endif
+
+                        xFreeBytesRemaining += pxNewBlockLink->xBlockSize;
+                        prvInsertBlockIntoFreeList( pxNewBlockLink );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                    {
+                        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    heapUPDATE_WATERMARKS();
+                    heapTRACK_FREE( pxLink );
+                    pxLink->xBlockSize = xBlockSize;
+                    heapALLOCATE_BLOCK( pxLink );
+                    heapTRACK_ALLOCATION( pxLink );
+                    pvReturn = pv;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                heapTAKE_WATERMARK_EVENT( xWatermarkEvent );
+            }
+            heapUNLOCK();
+
+            heapSEND_WATERMARK_EVENT( xWatermarkEvent );
+
+            if( xResized == pdFALSE )
+            {
+                /* The block could not be resized in place, so is moved to a new
+                 * block that is large enough.  The original block is only freed
+                 * if the new block is allocated. */
+                pvReturn = pvPortMalloc( xWantedSize - xAdditionalRequiredSize ); /* The size that was requested. */
+
+                if( pvReturn != NULL )
+                {
+                    /* Copy no more than the old block holds or the new block
+                     * can take. */
+                    xBlockSize -= xHeapStructSize;
+
+                    if( xBlockSize > ( xWantedSize - xAdditionalRequiredSize ) )
+                    {
+                        xBlockSize = xWantedSize - xAdditionalRequiredSize;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    ( void ) memcpy( pvReturn, pv, xBlockSize );
+                    vPortFree( pv );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        heapSET_CALL_SITE( pvReturn );
+    }
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert )
+{
+    BlockLink_t * pxIterator;
+    uint8_t * puc;
+    UBaseType_t uxSteps = 0U;
+
+    /* Iterate through the list until a block is found that has a higher address
+     * than the block being inserted. */
+    pxIterator = &xStart;
+
+    while( pxIterator->pxNextFreeBlock < pxBlockToInsert )
+    {
+        if( heapWALK_MUST_RESTART( uxSteps ) != pdFALSE )
+        {
+            pxIterator = &xStart;
+        }
+        else
+        {
+            pxIterator = pxIterator->pxNextFreeBlock;
+        }
+    }
+
+    /* Do the block being inserted, and the block it is being inserted after
+     * make a contiguous block of memory? */
+    puc = ( uint8_t * ) pxIterator;
+
+    if( ( puc + pxIterator->xBlockSize ) == ( uint8_t * ) pxBlockToInsert )
+    {
+        heapHISTOGRAM_REMOVE_BLOCK( pxIterator->xBlockSize );
+        pxIterator->xBlockSize += pxBlockToInsert->xBlockSize;
+        pxBlockToInsert = pxIterator;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    /* Do the block being inserted, and the block it is being inserted before
+     * make a contiguous block of memory? */
+    puc = ( uint8_t * ) pxBlockToInsert;
+
+    if( ( puc + pxBlockToInsert->xBlockSize ) == ( uint8_t * ) pxIterator->pxNextFreeBlock )
+    {
+        if( pxIterator->pxNextFreeBlock != pxEnd )
+        {
+            /* Form one big block from the two blocks. */
+            heapHISTOGRAM_REMOVE_BLOCK( pxIterator->pxNextFreeBlock->xBlockSize );
+            pxBlockToInsert->xBlockSize += pxIterator->pxNextFreeBlock->xBlockSize;
+            pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock->pxNextFreeBlock;
+        }
+        else
         {
             pxBlockToInsert->pxNextFreeBlock = pxEnd;
         }
@@ -425,6 +1123,8 @@ static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert )
         pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock;
     }
 
+    heapHISTOGRAM_ADD_BLOCK( pxBlockToInsert->xBlockSize );
+
     /* If the block being inserted plugged a gab, so was merged with the block
      * before and the block after, then it's pxNextFreeBlock pointer will have
      * already been set, and should not be set here as that would make it point
@@ -437,6 +1137,8 @@ static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert )
     {
         mtCOVERAGE_TEST_MARKER();
     }
+
+    heapFREE_LIST_CHANGED();
 }
 /*-----------------------------------------------------------*/
 
@@ -509,6 +1211,7 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
         pxFirstFreeBlockInRegion = ( BlockLink_t * ) xAlignedHeap;
         pxFirstFreeBlockInRegion->xBlockSize = xAddress - ( size_t ) pxFirstFreeBlockInRegion;
         pxFirstFreeBlockInRegion->pxNextFreeBlock = pxEnd;
+        heapHISTOGRAM_ADD_BLOCK( pxFirstFreeBlockInRegion->xBlockSize );
 
         /* If this is not the first region that makes up the entire heap space
          * then link the previous region to this region. */
@@ -517,6 +1220,25 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
             pxPreviousFreeBlock->pxNextFreeBlock = pxFirstFreeBlockInRegion;
         }
 
+        #if ( configHEAP_MAX_REGIONS > 0 )
+        {
+            /* Record where the region is so pvPortMallocFromRegion() can find
+             * the free blocks within it. */
+            configASSERT( xDefinedRegions < ( BaseType_t ) configHEAP_MAX_REGIONS );
+
+            if( xDefinedRegions < ( BaseType_t ) configHEAP_MAX_REGIONS )
+            {
+                xRegionStartAddresses[ xDefinedRegions ] = xAlignedHeap;
+                xRegionEndAddresses[ xDefinedRegions ] = xAddress;
+                xNumberOfRegions = xDefinedRegions + 1;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configHEAP_MAX_REGIONS */
+
         xTotalHeapSize += pxFirstFreeBlockInRegion->xBlockSize;
 
         /* Move onto the next HeapRegion_t structure. */
@@ -536,8 +1258,9 @@ void vPortGetHeapStats( HeapStats_t * pxHeapStats )
 {
     BlockLink_t * pxBlock;
     size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+    UBaseType_t uxSteps = 0U;
 
-    vTaskSuspendAll();
+    heapLOCK();
     {
         pxBlock = xStart.pxNextFreeBlock;
 
@@ -569,11 +1292,21 @@ void vPortGetHeapStats( HeapStats_t * pxHeapStats )
 
                 /* Move to the next block in the chain until the last block is
                  * reached. */
-                pxBlock = pxBlock->pxNextFreeBlock;
+                if( heapWALK_MUST_RESTART( uxSteps ) != pdFALSE )
+                {
+                    xBlocks = 0;
+                    xMaxSize = 0;
+                    xMinSize = portMAX_DELAY;
+                    pxBlock = xStart.pxNextFreeBlock;
+                }
+                else
+                {
+                    pxBlock = pxBlock->pxNextFreeBlock;
+                }
             } while( pxBlock != pxEnd );
         }
     }
-    ( void ) xTaskResumeAll();
+    heapUNLOCK();
 
     pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
     pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
@@ -589,3 +1322,534 @@ void vPortGetHeapStats( HeapStats_t * pxHeapStats )
     taskEXIT_CRITICAL();
 }
 /*-----------------------------------------------------------*/
+
+#if ( configHEAP_HISTOGRAM_BUCKETS > 0 )
+
+    void vPortGetHeapHistogram( HeapHistogram_t * pxHeapHistogram )
+    {
+        UBaseType_t uxBucket;
+        size_t xTotal, xLargest = 0U;
+
+        configASSERT( pxHeapHistogram );
+
+        heapLOCK();
+        {
+            for( uxBucket = 0U; uxBucket < ( UBaseType_t ) configHEAP_HISTOGRAM_BUCKETS; uxBucket++ )
+            {
+                pxHeapHistogram->xNumberOfFreeBlocks[ uxBucket ] = xHistogramFreeBlocks[ uxBucket ];
+                pxHeapHistogram->xFreeBytes[ uxBucket ] = xHistogramFreeBytes[ uxBucket ];
+
+                if( xHistogramFreeBlocks[ uxBucket ] != 0U )
+                {
+                    xLargest = xHistogramFreeBytes[ uxBucket ];
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            pxHeapHistogram->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        }
+        heapUNLOCK();
+
+        /* The fragmentation index is the percentage of the free bytes that are
+         * not in the highest non-empty bucket.  Scale both values down first
+         * if multiplying by 100 could overflow. */
+        xTotal = pxHeapHistogram->xAvailableHeapSpaceInBytes;
+
+        while( xTotal > ( heapSIZE_MAX / ( size_t ) 100 ) )
+        {
+            xTotal >>= 1;
+            xLargest >>= 1;
+        }
+
+        if( xTotal != 0U )
+        {
+            pxHeapHistogram->uxFragmentationIndex = ( UBaseType_t ) ( ( ( xTotal - xLargest ) * ( size_t ) 100 ) / xTotal );
+        }
+        else
+        {
+            pxHeapHistogram->uxFragmentationIndex = 0U;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvHistogramAddBlock( size_t xBlockSize ) /* PRIVILEGED_FUNCTION */
+    {
+        UBaseType_t uxBucket;
+
+        /* The zero sized markers at the end of each region are not counted. */
+        if( xBlockSize != 0U )
+        {
+            uxBucket = prvHistogramBucket( xBlockSize );
+            xHistogramFreeBlocks[ uxBucket ]++;
+            xHistogramFreeBytes[ uxBucket ] += xBlockSize;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvHistogramRemoveBlock( size_t xBlockSize ) /* PRIVILEGED_FUNCTION */
+    {
+        UBaseType_t uxBucket;
+
+        if( xBlockSize != 0U )
+        {
+            uxBucket = prvHistogramBucket( xBlockSize );
+            configASSERT( xHistogramFreeBlocks[ uxBucket ] != 0U );
+            xHistogramFreeBlocks[ uxBucket ]--;
+            xHistogramFreeBytes[ uxBucket ] -= xBlockSize;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static UBaseType_t prvHistogramBucket( size_t xBlockSize ) /* PRIVILEGED_FUNCTION */
+    {
+        UBaseType_t uxBucket = 0U;
+        uint32_t ulValue;
+
+        /* Blocks too large for the last bucket are counted in it. */
+        if( xBlockSize >= ( ( size_t ) 1U << ( configHEAP_HISTOGRAM_BUCKETS - 1 ) ) )
+        {
+            uxBucket = ( UBaseType_t ) configHEAP_HISTOGRAM_BUCKETS - 1U;
+        }
+        else
+        {
+            /* Find the most significant set bit with a binary search, which
+             * takes the same number of steps for any size. */
+            ulValue = ( uint32_t ) xBlockSize;
+
+            if( ( ulValue & 0xFFFF0000UL ) != 0UL )
+            {
+                ulValue >>= 16;
+                uxBucket += 16U;
+            }
+
+            if( ( ulValue & 0xFF00UL ) != 0UL )
+            {
+                ulValue >>= 8;
+                uxBucket += 8U;
+            }
+
+            if( ( ulValue & 0xF0UL ) != 0UL )
+            {
+                ulValue >>= 4;
+                uxBucket += 4U;
+            }
+
+            if( ( ulValue & 0xCUL ) != 0UL )
+            {
+                ulValue >>= 2;
+                uxBucket += 2U;
+            }
+
+            if( ( ulValue & 0x2UL ) != 0UL )
+            {
+                uxBucket += 1U;
+            }
+        }
+
+        return uxBucket;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configHEAP_HISTOGRAM_BUCKETS */
+
+#if ( configHEAP_TRACK_TASK_ALLOCATIONS == 1 )
+
+    UBaseType_t uxPortGetHeapAllocations( HeapAllocation_t * const pxAllocations,
+                                          const UBaseType_t uxArraySize )
+    {
+        BlockLink_t * pxBlock;
+        BaseType_t xRegion;
+        UBaseType_t uxAllocations = 0;
+        UBaseType_t uxSteps = 0U;
+
+        heapLOCK();
+        {
+            /* Every byte of the heap is in a block, so the blocks can be walked
+             * in address order by adding each block's size to its address. */
+            for( xRegion = 0; xRegion < xNumberOfRegions; xRegion++ )
+            {
+                pxBlock = ( BlockLink_t * ) xRegionStartAddresses[ xRegion ];
+
+                while( ( size_t ) pxBlock < xRegionEndAddresses[ xRegion ] )
+                {
+                    if( heapBLOCK_IS_ALLOCATED( pxBlock ) != 0 )
+                    {
+                        if( uxAllocations < uxArraySize )
+                        {
+                            pxAllocations[ uxAllocations ].pvAddress = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+                            pxAllocations[ uxAllocations ].xSizeInBytes = pxBlock->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK;
+                            pxAllocations[ uxAllocations ].xOwner = pxBlock->xOwner;
+
+                            #ifdef configHEAP_CALL_SITE
+                            {
+                                pxAllocations[ uxAllocations ].pvCallSite = pxBlock->pvCallSite;
+                            }
+                            #else
+                            {
+                                pxAllocations[ uxAllocations ].pvCallSite = NULL;
+                            }
+                            #endif
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+
+                        uxAllocations++;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    if( heapWALK_MUST_RESTART( uxSteps ) != pdFALSE )
+                    {
+                        /* Start again from the first region. */
+                        uxAllocations = 0;
+                        xRegion = 0;
+                        pxBlock = ( BlockLink_t * ) xRegionStartAddresses[ 0 ];
+                    }
+                    else
+                    {
+                        pxBlock = heapNEXT_BLOCK( pxBlock );
+                    }
+                }
+            }
+        }
+        heapUNLOCK();
+
+        return uxAllocations;
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortHeapDisownTask( TaskHandle_t xTask )
+    {
+        BlockLink_t * pxBlock;
+        BaseType_t xRegion;
+        UBaseType_t uxSteps = 0U;
+
+        heapLOCK();
+        {
+            for( xRegion = 0; xRegion < xNumberOfRegions; xRegion++ )
+            {
+                pxBlock = ( BlockLink_t * ) xRegionStartAddresses[ xRegion ];
+
+                while( ( size_t ) pxBlock < xRegionEndAddresses[ xRegion ] )
+                {
+                    if( ( heapBLOCK_IS_ALLOCATED( pxBlock ) != 0 ) && ( pxBlock->xOwner == xTask ) )
+                    {
+                        pxBlock->xOwner = NULL;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    if( heapWALK_MUST_RESTART( uxSteps ) != pdFALSE )
+                    {
+                        /* Start again from the first region. */
+                        xRegion = 0;
+                        pxBlock = ( BlockLink_t * ) xRegionStartAddresses[ 0 ];
+                    }
+                    else
+                    {
+                        pxBlock = heapNEXT_BLOCK( pxBlock );
+                    }
+                }
+            }
+        }
+        heapUNLOCK();
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configHEAP_TRACK_TASK_ALLOCATIONS */
+
+#if ( ( configHEAP_TRACK_TASK_ALLOCATIONS == 1 ) && defined( configHEAP_CALL_SITE ) )
+
+    static void prvSetCallSite( void * pv,
+                                void * pvCallSite )
+    {
+        BlockLink_t * pxLink;
+
+        if( pv != NULL )
+        {
+            /* The block belongs to the caller, so can be updated without
+             * locking the heap. */
+            pxLink = ( void * ) ( ( ( uint8_t * ) pv ) - xHeapStructSize );
+            pxLink->pvCallSite = pvCallSite;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( configHEAP_TRACK_TASK_ALLOCATIONS == 1 ) && defined( configHEAP_CALL_SITE ) */
+
+#if ( configHEAP_USE_CRITICAL_SECTIONS == 1 )
+
+    static BaseType_t prvHeapWalkStep( UBaseType_t * puxSteps ) /* PRIVILEGED_FUNCTION */
+    {
+        BaseType_t xRestart = pdFALSE;
+        UBaseType_t uxChanges;
+
+        ( *puxSteps )++;
+
+        if( *puxSteps >= ( UBaseType_t ) configHEAP_CRITICAL_SECTION_BLOCKS )
+        {
+            *puxSteps = 0U;
+            uxChanges = uxFreeListChanges;
+
+            /* Let any pending interrupt, or a task that it unblocked, run
+             * before the walk continues. */
+            taskEXIT_CRITICAL();
+            taskENTER_CRITICAL();
+
+            if( uxChanges != uxFreeListChanges )
+            {
+                xRestart = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xRestart;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configHEAP_USE_CRITICAL_SECTIONS */
+
+#if ( configHEAP_USE_WATERMARKS == 1 )
+
+    void vPortSetHeapWatermarks( size_t xLowWatermark,
+                                 size_t xHighWatermark,
+                                 HeapWatermarkCallback_t pxCallback )
+    {
+        configASSERT( xLowWatermark <= xHighWatermark );
+
+        /* The watermarks are next checked when the free heap space changes. */
+        heapLOCK();
+        {
+            xHeapLowWatermark = xLowWatermark;
+            xHeapHighWatermark = xHighWatermark;
+            pxWatermarkCallback = pxCallback;
+            xBelowLowWatermark = pdFALSE;
+            xWatermarkEventPending = pdFALSE;
+        }
+        heapUNLOCK();
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvUpdateWatermarks( void ) /* PRIVILEGED_FUNCTION */
+    {
+        if( pxWatermarkCallback != NULL )
+        {
+            if( ( xBelowLowWatermark == pdFALSE ) && ( xFreeBytesRemaining < xHeapLowWatermark ) )
+            {
+                xBelowLowWatermark = pdTRUE;
+                xWatermarkEventPending = pdTRUE;
+            }
+            else if( ( xBelowLowWatermark != pdFALSE ) && ( xFreeBytesRemaining >= xHeapHighWatermark ) )
+            {
+                xBelowLowWatermark = pdFALSE;
+                xWatermarkEventPending = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvTakeWatermarkEvent( void ) /* PRIVILEGED_FUNCTION */
+    {
+        BaseType_t xWatermarkEvent = heapNO_WATERMARK_EVENT;
+
+        /* The timer service task does not exist until the scheduler has been
+         * started, so until then the event is left pending. */
+        if( ( xWatermarkEventPending != pdFALSE ) && ( xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED ) )
+        {
+            /* Only the watermark crossed most recently is reported. */
+            xWatermarkEventPending = pdFALSE;
+
+            if( xBelowLowWatermark != pdFALSE )
+            {
+                xWatermarkEvent = ( BaseType_t ) eHeapLowWatermark;
+            }
+            else
+            {
+                xWatermarkEvent = ( BaseType_t ) eHeapHighWatermark;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xWatermarkEvent;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvSendWatermarkEvent( BaseType_t xWatermarkEvent ) /* PRIVILEGED_FUNCTION */
+    {
+        if( xWatermarkEvent != heapNO_WATERMARK_EVENT )
+        {
+            /* Do not block, as the heap may be in use by the timer service task
+             * itself or with the scheduler suspended.  If the timer command
+             * queue is full the event is sent the next time the heap is used. */
+            if( xTimerPendFunctionCall( prvWatermarkCallback, NULL, ( uint32_t ) xWatermarkEvent, ( TickType_t ) 0 ) == pdFAIL )
+            {
+                heapLOCK();
+                {
+                    xWatermarkEventPending = pdTRUE;
+                }
+                heapUNLOCK();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvWatermarkCallback( void * pvParameter1,
+                                      uint32_t ulParameter2 ) /* PRIVILEGED_FUNCTION */
+    {
+        const HeapWatermarkCallback_t pxCallback = pxWatermarkCallback;
+
+        ( void ) pvParameter1;
+
+        /* The callback may have been removed since the event was sent. */
+        if( pxCallback != NULL )
+        {
+            pxCallback( ( eHeapWatermark ) ulParameter2 );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configHEAP_USE_WATERMARKS */
+
+#if ( configHEAP_USE_SHRINKERS == 1 )
+
+    void vPortRegisterHeapShrinker( HeapShrinker_t * const pxShrinker,
+                                    HeapShrinkerFunction_t pxShrinkFunction )
+    {
+        HeapShrinker_t ** ppxLink;
+
+        configASSERT( pxShrinker );
+        configASSERT( pxShrinkFunction );
+
+        pxShrinker->pxShrink = pxShrinkFunction;
+        pxShrinker->pxNext = NULL;
+
+        taskENTER_CRITICAL();
+        {
+            /* Add the shrinker to the end of the list, so shrinkers are called
+             * in the order they were registered. */
+            for( ppxLink = &pxShrinkers; *ppxLink != NULL; ppxLink = &( ( *ppxLink )->pxNext ) )
+            {
+                /* There is nothing to do here, just iterate to the end of the
+                 * list. */
+            }
+
+            *ppxLink = pxShrinker;
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvRunShrinkers( size_t xWantedSize ) /* PRIVILEGED_FUNCTION */
+    {
+        HeapShrinker_t * pxShrinker;
+        size_t xBytesFreed = 0U;
+        BaseType_t xRunShrinkers, xReturn = pdFALSE;
+
+        /* Only one task runs the shrinkers at a time, which also stops a
+         * shrinker that allocates memory calling itself. */
+        taskENTER_CRITICAL();
+        {
+            xRunShrinkers = ( xShrinkersRunning == pdFALSE ) ? pdTRUE : pdFALSE;
+
+            if( xRunShrinkers != pdFALSE )
+            {
+                xShrinkersRunning = pdTRUE;
+                xShrinkerTask = xTaskGetCurrentTaskHandle();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xRunShrinkers != pdFALSE )
+        {
+            for( pxShrinker = pxShrinkers; ( pxShrinker != NULL ) && ( xBytesFreed < xWantedSize ); pxShrinker = pxShrinker->pxNext )
+            {
+                xBytesFreed += pxShrinker->pxShrink( xWantedSize - xBytesFreed );
+            }
+
+            xReturn = ( xBytesFreed > 0U ) ? pdTRUE : pdFALSE;
+
+            taskENTER_CRITICAL();
+            {
+                xShrinkerTask = NULL;
+                xShrinkersRunning = pdFALSE;
+            }
+            taskEXIT_CRITICAL();
+        }
+        else if( ( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING ) && ( xShrinkerTask != xTaskGetCurrentTaskHandle() ) )
+        {
+            /* Another task is running the shrinkers.  The memory they free may
+             * satisfy this allocation too, so wait for them to finish and then
+             * retry it.  The wait is not possible with the scheduler suspended,
+             * and a shrinker that allocates memory must not wait for itself. */
+            while( xShrinkersRunning != pdFALSE )
+            {
+                vTaskDelay( ( TickType_t ) 1 );
+            }
+
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configHEAP_USE_SHRINKERS */
@@ -0,0 +1,768 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A sample implementation of pvPortMalloc() and vPortFree() that uses a Two
+ * Level Segregated Fit (TLSF) allocator, so both functions execute in constant
+ * time however fragmented the heap is.  Like heap_5.c the heap can be defined
+ * across multiple non-contiguous blocks of memory, and adjacent memory blocks
+ * are combined (coalesced) as they are freed.
+ *
+ * See heap_1.c, heap_2.c, heap_3.c, heap_4.c and heap_5.c for alternative
+ * implementations, and the memory management pages of https://www.FreeRTOS.org
+ * for more information.
+ *
+ * Free blocks are held in lists segregated by size.  The first level divides
+ * block sizes into powers of two, and the second level divides each power of
+ * two into heapSL_INDEX_COUNT equal ranges.  A bitmap records which lists are
+ * not empty, so the smallest list that is guaranteed to hold a large enough
+ * block is found with a couple of bit scans rather than by walking a list.
+ * Because a block is taken from a list in which every block is large enough,
+ * rather than from the list in which a block of exactly the right size might
+ * be found, some fragmentation is traded for determinism - the memory wasted is
+ * bounded by the size of one second level range.
+ *
+ * Usage notes:
+ *
+ * vPortDefineHeapRegions() ***must*** be called before pvPortMalloc(), exactly
+ * as when heap_5.c is used - see heap_5.c for an example.  Unlike heap_5.c the
+ * regions can be listed in any address order.
+ *
+ * Blocks of configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2 bytes or more cannot be
+ * allocated.  The number of free lists, and therefore the RAM used by the
+ * allocator itself, grows with configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2, so it can
+ * be reduced to match the size of the heap.  A heap region that is larger than
+ * the maximum block size is divided into several blocks that are never
+ * combined.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#ifndef configHEAP_CLEAR_MEMORY_ON_FREE
+    #define configHEAP_CLEAR_MEMORY_ON_FREE    0
+#endif
+
+/* Blocks must be smaller than 2 to the power of this value. */
+#ifndef configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2
+    #define configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2    24
+#endif
+
+/* The number of second level free lists for each first level free list, as a
+ * power of two. */
+#define heapSL_INDEX_COUNT_LOG2    ( 4U )
+#define heapSL_INDEX_COUNT         ( 1U << heapSL_INDEX_COUNT_LOG2 )
+
+/* Blocks smaller than heapSMALL_BLOCK_SIZE are all held in the first first
+ * level list, which is divided linearly rather than by powers of two. */
+#define heapFL_INDEX_SHIFT         ( heapSL_INDEX_COUNT_LOG2 + 3U )
+#define heapSMALL_BLOCK_SIZE       ( ( size_t ) 1 << heapFL_INDEX_SHIFT )
+#define heapFL_INDEX_COUNT         ( configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2 - heapFL_INDEX_SHIFT + 1U )
+
+/* All blocks are smaller than this, so their sizes fit in the bitmaps. */
+#define heapMAXIMUM_BLOCK_SIZE     ( ( size_t ) 1 << configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2 )
+
+#if ( ( configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2 <= ( heapSL_INDEX_COUNT_LOG2 + 3U ) ) || ( configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2 > 31 ) )
+    #error configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2 must be between 8 and 31.
+#endif
+
+/* Block sizes must not get too small. */
+#define heapMINIMUM_BLOCK_SIZE    ( ( size_t ) ( ( sizeof( BlockLink_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) ) )
+
+/* Assumes 8bit bytes! */
+#define heapBITS_PER_BYTE         ( ( size_t ) 8 )
+
+/* Max value that fits in a size_t type. */
+#define heapSIZE_MAX              ( ~( ( size_t ) 0 ) )
+
+/* Check if multiplying a and b will result in overflow. */
+#define heapMULTIPLY_WILL_OVERFLOW( a, b )    ( ( ( a ) > 0 ) && ( ( b ) > ( heapSIZE_MAX / ( a ) ) ) )
+
+/* Check if adding a and b will result in overflow. */
+#define heapADD_WILL_OVERFLOW( a, b )         ( ( a ) > ( heapSIZE_MAX - ( b ) ) )
+
+/* MSB of the xBlockSize member of an BlockLink_t structure is used to track
+ * the allocation status of a block.  When MSB of the xBlockSize member of
+ * an BlockLink_t structure is set then the block belongs to the application.
+ * When the bit is free the block is still part of the free heap space. */
+#define heapBLOCK_ALLOCATED_BITMASK    ( ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 ) )
+#define heapBLOCK_IS_ALLOCATED( pxBlock )        ( ( ( pxBlock->xBlockSize ) & heapBLOCK_ALLOCATED_BITMASK ) != 0 )
+#define heapALLOCATE_BLOCK( pxBlock )            ( ( pxBlock->xBlockSize ) |= heapBLOCK_ALLOCATED_BITMASK )
+#define heapFREE_BLOCK( pxBlock )                ( ( pxBlock->xBlockSize ) &= ~heapBLOCK_ALLOCATED_BITMASK )
+#define heapBLOCK_SIZE( pxBlock )                ( ( pxBlock->xBlockSize ) & ~heapBLOCK_ALLOCATED_BITMASK )
+
+/* The block that follows a block in memory. */
+#define heapNEXT_PHYSICAL_BLOCK( pxBlock )       ( ( BlockLink_t * ) ( ( ( uint8_t * ) ( pxBlock ) ) + heapBLOCK_SIZE( ( pxBlock ) ) ) )
+
+/*-----------------------------------------------------------*/
+
+/* Define the structure placed at the start of each block.  The first two
+ * members are present in every block.  The free list links are only used while
+ * the block is free, so are overwritten by the application's data when the
+ * block is allocated. */
+typedef struct A_BLOCK_LINK
+{
+    struct A_BLOCK_LINK * pxPreviousPhysicalBlock; /*<< The block before this block in memory, or NULL if this is the first block in its region. */
+    size_t xBlockSize;                             /*<< The size of the block, including this structure. */
+    struct A_BLOCK_LINK * pxNextFreeBlock;         /*<< The next block in the same free list. */
+    struct A_BLOCK_LINK * pxPreviousFreeBlock;     /*<< The previous block in the same free list. */
+} BlockLink_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the bit number of the most significant bit that is set in ulValue,
+ * which must not be zero.
+ */
+static UBaseType_t prvFindLastSet( uint32_t ulValue ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the indexes of the first level and second level free lists that hold
+ * blocks of xBlockSize bytes.
+ */
+static void prvMapBlockSize( size_t xBlockSize,
+                             UBaseType_t * puxFirstLevel,
+                             UBaseType_t * puxSecondLevel ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns a free block of at least xWantedSize bytes without removing it from
+ * its free list, or NULL if there is no such block.
+ */
+static BlockLink_t * prvFindFreeBlock( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Insert a block into, and remove a block from, the free list for its size.
+ */
+static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) PRIVILEGED_FUNCTION;
+static void prvRemoveBlockFromFreeList( BlockLink_t * pxBlockToRemove ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+/* The size of the part of the BlockLink_t structure that is placed at the
+ * beginning of each allocated memory block must by correctly byte aligned. */
+static const size_t xHeapStructSize = ( offsetof( BlockLink_t, pxNextFreeBlock ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* The free lists, and the bitmaps that record which of them are not empty. */
+PRIVILEGED_DATA static BlockLink_t * pxFreeLists[ heapFL_INDEX_COUNT ][ heapSL_INDEX_COUNT ];
+PRIVILEGED_DATA static uint32_t ulFirstLevelBitmap = 0U;
+PRIVILEGED_DATA static uint32_t ulSecondLevelBitmaps[ heapFL_INDEX_COUNT ];
+
+/* Set once vPortDefineHeapRegions() has been called. */
+PRIVILEGED_DATA static BaseType_t xHeapRegionsDefined = pdFALSE;
+
+/* Keeps track of the number of calls to allocate and free memory, the number
+ * of free bytes remaining and the number of free blocks. */
+PRIVILEGED_DATA static size_t xFreeBytesRemaining = 0U;
+PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = 0;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = 0;
+PRIVILEGED_DATA static size_t xNumberOfFreeBlocks = 0;
+
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    BlockLink_t * pxBlock, * pxNewBlockLink;
+    void * pvReturn = NULL;
+
+    /* The heap must be defined before the first call to pvPortMalloc(). */
+    configASSERT( xHeapRegionsDefined != pdFALSE );
+
+    vTaskSuspendAll();
+    {
+        if( xWantedSize > 0 )
+        {
+            /* The wanted size must be increased so it can contain the start of
+             * a BlockLink_t structure in addition to the requested amount of
+             * bytes, then rounded up to keep the next block aligned. */
+            if( heapADD_WILL_OVERFLOW( xWantedSize, xHeapStructSize + portBYTE_ALIGNMENT ) == 0 )
+            {
+                xWantedSize += xHeapStructSize;
+
+                if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+                {
+                    xWantedSize += ( portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK ) );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* The block must be large enough to hold the free list links
+                 * when it is freed. */
+                if( xWantedSize < heapMINIMUM_BLOCK_SIZE )
+                {
+                    xWantedSize = heapMINIMUM_BLOCK_SIZE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                xWantedSize = 0;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* Blocks of heapMAXIMUM_BLOCK_SIZE bytes or more do not exist, which
+         * also ensures the top bit of the size, which is used to determine who
+         * owns the block, is free. */
+        if( ( xWantedSize > 0 ) && ( xWantedSize < heapMAXIMUM_BLOCK_SIZE ) && ( xWantedSize <= xFreeBytesRemaining ) )
+        {
+            pxBlock = prvFindFreeBlock( xWantedSize );
+
+            if( pxBlock != NULL )
+            {
+                /* This block is being returned for use so must be taken out of
+                 * the list of free blocks. */
+                prvRemoveBlockFromFreeList( pxBlock );
+
+                /* If the block is larger than required it can be split into
+                 * two.  The block after it in memory cannot be free, as free
+                 * blocks are always combined, so the new block is not combined
+                 * with anything. */
+                if( ( pxBlock->xBlockSize - xWantedSize ) >= heapMINIMUM_BLOCK_SIZE )
+                {
+                    /* The void cast is used to prevent byte alignment warnings
+                     * from the compiler. */
+                    pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+                    pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+                    pxNewBlockLink->pxPreviousPhysicalBlock = pxBlock;
+                    heapNEXT_PHYSICAL_BLOCK( pxNewBlockLink )->pxPreviousPhysicalBlock = pxNewBlockLink;
+                    pxBlock->xBlockSize = xWantedSize;
+
+                    prvInsertBlockIntoFreeList( pxNewBlockLink );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+                if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                {
+                    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* The block is being returned - it is allocated and owned by
+                 * the application.  Return the memory space pointed to -
+                 * jumping over the start of the BlockLink_t structure. */
+                heapALLOCATE_BLOCK( pxBlock );
+                pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+                xNumberOfSuccessfulAllocations++;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceMALLOC( pvReturn, xWantedSize );
+    }
+    ( void ) xTaskResumeAll();
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if( pvReturn == NULL )
+        {
+            extern void vApplicationMallocFailedHook( void );
+            vApplicationMallocFailedHook();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* if ( configUSE_MALLOC_FAILED_HOOK == 1 ) */
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    uint8_t * puc = ( uint8_t * ) pv;
+    BlockLink_t * pxLink, * pxNeighbour;
+
+    if( pv != NULL )
+    {
+        /* The memory being freed will have the start of a BlockLink_t
+         * structure immediately before it. */
+        puc -= xHeapStructSize;
+
+        /* This casting is to keep the compiler from issuing warnings. */
+        pxLink = ( void * ) puc;
+
+        configASSERT( heapBLOCK_IS_ALLOCATED( pxLink ) != 0 );
+
+        if( heapBLOCK_IS_ALLOCATED( pxLink ) != 0 )
+        {
+            /* The block is being returned to the heap - it is no longer
+             * allocated. */
+            heapFREE_BLOCK( pxLink );
+            #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+            {
+                ( void ) memset( puc + xHeapStructSize, 0, pxLink->xBlockSize - xHeapStructSize );
+            }
+            #endif
+
+            vTaskSuspendAll();
+            {
+                xFreeBytesRemaining += pxLink->xBlockSize;
+                traceFREE( pv, pxLink->xBlockSize );
+
+                /* Combine the block with the block before it in memory, if that
+                 * block is free. */
+                pxNeighbour = pxLink->pxPreviousPhysicalBlock;
+
+                if( ( pxNeighbour != NULL ) && ( heapBLOCK_IS_ALLOCATED( pxNeighbour ) == 0 ) )
+                {
+                    prvRemoveBlockFromFreeList( pxNeighbour );
+                    pxNeighbour->xBlockSize += pxLink->xBlockSize;
+                    pxLink = pxNeighbour;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* Combine the block with the block after it in memory, if that
+                 * block is free.  The last block in each region is a zero sized
+                 * block that is marked as allocated, so is never combined. */
+                pxNeighbour = heapNEXT_PHYSICAL_BLOCK( pxLink );
+
+                if( heapBLOCK_IS_ALLOCATED( pxNeighbour ) == 0 )
+                {
+                    prvRemoveBlockFromFreeList( pxNeighbour );
+                    pxLink->xBlockSize += pxNeighbour->xBlockSize;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                heapNEXT_PHYSICAL_BLOCK( pxLink )->pxPreviousPhysicalBlock = pxLink;
+
+                /* Add this block to the list of free blocks. */
+                prvInsertBlockIntoFreeList( pxLink );
+                xNumberOfSuccessfulFrees++;
+            }
+            ( void ) xTaskResumeAll();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortCalloc( size_t xNum,
+                     size_t xSize )
+{
+    void * pv = NULL;
+
+    if( heapMULTIPLY_WILL_OVERFLOW( xNum, xSize ) == 0 )
+    {
+        pv = pvPortMalloc( xNum * xSize );
+
+        if( pv != NULL )
+        {
+            ( void ) memset( pv, 0, xNum * xSize );
+        }
+    }
+
+    return pv;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFindLastSet( uint32_t ulValue )
+{
+    UBaseType_t uxBit = 0U;
+
+    /* A binary search takes the same number of steps for any value, and does
+     * not depend on the compiler providing a count leading zeros builtin. */
+    if( ( ulValue & 0xFFFF0000UL ) != 0UL )
+    {
+        ulValue >>= 16;
+        uxBit += 16U;
+    }
+
+    if( ( ulValue & 0xFF00UL ) != 0UL )
+    {
+        ulValue >>= 8;
+        uxBit += 8U;
+    }
+
+    if( ( ulValue & 0xF0UL ) != 0UL )
+    {
+        ulValue >>= 4;
+        uxBit += 4U;
+    }
+
+    if( ( ulValue & 0xCUL ) != 0UL )
+    {
+        ulValue >>= 2;
+        uxBit += 2U;
+    }
+
+    if( ( ulValue & 0x2UL ) != 0UL )
+    {
+        uxBit += 1U;
+    }
+
+    return uxBit;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMapBlockSize( size_t xBlockSize,
+                             UBaseType_t * puxFirstLevel,
+                             UBaseType_t * puxSecondLevel )
+{
+    UBaseType_t uxFirstLevel;
+
+    if( xBlockSize < heapSMALL_BLOCK_SIZE )
+    {
+        *puxFirstLevel = 0U;
+        *puxSecondLevel = ( UBaseType_t ) ( xBlockSize / ( heapSMALL_BLOCK_SIZE / heapSL_INDEX_COUNT ) );
+    }
+    else
+    {
+        uxFirstLevel = prvFindLastSet( ( uint32_t ) xBlockSize );
+        *puxSecondLevel = ( UBaseType_t ) ( xBlockSize >> ( uxFirstLevel - heapSL_INDEX_COUNT_LOG2 ) ) ^ heapSL_INDEX_COUNT;
+        *puxFirstLevel = uxFirstLevel - ( heapFL_INDEX_SHIFT - 1U );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BlockLink_t * prvFindFreeBlock( size_t xWantedSize )
+{
+    BlockLink_t * pxBlock = NULL;
+    UBaseType_t uxFirstLevel, uxSecondLevel;
+    uint32_t ulBitmap;
+
+    /* Round the size up to the start of the next second level range, so every
+     * block in the list found is large enough and the first can be taken. */
+    if( xWantedSize < heapSMALL_BLOCK_SIZE )
+    {
+        xWantedSize += ( heapSMALL_BLOCK_SIZE / heapSL_INDEX_COUNT ) - 1U;
+    }
+    else
+    {
+        xWantedSize += ( ( size_t ) 1 << ( prvFindLastSet( ( uint32_t ) xWantedSize ) - heapSL_INDEX_COUNT_LOG2 ) ) - 1U;
+    }
+
+    if( xWantedSize < heapMAXIMUM_BLOCK_SIZE )
+    {
+        prvMapBlockSize( xWantedSize, &uxFirstLevel, &uxSecondLevel );
+
+        /* Look for a list that is not empty in the same first level range,
+         * then in the smallest larger first level range. */
+        ulBitmap = ulSecondLevelBitmaps[ uxFirstLevel ] & ( ~0UL << uxSecondLevel );
+
+        if( ulBitmap == 0UL )
+        {
+            ulBitmap = ulFirstLevelBitmap & ( ~0UL << ( uxFirstLevel + 1U ) );
+
+            if( ulBitmap != 0UL )
+            {
+                uxFirstLevel = prvFindLastSet( ulBitmap & ( ~ulBitmap + 1UL ) );
+                ulBitmap = ulSecondLevelBitmaps[ uxFirstLevel ];
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( ulBitmap != 0UL )
+        {
+            uxSecondLevel = prvFindLastSet( ulBitmap & ( ~ulBitmap + 1UL ) );
+            pxBlock = pxFreeLists[ uxFirstLevel ][ uxSecondLevel ];
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert )
+{
+    UBaseType_t uxFirstLevel, uxSecondLevel;
+    BlockLink_t * pxNextBlock;
+
+    prvMapBlockSize( pxBlockToInsert->xBlockSize, &uxFirstLevel, &uxSecondLevel );
+
+    pxNextBlock = pxFreeLists[ uxFirstLevel ][ uxSecondLevel ];
+    pxBlockToInsert->pxNextFreeBlock = pxNextBlock;
+    pxBlockToInsert->pxPreviousFreeBlock = NULL;
+
+    if( pxNextBlock != NULL )
+    {
+        pxNextBlock->pxPreviousFreeBlock = pxBlockToInsert;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] = pxBlockToInsert;
+    ulFirstLevelBitmap |= ( 1UL << uxFirstLevel );
+    ulSecondLevelBitmaps[ uxFirstLevel ] |= ( 1UL << uxSecondLevel );
+    xNumberOfFreeBlocks++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveBlockFromFreeList( BlockLink_t * pxBlockToRemove )
+{
+    UBaseType_t uxFirstLevel, uxSecondLevel;
+    BlockLink_t * pxNextBlock = pxBlockToRemove->pxNextFreeBlock;
+    BlockLink_t * pxPreviousBlock = pxBlockToRemove->pxPreviousFreeBlock;
+
+    prvMapBlockSize( pxBlockToRemove->xBlockSize, &uxFirstLevel, &uxSecondLevel );
+
+    if( pxNextBlock != NULL )
+    {
+        pxNextBlock->pxPreviousFreeBlock = pxPreviousBlock;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( pxPreviousBlock != NULL )
+    {
+        pxPreviousBlock->pxNextFreeBlock = pxNextBlock;
+    }
+    else
+    {
+        /* The block was at the head of its list.  Clear the bitmaps if the
+         * list is now empty. */
+        pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] = pxNextBlock;
+
+        if( pxNextBlock == NULL )
+        {
+            ulSecondLevelBitmaps[ uxFirstLevel ] &= ~( 1UL << uxSecondLevel );
+
+            if( ulSecondLevelBitmaps[ uxFirstLevel ] == 0UL )
+            {
+                ulFirstLevelBitmap &= ~( 1UL << uxFirstLevel );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    xNumberOfFreeBlocks--;
+}
+/*-----------------------------------------------------------*/
+
+void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
+{
+    BlockLink_t * pxFirstFreeBlockInRegion, * pxEnd;
+    size_t xTotalHeapSize = 0, xBlockSize;
+    BaseType_t xDefinedRegions = 0;
+    size_t xAddress, xEndAddress;
+    const HeapRegion_t * pxHeapRegion;
+
+    /* Can only call once! */
+    configASSERT( xHeapRegionsDefined == pdFALSE );
+
+    pxHeapRegion = &( pxHeapRegions[ xDefinedRegions ] );
+
+    while( pxHeapRegion->xSizeInBytes > 0 )
+    {
+        /* Ensure the heap region starts and ends on a correctly aligned
+         * boundary. */
+        xAddress = ( size_t ) pxHeapRegion->pucStartAddress;
+        xEndAddress = xAddress + pxHeapRegion->xSizeInBytes;
+
+        if( ( xAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+        {
+            xAddress += ( portBYTE_ALIGNMENT - 1 );
+            xAddress &= ~portBYTE_ALIGNMENT_MASK;
+        }
+
+        xEndAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+        /* To start with there is a single free block in the region, sized to
+         * take up the entire region minus the space taken by the zero sized
+         * block that marks the end of the region.  A region that is too large
+         * to be one block is divided into several. */
+        while( ( xAddress < xEndAddress ) && ( ( xEndAddress - xAddress ) >= ( heapMINIMUM_BLOCK_SIZE + xHeapStructSize ) ) )
+        {
+            xBlockSize = xEndAddress - xAddress - xHeapStructSize;
+
+            if( xBlockSize >= heapMAXIMUM_BLOCK_SIZE )
+            {
+                xBlockSize = heapMAXIMUM_BLOCK_SIZE - portBYTE_ALIGNMENT;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxFirstFreeBlockInRegion = ( BlockLink_t * ) xAddress;
+            pxFirstFreeBlockInRegion->pxPreviousPhysicalBlock = NULL;
+            pxFirstFreeBlockInRegion->xBlockSize = xBlockSize;
+
+            pxEnd = heapNEXT_PHYSICAL_BLOCK( pxFirstFreeBlockInRegion );
+            pxEnd->pxPreviousPhysicalBlock = pxFirstFreeBlockInRegion;
+            pxEnd->xBlockSize = 0;
+            heapALLOCATE_BLOCK( pxEnd );
+
+            prvInsertBlockIntoFreeList( pxFirstFreeBlockInRegion );
+            xTotalHeapSize += xBlockSize;
+            xAddress += xBlockSize + xHeapStructSize;
+        }
+
+        /* Move onto the next HeapRegion_t structure. */
+        xDefinedRegions++;
+        pxHeapRegion = &( pxHeapRegions[ xDefinedRegions ] );
+    }
+
+    xMinimumEverFreeBytesRemaining = xTotalHeapSize;
+    xFreeBytesRemaining = xTotalHeapSize;
+    xHeapRegionsDefined = pdTRUE;
+
+    /* Check something was actually defined before it is accessed. */
+    configASSERT( xTotalHeapSize );
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    BlockLink_t * pxBlock;
+    UBaseType_t uxFirstLevel, uxSecondLevel;
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+
+    vTaskSuspendAll();
+    {
+        /* The largest free block is in the highest list that is not empty, and
+         * the smallest free block is in the lowest, so only those two lists are
+         * searched rather than every free block. */
+        if( ulFirstLevelBitmap != 0UL )
+        {
+            uxFirstLevel = prvFindLastSet( ulFirstLevelBitmap );
+            uxSecondLevel = prvFindLastSet( ulSecondLevelBitmaps[ uxFirstLevel ] );
+
+            for( pxBlock = pxFreeLists[ uxFirstLevel ][ uxSecondLevel ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+            {
+                if( pxBlock->xBlockSize > xMaxSize )
+                {
+                    xMaxSize = pxBlock->xBlockSize;
+                }
+            }
+
+            uxFirstLevel = prvFindLastSet( ulFirstLevelBitmap & ( ~ulFirstLevelBitmap + 1UL ) );
+            uxSecondLevel = prvFindLastSet( ulSecondLevelBitmaps[ uxFirstLevel ] & ( ~ulSecondLevelBitmaps[ uxFirstLevel ] + 1UL ) );
+
+            for( pxBlock = pxFreeLists[ uxFirstLevel ][ uxSecondLevel ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+            {
+                if( pxBlock->xBlockSize < xMinSize )
+                {
+                    xMinSize = pxBlock->xBlockSize;
+                }
+            }
+        }
+
+        xBlocks = xNumberOfFreeBlocks;
+    }
+    ( void ) xTaskResumeAll();
+
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+    pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+    taskENTER_CRITICAL();
+    {
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,753 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A sample implementation of pvPortMalloc() and vPortFree() that uses a binary
+ * buddy allocator.  Every block is a power of two in size and starts at an
+ * address that is a multiple of its size, so a request for a power of two
+ * number of bytes uses a block of exactly that size, aligned to that size.
+ * This suits network and DMA buffers, which first fit allocators such as
+ * heap_4.c split in ways that leave small gaps between them.
+ *
+ * See heap_1.c, heap_2.c, heap_3.c, heap_4.c, heap_5.c and heap_6.c for
+ * alternative implementations, and the memory management pages of
+ * https://www.FreeRTOS.org for more information.
+ *
+ * Free blocks are held in one list for each block size, or order.  A request
+ * is rounded up to the next power of two and taken from the list for that
+ * order, or, if that list is empty, from the list of the next larger order that
+ * is not empty, halving the block until it is the right size and putting the
+ * unused halves into their lists.  When a block is freed it is combined with
+ * its buddy - the other half of the block it was split from, found by
+ * inverting one bit of its address - for as long as the buddy is free, so
+ * splitting and combining take a number of steps that grows with the log of
+ * the heap size.
+ *
+ * Usage notes:
+ *
+ * The heap is the ucHeap array of configTOTAL_HEAP_SIZE bytes, as with
+ * heap_4.c.  Allocated blocks have no header.  Instead one byte for each
+ * configHEAP_BUDDY_MIN_BLOCK_SIZE_LOG2 sized block in the heap records the
+ * order of the block that starts there and whether it is free, so the RAM used
+ * by the allocator itself is configTOTAL_HEAP_SIZE divided by the minimum block
+ * size.
+ *
+ * Rounding requests up to a power of two wastes up to half of each block, so
+ * heap_4.c or heap_6.c will make better use of the heap when most requests are
+ * not a power of two bytes.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#ifndef configHEAP_CLEAR_MEMORY_ON_FREE
+    #define configHEAP_CLEAR_MEMORY_ON_FREE    0
+#endif
+
+/* The smallest block is 2 to the power of this value bytes.  A free block holds
+ * the links of its free list, so the smallest block must be large enough to
+ * hold two pointers, and must also be a multiple of portBYTE_ALIGNMENT. */
+#ifndef configHEAP_BUDDY_MIN_BLOCK_SIZE_LOG2
+    #define configHEAP_BUDDY_MIN_BLOCK_SIZE_LOG2    5
+#endif
+
+/* The largest block is 2 to the power of this value bytes.  A heap that is
+ * larger than the largest block is divided into several blocks that are never
+ * combined. */
+#ifndef configHEAP_BUDDY_MAX_BLOCK_SIZE_LOG2
+    #define configHEAP_BUDDY_MAX_BLOCK_SIZE_LOG2    24
+#endif
+
+#if ( ( configHEAP_BUDDY_MAX_BLOCK_SIZE_LOG2 < configHEAP_BUDDY_MIN_BLOCK_SIZE_LOG2 ) || ( configHEAP_BUDDY_MAX_BLOCK_SIZE_LOG2 > 31 ) )
+    #error configHEAP_BUDDY_MAX_BLOCK_SIZE_LOG2 must be between configHEAP_BUDDY_MIN_BLOCK_SIZE_LOG2 and 31.
+#endif
+
+/* The number of block sizes, each of which has its own free list. */
+#define heapNUMBER_OF_ORDERS             ( ( UBaseType_t ) ( configHEAP_BUDDY_MAX_BLOCK_SIZE_LOG2 - configHEAP_BUDDY_MIN_BLOCK_SIZE_LOG2 + 1 ) )
+
+/* The size of the smallest and largest blocks, and of a block of a given
+ * order. */
+#define heapMINIMUM_BLOCK_SIZE           ( ( size_t ) 1 << configHEAP_BUDDY_MIN_BLOCK_SIZE_LOG2 )
+#define heapMAXIMUM_BLOCK_SIZE           ( ( size_t ) 1 << configHEAP_BUDDY_MAX_BLOCK_SIZE_LOG2 )
+#define heapORDER_SIZE( uxOrder )        ( heapMINIMUM_BLOCK_SIZE << ( uxOrder ) )
+
+/* The number of smallest blocks in the heap, each of which has a byte in
+ * ucBlockStates[]. */
+#define heapNUMBER_OF_MINIMUM_BLOCKS    ( ( size_t ) configTOTAL_HEAP_SIZE >> configHEAP_BUDDY_MIN_BLOCK_SIZE_LOG2 )
+
+/* The byte in ucBlockStates[] that corresponds to the start of a block is the
+ * block's order plus one, with heapBLOCK_FREE_BIT set if the block is free.
+ * Bytes that do not correspond to the start of a block are zero. */
+#define heapBLOCK_FREE_BIT               ( ( uint8_t ) 0x80U )
+#define heapALLOCATED_STATE( uxOrder )   ( ( uint8_t ) ( ( uxOrder ) + 1U ) )
+#define heapFREE_STATE( uxOrder )        ( ( uint8_t ) ( heapALLOCATED_STATE( uxOrder ) | heapBLOCK_FREE_BIT ) )
+#define heapSTATE_ORDER( ucState )       ( ( UBaseType_t ) ( ( ucState ) & ( uint8_t ) ~heapBLOCK_FREE_BIT ) - 1U )
+
+/* The index in ucBlockStates[] of the block that starts at pucBlock. */
+#define heapBLOCK_INDEX( pucBlock )      ( ( size_t ) ( ( pucBlock ) - pucHeapStart ) >> configHEAP_BUDDY_MIN_BLOCK_SIZE_LOG2 )
+
+/* Max value that fits in a size_t type. */
+#define heapSIZE_MAX                     ( ~( ( size_t ) 0 ) )
+
+/* Check if multiplying a and b will result in overflow. */
+#define heapMULTIPLY_WILL_OVERFLOW( a, b )    ( ( ( a ) > 0 ) && ( ( b ) > ( heapSIZE_MAX / ( a ) ) ) )
+
+/*-----------------------------------------------------------*/
+
+/* Allocate the memory for the heap. */
+#if ( configAPPLICATION_ALLOCATED_HEAP == 1 )
+
+/* The application writer has already defined the array used for the RTOS
+* heap - probably so it can be placed in a special segment or address. */
+    extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+    PRIVILEGED_DATA static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+/* Define the structure placed at the start of each free block.  It is
+ * overwritten by the application's data when the block is allocated. */
+typedef struct A_BLOCK_LINK
+{
+    struct A_BLOCK_LINK * pxNextFreeBlock;     /*<< The next block in the same free list. */
+    struct A_BLOCK_LINK * pxPreviousFreeBlock; /*<< The previous block in the same free list. */
+} BlockLink_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called automatically to setup the required heap structures the first time
+ * pvPortMalloc() is called.
+ */
+static void prvHeapInit( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Allocate a block large enough to hold xWantedSize bytes.  Used by both
+ * pvPortMalloc() and pvPortMallocAligned().
+ */
+static void * prvHeapAllocate( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the order of the smallest block that can hold xWantedSize bytes, or
+ * heapNUMBER_OF_ORDERS if no block is large enough.
+ */
+static UBaseType_t prvOrderForSize( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the bit number of the most significant bit that is set in ulValue,
+ * which must not be zero.
+ */
+static UBaseType_t prvFindLastSet( uint32_t ulValue ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return the block that starts at pucBlock, which is of order uxOrder, to the
+ * heap, combining it with its buddy for as long as the buddy is free.
+ */
+static void prvFreeBlock( uint8_t * pucBlock,
+                          UBaseType_t uxOrder ) PRIVILEGED_FUNCTION;
+
+/*
+ * Insert a free block into, and remove a free block from, the free list for its
+ * order, updating the state of the block in ucBlockStates[].
+ */
+static void prvInsertBlockIntoFreeList( uint8_t * pucBlock,
+                                        UBaseType_t uxOrder ) PRIVILEGED_FUNCTION;
+static void prvRemoveBlockFromFreeList( uint8_t * pucBlock,
+                                        UBaseType_t uxOrder ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+/* The free lists, and a bitmap that records which of them are not empty. */
+PRIVILEGED_DATA static BlockLink_t * pxFreeLists[ heapNUMBER_OF_ORDERS ];
+PRIVILEGED_DATA static uint32_t ulFreeListBitmap = 0U;
+
+/* The state of the block that starts at each multiple of the minimum block
+ * size in the heap - see heapBLOCK_FREE_BIT. */
+PRIVILEGED_DATA static uint8_t ucBlockStates[ heapNUMBER_OF_MINIMUM_BLOCKS ];
+
+/* The start and end of the part of ucHeap that is divided into blocks.  The
+ * start is aligned to the minimum block size. */
+PRIVILEGED_DATA static uint8_t * pucHeapStart = NULL;
+PRIVILEGED_DATA static uint8_t * pucHeapEnd = NULL;
+
+/* Keeps track of the number of calls to allocate and free memory, the number
+ * of free bytes remaining and the number of free blocks. */
+PRIVILEGED_DATA static size_t xFreeBytesRemaining = 0U;
+PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = 0;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = 0;
+PRIVILEGED_DATA static size_t xNumberOfFreeBlocks = 0;
+
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    return prvHeapAllocate( xWantedSize );
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_ALIGNED_HEAP_ALLOCATION == 1 )
+
+    void * pvPortMallocAligned( size_t xWantedSize,
+                                size_t xAlignment )
+    {
+        /* The alignment must be a power of two. */
+        configASSERT( ( xAlignment != ( size_t ) 0 ) && ( ( xAlignment & ( xAlignment - ( size_t ) 1 ) ) == ( size_t ) 0 ) );
+
+        /* Every block is aligned to its own size, so a block that is at least
+         * as large as the alignment is aligned to it. */
+        if( ( xWantedSize > ( size_t ) 0 ) && ( xWantedSize < xAlignment ) )
+        {
+            xWantedSize = xAlignment;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return prvHeapAllocate( xWantedSize );
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortFreeAligned( void * pv )
+    {
+        vPortFree( pv );
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_ALIGNED_HEAP_ALLOCATION */
+
+static void * prvHeapAllocate( size_t xWantedSize )
+{
+    uint8_t * pucBlock;
+    UBaseType_t uxWantedOrder, uxOrder;
+    uint32_t ulBitmap;
+    void * pvReturn = NULL;
+
+    vTaskSuspendAll();
+    {
+        /* If this is the first call to malloc then the heap will require
+         * initialisation to setup the list of free blocks. */
+        if( pucHeapStart == NULL )
+        {
+            prvHeapInit();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        uxWantedOrder = prvOrderForSize( xWantedSize );
+
+        if( ( xWantedSize > 0 ) && ( uxWantedOrder < heapNUMBER_OF_ORDERS ) )
+        {
+            /* Find the smallest order, no smaller than the order wanted, that
+             * has a free block. */
+            ulBitmap = ulFreeListBitmap & ( ~0UL << uxWantedOrder );
+
+            if( ulBitmap != 0UL )
+            {
+                uxOrder = prvFindLastSet( ulBitmap & ( ~ulBitmap + 1UL ) );
+                pucBlock = ( uint8_t * ) pxFreeLists[ uxOrder ];
+                prvRemoveBlockFromFreeList( pucBlock, uxOrder );
+
+                /* Halve the block until it is the size wanted, returning the
+                 * upper half to the heap each time.  The upper half's buddy is
+                 * the lower half, which is not free, so it is not combined with
+                 * anything. */
+                while( uxOrder > uxWantedOrder )
+                {
+                    uxOrder--;
+                    prvInsertBlockIntoFreeList( pucBlock + heapORDER_SIZE( uxOrder ), uxOrder );
+                }
+
+                ucBlockStates[ heapBLOCK_INDEX( pucBlock ) ] = heapALLOCATED_STATE( uxWantedOrder );
+                xFreeBytesRemaining -= heapORDER_SIZE( uxWantedOrder );
+
+                if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                {
+                    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                pvReturn = ( void * ) pucBlock;
+                xNumberOfSuccessfulAllocations++;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceMALLOC( pvReturn, xWantedSize );
+    }
+    ( void ) xTaskResumeAll();
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if( pvReturn == NULL )
+        {
+            extern void vApplicationMallocFailedHook( void );
+            vApplicationMallocFailedHook();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* if ( configUSE_MALLOC_FAILED_HOOK == 1 ) */
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    uint8_t * pucBlock = ( uint8_t * ) pv;
+    uint8_t ucState;
+    UBaseType_t uxOrder;
+
+    if( pv != NULL )
+    {
+        /* The memory being freed must be the start of an allocated block. */
+        configASSERT( ( pucBlock >= pucHeapStart ) && ( pucBlock < pucHeapEnd ) );
+        configASSERT( ( ( size_t ) ( pucBlock - pucHeapStart ) & ( heapMINIMUM_BLOCK_SIZE - ( size_t ) 1 ) ) == ( size_t ) 0 );
+
+        ucState = ucBlockStates[ heapBLOCK_INDEX( pucBlock ) ];
+        configASSERT( ( ucState != ( uint8_t ) 0 ) && ( ( ucState & heapBLOCK_FREE_BIT ) == ( uint8_t ) 0 ) );
+
+        if( ( ucState != ( uint8_t ) 0 ) && ( ( ucState & heapBLOCK_FREE_BIT ) == ( uint8_t ) 0 ) )
+        {
+            uxOrder = heapSTATE_ORDER( ucState );
+
+            #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+            {
+                ( void ) memset( pv, 0, heapORDER_SIZE( uxOrder ) );
+            }
+            #endif
+
+            vTaskSuspendAll();
+            {
+                xFreeBytesRemaining += heapORDER_SIZE( uxOrder );
+                traceFREE( pv, heapORDER_SIZE( uxOrder ) );
+                prvFreeBlock( pucBlock, uxOrder );
+                xNumberOfSuccessfulFrees++;
+            }
+            ( void ) xTaskResumeAll();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+    /* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortCalloc( size_t xNum,
+                     size_t xSize )
+{
+    void * pv = NULL;
+
+    if( heapMULTIPLY_WILL_OVERFLOW( xNum, xSize ) == 0 )
+    {
+        pv = pvPortMalloc( xNum * xSize );
+
+        if( pv != NULL )
+        {
+            ( void ) memset( pv, 0, xNum * xSize );
+        }
+    }
+
+    return pv;
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortRealloc( void * pv,
+                      size_t xWantedSize )
+{
+    uint8_t * pucBlock = ( uint8_t * ) pv;
+    UBaseType_t uxOrder, uxWantedOrder;
+    void * pvReturn = NULL;
+
+    if( pv == NULL )
+    {
+        pvReturn = pvPortMalloc( xWantedSize );
+    }
+    else if( xWantedSize == ( size_t ) 0 )
+    {
+        vPortFree( pv );
+    }
+    else
+    {
+        configASSERT( ( pucBlock >= pucHeapStart ) && ( pucBlock < pucHeapEnd ) );
+        configASSERT( ( ucBlockStates[ heapBLOCK_INDEX( pucBlock ) ] & heapBLOCK_FREE_BIT ) == ( uint8_t ) 0 );
+
+        uxOrder = heapSTATE_ORDER( ucBlockStates[ heapBLOCK_INDEX( pucBlock ) ] );
+        uxWantedOrder = prvOrderForSize( xWantedSize );
+
+        if( uxWantedOrder <= uxOrder )
+        {
+            /* The block is shrunk in place by returning its upper halves to
+             * the heap.  Their buddies are the lower halves, which are not
+             * free, so they are not combined with anything. */
+            if( uxWantedOrder < uxOrder )
+            {
+                #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+                {
+                    ( void ) memset( pucBlock + heapORDER_SIZE( uxWantedOrder ), 0, heapORDER_SIZE( uxOrder ) - heapORDER_SIZE( uxWantedOrder ) );
+                }
+                #endif
+
+                vTaskSuspendAll();
+                {
+                    xFreeBytesRemaining += heapORDER_SIZE( uxOrder ) - heapORDER_SIZE( uxWantedOrder );
+
+                    while( uxOrder > uxWantedOrder )
+                    {
+                        uxOrder--;
+                        prvInsertBlockIntoFreeList( pucBlock + heapORDER_SIZE( uxOrder ), uxOrder );
+                    }
+
+                    ucBlockStates[ heapBLOCK_INDEX( pucBlock ) ] = heapALLOCATED_STATE( uxWantedOrder );
+                }
+                ( void ) xTaskResumeAll();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pvReturn = pv;
+        }
+        else
+        {
+            /* The block's buddy is only the right size to double it when it
+             * is free and of the same order, and even then may be below it,
+             * so a larger block is allocated and the contents moved. */
+            pvReturn = pvPortMalloc( xWantedSize );
+
+            if( pvReturn != NULL )
+            {
+                ( void ) memcpy( pvReturn, pv, heapORDER_SIZE( uxOrder ) );
+                vPortFree( pv );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    }
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvOrderForSize( size_t xWantedSize )
+{
+    UBaseType_t uxOrder = heapNUMBER_OF_ORDERS;
+
+    if( xWantedSize <= heapMINIMUM_BLOCK_SIZE )
+    {
+        uxOrder = 0U;
+    }
+    else if( xWantedSize <= heapMAXIMUM_BLOCK_SIZE )
+    {
+        /* Round up to the next power of two. */
+        uxOrder = prvFindLastSet( ( uint32_t ) ( xWantedSize - ( size_t ) 1 ) ) + 1U - ( UBaseType_t ) configHEAP_BUDDY_MIN_BLOCK_SIZE_LOG2;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return uxOrder;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFindLastSet( uint32_t ulValue )
+{
+    UBaseType_t uxBit = 0U;
+
+    /* A binary search takes the same number of steps for any value, and does
+     * not depend on the compiler providing a count leading zeros builtin. */
+    if( ( ulValue & 0xFFFF0000UL ) != 0UL )
+    {
+        ulValue >>= 16;
+        uxBit += 16U;
+    }
+
+    if( ( ulValue & 0xFF00UL ) != 0UL )
+    {
+        ulValue >>= 8;
+        uxBit += 8U;
+    }
+
+    if( ( ulValue & 0xF0UL ) != 0UL )
+    {
+        ulValue >>= 4;
+        uxBit += 4U;
+    }
+
+    if( ( ulValue & 0xCUL ) != 0UL )
+    {
+        ulValue >>= 2;
+        uxBit += 2U;
+    }
+
+    if( ( ulValue & 0x2UL ) != 0UL )
+    {
+        uxBit += 1U;
+    }
+
+    return uxBit;
+}
+/*-----------------------------------------------------------*/
+
+static void prvFreeBlock( uint8_t * pucBlock,
+                          UBaseType_t uxOrder )
+{
+    uint8_t * pucBuddy;
+    BaseType_t xBuddyIsFree = pdTRUE;
+
+    /* The buddy of a block is the block of the same size that it was split
+     * from, or would combine with, which differs from it in only the bit of
+     * its address that corresponds to its size.  The buddy must lie within the
+     * heap, and be a free block of the same order - a buddy that has itself
+     * been split is not free at that order. */
+    while( ( uxOrder < ( heapNUMBER_OF_ORDERS - 1U ) ) && ( xBuddyIsFree != pdFALSE ) )
+    {
+        pucBuddy = ( uint8_t * ) ( ( portPOINTER_SIZE_TYPE ) pucBlock ^ ( portPOINTER_SIZE_TYPE ) heapORDER_SIZE( uxOrder ) ); /*lint !e923 !e9078 Address arithmetic is used to find the buddy. */
+
+        if( ( pucBuddy >= pucHeapStart ) &&
+            ( pucBuddy < pucHeapEnd ) &&
+            ( ( size_t ) ( pucHeapEnd - pucBuddy ) >= heapORDER_SIZE( uxOrder ) ) &&
+            ( ucBlockStates[ heapBLOCK_INDEX( pucBuddy ) ] == heapFREE_STATE( uxOrder ) ) )
+        {
+            prvRemoveBlockFromFreeList( pucBuddy, uxOrder );
+
+            /* The combined block starts at the lower of the two, so the upper
+             * one no longer starts a block. */
+            if( pucBuddy < pucBlock )
+            {
+                ucBlockStates[ heapBLOCK_INDEX( pucBlock ) ] = ( uint8_t ) 0;
+                pucBlock = pucBuddy;
+            }
+            else
+            {
+                ucBlockStates[ heapBLOCK_INDEX( pucBuddy ) ] = ( uint8_t ) 0;
+            }
+
+            uxOrder++;
+        }
+        else
+        {
+            xBuddyIsFree = pdFALSE;
+        }
+    }
+
+    prvInsertBlockIntoFreeList( pucBlock, uxOrder );
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertBlockIntoFreeList( uint8_t * pucBlock,
+                                        UBaseType_t uxOrder )
+{
+    BlockLink_t * const pxBlockToInsert = ( BlockLink_t * ) pucBlock; /*lint !e9087 !e826 Blocks are aligned to at least the minimum block size. */
+    BlockLink_t * const pxNextBlock = pxFreeLists[ uxOrder ];
+
+    pxBlockToInsert->pxNextFreeBlock = pxNextBlock;
+    pxBlockToInsert->pxPreviousFreeBlock = NULL;
+
+    if( pxNextBlock != NULL )
+    {
+        pxNextBlock->pxPreviousFreeBlock = pxBlockToInsert;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    pxFreeLists[ uxOrder ] = pxBlockToInsert;
+    ulFreeListBitmap |= ( 1UL << uxOrder );
+    ucBlockStates[ heapBLOCK_INDEX( pucBlock ) ] = heapFREE_STATE( uxOrder );
+    xNumberOfFreeBlocks++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveBlockFromFreeList( uint8_t * pucBlock,
+                                        UBaseType_t uxOrder )
+{
+    BlockLink_t * const pxBlockToRemove = ( BlockLink_t * ) pucBlock; /*lint !e9087 !e826 Blocks are aligned to at least the minimum block size. */
+    BlockLink_t * const pxNextBlock = pxBlockToRemove->pxNextFreeBlock;
+    BlockLink_t * const pxPreviousBlock = pxBlockToRemove->pxPreviousFreeBlock;
+
+    if( pxNextBlock != NULL )
+    {
+        pxNextBlock->pxPreviousFreeBlock = pxPreviousBlock;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( pxPreviousBlock != NULL )
+    {
+        pxPreviousBlock->pxNextFreeBlock = pxNextBlock;
+    }
+    else
+    {
+        /* The block was at the head of its list.  Clear the bitmap if the list
+         * is now empty. */
+        pxFreeLists[ uxOrder ] = pxNextBlock;
+
+        if( pxNextBlock == NULL )
+        {
+            ulFreeListBitmap &= ~( 1UL << uxOrder );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    /* The caller either allocates the block or combines it with its buddy, so
+     * sets its state. */
+    xNumberOfFreeBlocks--;
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void ) /* PRIVILEGED_FUNCTION */
+{
+    size_t xAddress, xEndAddress;
+    UBaseType_t uxOrder;
+
+    /* A free block must be able to hold its free list links, and every block
+     * must be correctly byte aligned. */
+    configASSERT( heapMINIMUM_BLOCK_SIZE >= sizeof( BlockLink_t ) );
+    configASSERT( heapMINIMUM_BLOCK_SIZE >= ( size_t ) portBYTE_ALIGNMENT );
+
+    /* Ensure the heap starts and ends on a minimum block boundary. */
+    xAddress = ( size_t ) ucHeap;
+    xEndAddress = xAddress + ( size_t ) configTOTAL_HEAP_SIZE;
+    xAddress = ( xAddress + ( heapMINIMUM_BLOCK_SIZE - ( size_t ) 1 ) ) & ~( heapMINIMUM_BLOCK_SIZE - ( size_t ) 1 );
+    xEndAddress &= ~( heapMINIMUM_BLOCK_SIZE - ( size_t ) 1 );
+
+    pucHeapStart = ( uint8_t * ) xAddress;
+    pucHeapEnd = ( uint8_t * ) xEndAddress;
+
+    /* Divide the heap into the largest blocks that fit, each of which must
+     * start at a multiple of its own size. */
+    while( xAddress < xEndAddress )
+    {
+        uxOrder = heapNUMBER_OF_ORDERS - 1U;
+
+        while( ( ( xAddress & ( heapORDER_SIZE( uxOrder ) - ( size_t ) 1 ) ) != ( size_t ) 0 ) ||
+               ( ( xEndAddress - xAddress ) < heapORDER_SIZE( uxOrder ) ) )
+        {
+            uxOrder--;
+        }
+
+        prvInsertBlockIntoFreeList( ( uint8_t * ) xAddress, uxOrder );
+        xFreeBytesRemaining += heapORDER_SIZE( uxOrder );
+        xAddress += heapORDER_SIZE( uxOrder );
+    }
+
+    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+
+    vTaskSuspendAll();
+    {
+        /* Every block in a free list is the same size, so the largest and
+         * smallest free blocks are found from the bitmap without walking the
+         * lists. */
+        if( ulFreeListBitmap != 0UL )
+        {
+            xMaxSize = heapORDER_SIZE( prvFindLastSet( ulFreeListBitmap ) );
+            xMinSize = heapORDER_SIZE( prvFindLastSet( ulFreeListBitmap & ( ~ulFreeListBitmap + 1UL ) ) );
+        }
+
+        xBlocks = xNumberOfFreeBlocks;
+    }
+    ( void ) xTaskResumeAll();
+
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+    pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+    taskENTER_CRITICAL();
+    {
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
@@ -64,11 +64,36 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "timers.h"
+#include "stream_buffer.h"
 #include "utils/wait_for_event.h"
 /*-----------------------------------------------------------*/
 
 #define SIG_RESUME SIGUSR1
 
+#if ( configUSE_SHARED_STREAM_BUFFERS == 1 )
+    #define SIG_SHARED_STREAM_BUFFER ( SIGRTMIN + 1 )
+
+    #ifndef portMAX_SHARED_STREAM_BUFFERS
+        #define portMAX_SHARED_STREAM_BUFFERS 8
+    #endif
+
+typedef struct SHARED_STREAM_BUFFER
+{
+    StreamBufferHandle_t xStreamBuffer;
+    unsigned long ulChannel;
+    pid_t xPeerProcess;
+} SharedStreamBuffer_t;
+
+static SharedStreamBuffer_t xSharedStreamBuffers[ portMAX_SHARED_STREAM_BUFFERS ];
+static pthread_once_t hSharedStreamBufferSignalSetup = PTHREAD_ONCE_INIT;
+#endif /* configUSE_SHARED_STREAM_BUFFERS */
+
+#if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+    #define SIG_HIGH_RESOLUTION_TIMER ( SIGRTMIN + 2 )
+
+static timer_t xHighResolutionTimer;
+#endif /* configUSE_HIGH_RESOLUTION_TIMERS */
+
 typedef struct THREAD
 {
     pthread_t pthread;
@@ -112,6 +137,14 @@ static void prvResumeThread( Thread_t * xThreadId );
 static void vPortSystemTickHandler( int sig );
 static void vPortStartFirstTask( void );
 static void prvPortYieldFromISR( void );
+#if ( configUSE_SHARED_STREAM_BUFFERS == 1 )
+static void prvSetupSharedStreamBufferSignal( void );
+static void prvSharedStreamBufferHandler( int sig, siginfo_t *pxInfo, void *pvContext );
+#endif
+#if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+static void prvSetupHighResolutionTimer( void );
+static void prvHighResolutionTimerHandler( int sig );
+#endif
 /*-----------------------------------------------------------*/
 
 static void prvFatalError( const char *pcCall, int iErrno )
@@ -237,6 +270,11 @@ Thread_t *xCurrentThread;
     sigemptyset( &sigtick.sa_mask );
     sigaction( SIGALRM, &sigtick, NULL );
 
+#if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+    (void)timer_delete( xHighResolutionTimer );
+    sigaction( SIG_HIGH_RESOLUTION_TIMER, &sigtick, NULL );
+#endif
+
     /* Signal the scheduler to exit its loop. */
     xSchedulerEnd = pdTRUE;
     (void)pthread_kill( hMainThread, SIG_RESUME );
@@ -551,9 +589,220 @@ int iRet;
     {
         prvFatalError( "sigaction", errno );
     }
+
+#if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+    prvSetupHighResolutionTimer();
+#endif
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_SHARED_STREAM_BUFFERS == 1 )
+
+portBASE_TYPE xPortSharedStreamBufferConnect( void *xStreamBuffer,
+                                              unsigned long ulChannel,
+                                              pid_t xPeerProcess )
+{
+portBASE_TYPE xReturn = pdFAIL;
+size_t x;
+
+    /* The channel is sent to the other process as the value of the signal,
+     * with the bottom bit used to indicate the direction. */
+    configASSERT( ulChannel <= ( ( unsigned long ) INT_MAX >> 1 ) );
+
+    (void)pthread_once( &hSharedStreamBufferSignalSetup, prvSetupSharedStreamBufferSignal );
+
+    vPortEnterCritical();
+    {
+        for( x = 0; x < portMAX_SHARED_STREAM_BUFFERS; x++ )
+        {
+            if( xSharedStreamBuffers[ x ].xStreamBuffer == NULL )
+            {
+                xSharedStreamBuffers[ x ].ulChannel = ulChannel;
+                xSharedStreamBuffers[ x ].xPeerProcess = xPeerProcess;
+                xSharedStreamBuffers[ x ].xStreamBuffer = xStreamBuffer;
+                xReturn = pdPASS;
+                break;
+            }
+        }
+    }
+    vPortExitCritical();
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortSharedStreamBufferNotify( void *xStreamBuffer, portBASE_TYPE xDataWritten )
+{
+union sigval xValue;
+size_t x;
+
+    for( x = 0; x < portMAX_SHARED_STREAM_BUFFERS; x++ )
+    {
+        if( xSharedStreamBuffers[ x ].xStreamBuffer == xStreamBuffer )
+        {
+            xValue.sival_int = ( int ) ( ( xSharedStreamBuffers[ x ].ulChannel << 1 ) |
+                                         ( ( xDataWritten != pdFALSE ) ? 1UL : 0UL ) );
+
+            /* If the signal queue of the other process is full then it already
+             * has notifications pending, so a failure is not an error. */
+            (void)sigqueue( xSharedStreamBuffers[ x ].xPeerProcess, SIG_SHARED_STREAM_BUFFER, xValue );
+            break;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetupSharedStreamBufferSignal( void )
+{
+struct sigaction sigshared;
+int iRet;
+
+    sigshared.sa_flags = SA_SIGINFO;
+    sigshared.sa_sigaction = prvSharedStreamBufferHandler;
+    sigfillset( &sigshared.sa_mask );
+
+    iRet = sigaction( SIG_SHARED_STREAM_BUFFER, &sigshared, NULL );
+    if ( iRet )
+    {
+        prvFatalError( "sigaction", errno );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvSharedStreamBufferHandler( int sig, siginfo_t *pxInfo, void *pvContext )
+{
+Thread_t *pxThreadToSuspend;
+Thread_t *pxThreadToResume;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+unsigned long ulValue = ( unsigned long ) pxInfo->si_value.sival_int;
+size_t x;
+
+    uxCriticalNesting++; /* Signals are blocked in this signal handler. */
+
+    for( x = 0; x < portMAX_SHARED_STREAM_BUFFERS; x++ )
+    {
+        if( ( xSharedStreamBuffers[ x ].xStreamBuffer != NULL ) &&
+            ( xSharedStreamBuffers[ x ].ulChannel == ( ulValue >> 1 ) ) &&
+            ( xSharedStreamBuffers[ x ].xPeerProcess == pxInfo->si_pid ) )
+        {
+            /* The other process wrote to or read from the stream buffer, so
+             * unblock the local task, if any, that is waiting for it to do so. */
+            if( ( ulValue & 1UL ) != 0UL )
+            {
+                (void)xStreamBufferSendCompletedFromISR( xSharedStreamBuffers[ x ].xStreamBuffer, &xHigherPriorityTaskWoken );
+            }
+            else
+            {
+                (void)xStreamBufferReceiveCompletedFromISR( xSharedStreamBuffers[ x ].xStreamBuffer, &xHigherPriorityTaskWoken );
+            }
+            break;
+        }
+    }
+
+    if( xHigherPriorityTaskWoken != pdFALSE )
+    {
+        pxThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+        vTaskSwitchContext();
+
+        pxThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+        prvSwitchThread( pxThreadToResume, pxThreadToSuspend );
+    }
+
+    uxCriticalNesting--;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_SHARED_STREAM_BUFFERS */
+
+#if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+
+uint64_t ullPortGetHighResolutionTime( void )
+{
+    return prvGetTimeNs();
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetHighResolutionCompare( uint64_t ullTimeNs )
+{
+struct itimerspec xCompare;
+int iRet;
+
+    /* An absolute time of zero would disarm the timer, and any time that has
+     * already passed makes the timer expire immediately. */
+    if ( ullTimeNs == 0 )
+    {
+        ullTimeNs = 1;
+    }
+
+    xCompare.it_interval.tv_sec = 0;
+    xCompare.it_interval.tv_nsec = 0;
+    xCompare.it_value.tv_sec = ( time_t ) ( ullTimeNs / 1000000000ull );
+    xCompare.it_value.tv_nsec = ( long ) ( ullTimeNs % 1000000000ull );
+
+    iRet = timer_settime( xHighResolutionTimer, TIMER_ABSTIME, &xCompare, NULL );
+    if ( iRet )
+    {
+        prvFatalError( "timer_settime", errno );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetupHighResolutionTimer( void )
+{
+struct sigaction sighighres;
+struct sigevent xEvent;
+int iRet;
+
+    sighighres.sa_flags = 0;
+    sighighres.sa_handler = prvHighResolutionTimerHandler;
+    sigfillset( &sighighres.sa_mask );
+
+    iRet = sigaction( SIG_HIGH_RESOLUTION_TIMER, &sighighres, NULL );
+    if ( iRet )
+    {
+        prvFatalError( "sigaction", errno );
+    }
+
+    /* Like SIGALRM the signal is sent to the process, so is handled by the
+     * thread of the running task as the other threads block all signals. */
+    memset( &xEvent, 0, sizeof( xEvent ) );
+    xEvent.sigev_notify = SIGEV_SIGNAL;
+    xEvent.sigev_signo = SIG_HIGH_RESOLUTION_TIMER;
+
+    iRet = timer_create( CLOCK_MONOTONIC, &xEvent, &xHighResolutionTimer );
+    if ( iRet )
+    {
+        prvFatalError( "timer_create", errno );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvHighResolutionTimerHandler( int sig )
+{
+Thread_t *pxThreadToSuspend;
+Thread_t *pxThreadToResume;
+
+    uxCriticalNesting++; /* Signals are blocked in this signal handler. */
+
+    if( xTimerProcessHighResolutionTimersFromISR() != pdFALSE )
+    {
+        pxThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+        vTaskSwitchContext();
+
+        pxThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+        prvSwitchThread( pxThreadToResume, pxThreadToSuspend );
+    }
+
+    uxCriticalNesting--;
 }
 /*-----------------------------------------------------------*/
 
+#endif /* configUSE_HIGH_RESOLUTION_TIMERS */
+
 unsigned long ulPortGetRunTime( void )
 {
 struct tms xTimes;
@@ -127,6 +127,42 @@ extern void vPortCancelThread( void *pxTaskToDelete );
 extern unsigned long ulPortGetRunTime( void );
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() /* no-op */
 #define portGET_RUN_TIME_COUNTER_VALUE()         ulPortGetRunTime()
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_SHARED_STREAM_BUFFERS == 1 )
+
+#include <sys/types.h>
+
+/*
+ * Stream buffers in memory shared with another process running the Posix
+ * port.  Each process calls xPortSharedStreamBufferConnect() with its own
+ * handle to the stream buffer, the process ID of the other process and a
+ * channel number that both processes use for that stream buffer.  Send and
+ * receive completions are then signalled to the other process with a real
+ * time signal, which is handled like an interrupt.
+ */
+extern portBASE_TYPE xPortSharedStreamBufferConnect( void *xStreamBuffer,
+                                                     unsigned long ulChannel,
+                                                     pid_t xPeerProcess );
+extern void vPortSharedStreamBufferNotify( void *xStreamBuffer, portBASE_TYPE xDataWritten );
+#define portSTREAM_BUFFER_SHARED_SEND_COMPLETED( xStreamBuffer )    vPortSharedStreamBufferNotify( ( xStreamBuffer ), pdTRUE )
+#define portSTREAM_BUFFER_SHARED_RECEIVE_COMPLETED( xStreamBuffer ) vPortSharedStreamBufferNotify( ( xStreamBuffer ), pdFALSE )
+
+#endif /* configUSE_SHARED_STREAM_BUFFERS */
+
+#if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+
+/*
+ * High resolution timers use CLOCK_MONOTONIC for the time and a POSIX timer
+ * that expires at an absolute time for the compare.  The timer generates a
+ * real time signal, which is handled like an interrupt.
+ */
+extern uint64_t ullPortGetHighResolutionTime( void );
+extern void vPortSetHighResolutionCompare( uint64_t ullTimeNs );
+#define portGET_HIGH_RESOLUTION_TIME_NS()               ullPortGetHighResolutionTime()
+#define portSET_HIGH_RESOLUTION_COMPARE( ullTimeNs )    vPortSetHighResolutionCompare( ullTimeNs )
+
+#endif /* configUSE_HIGH_RESOLUTION_TIMERS */
 
 #ifdef __cplusplus
 }
@@ -37,6 +37,7 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
+#include "slab.h"
 
 #if ( configUSE_CO_ROUTINES == 1 )
     #include "croutine.h"
@@ -92,6 +93,45 @@ typedef struct SemaphoreData
     #define queueYIELD_IF_USING_PREEMPTION()    portYIELD_WITHIN_API()
 #endif
 
+/* The storage area of a dynamically created queue follows the queue structure
+ * in the same block of memory.  If configQUEUE_STORAGE_ALIGNMENT is set then the
+ * block is allocated aligned, and the structure is padded, so the storage area
+ * is aligned too. */
+#if ( configQUEUE_STORAGE_ALIGNMENT > 0 )
+    #define queueSTORAGE_OFFSET                                                              \
+    ( ( sizeof( Queue_t ) + ( size_t ) ( configQUEUE_STORAGE_ALIGNMENT - 1 ) ) &             \
+      ~( ( size_t ) ( configQUEUE_STORAGE_ALIGNMENT - 1 ) ) )
+    #define queueMALLOC_QUEUE( xQueueSizeInBytes )                                           \
+    ( ( ( xQueueSizeInBytes ) == ( size_t ) 0 ) ?                                            \
+      pvPortMalloc( sizeof( Queue_t ) ) :                                                    \
+      pvPortMallocAligned( queueSTORAGE_OFFSET + ( xQueueSizeInBytes ), ( size_t ) configQUEUE_STORAGE_ALIGNMENT ) )
+    #define queueMFREE_QUEUE( pxQueue )                                                      \
+    ( ( ( pxQueue )->uxItemSize == queueSEMAPHORE_QUEUE_ITEM_LENGTH ) ?                      \
+      vPortFree( pxQueue ) :                                                                 \
+      vPortFreeAligned( pxQueue ) )
+#else
+    #define queueSTORAGE_OFFSET                         sizeof( Queue_t )
+    #define queueMALLOC_QUEUE( xQueueSizeInBytes )      pvPortMallocQueue( sizeof( Queue_t ) + ( xQueueSizeInBytes ) )
+    #define queueMFREE_QUEUE( pxQueue )                 vPortFree( pxQueue )
+#endif
+
+/* Semaphores and mutexes have no storage area so are all the same size, and
+ * come from the queue slab cache when slab caches are in use.  Queues that hold
+ * data are allocated together with their storage area from the heap. */
+#if ( configUSE_SLAB_CACHES == 1 )
+    #define queueALLOCATE_QUEUE( xQueueSizeInBytes )                                \
+    ( ( ( xQueueSizeInBytes ) == ( size_t ) 0 ) ?                                   \
+      pvSlabAllocate( eSlabCacheQueue, sizeof( Queue_t ) ) :                        \
+      queueMALLOC_QUEUE( xQueueSizeInBytes ) )
+    #define queueFREE_QUEUE( pxQueue )                                              \
+    ( ( ( pxQueue )->uxItemSize == queueSEMAPHORE_QUEUE_ITEM_LENGTH ) ?             \
+      vSlabFree( pxQueue ) :                                                        \
+      queueMFREE_QUEUE( pxQueue ) )
+#else
+    #define queueALLOCATE_QUEUE( xQueueSizeInBytes )    queueMALLOC_QUEUE( xQueueSizeInBytes )
+    #define queueFREE_QUEUE( pxQueue )                  queueMFREE_QUEUE( pxQueue )
+#endif
+
 /*
  * Definition of the queue used by the scheduler.
  * Items are queued by copy, not reference.  See the following link for the
@@ -437,7 +477,7 @@ BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
             /* Check for multiplication overflow. */
             ( ( SIZE_MAX / uxQueueLength ) >= uxItemSize ) &&
             /* Check for addition overflow. */
-            ( ( SIZE_MAX - sizeof( Queue_t ) ) >= ( uxQueueLength * uxItemSize ) ) )
+            ( ( SIZE_MAX - queueSTORAGE_OFFSET ) >= ( uxQueueLength * uxItemSize ) ) )
         {
             /* Allocate enough space to hold the maximum number of items that
              * can be in the queue at any time.  It is valid for uxItemSize to be
@@ -453,14 +493,14 @@ BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
              * are greater than or equal to the pointer to char requirements the cast
              * is safe.  In other cases alignment requirements are not strict (one or
              * two bytes). */
-            pxNewQueue = ( Queue_t * ) pvPortMalloc( sizeof( Queue_t ) + xQueueSizeInBytes ); /*lint !e9087 !e9079 see comment above. */
+            pxNewQueue = ( Queue_t * ) queueALLOCATE_QUEUE( xQueueSizeInBytes ); /*lint !e9087 !e9079 see comment above. */
 
             if( pxNewQueue != NULL )
             {
                 /* Jump past the queue structure to find the location of the queue
                  * storage area. */
                 pucQueueStorage = ( uint8_t * ) pxNewQueue;
-                pucQueueStorage += sizeof( Queue_t ); /*lint !e9016 Pointer arithmetic allowed on char types, especially when it assists conveying intent. */
+                pucQueueStorage += queueSTORAGE_OFFSET; /*lint !e9016 Pointer arithmetic allowed on char types, especially when it assists conveying intent. */
 
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                 {
@@ -2098,7 +2138,7 @@ void vQueueDelete( QueueHandle_t xQueue )
     {
         /* The queue can only have been allocated dynamically - free it
          * again. */
-        vPortFree( pxQueue );
+        queueFREE_QUEUE( pxQueue );
     }
     #elif ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
     {
@@ -2106,7 +2146,7 @@ void vQueueDelete( QueueHandle_t xQueue )
          * check before attempting to free the memory. */
         if( pxQueue->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
         {
-            vPortFree( pxQueue );
+            queueFREE_QUEUE( pxQueue );
         }
         else
         {
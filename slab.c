@@ -0,0 +1,425 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "slab.h"
+
+/* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
+ * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021 See comment above. */
+
+/* This entire source file will be skipped if the application is not configured
+ * to use slab caches.  If you want to use slab caches then ensure
+ * configUSE_SLAB_CACHES is set to 1 in FreeRTOSConfig.h. */
+#if ( configUSE_SLAB_CACHES == 1 )
+
+/* The number of slab caches - one for each value of eSlabCache. */
+    #define slabNUMBER_OF_CACHES    ( ( UBaseType_t ) eSlabCacheEventGroup + ( UBaseType_t ) 1 )
+
+/* Round a size up to a multiple of portBYTE_ALIGNMENT. */
+    #define slabALIGN_SIZE( xSize )    ( ( ( xSize ) + ( ( size_t ) portBYTE_ALIGNMENT - ( size_t ) 1 ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/* Each control block in a slab is preceded by a pointer to the slab, so
+ * vSlabFree() can find the slab in constant time.  While a control block is
+ * free its first bytes hold a pointer to the next free control block in the
+ * same slab. */
+    #define slabOBJECT_HEADER_SIZE    slabALIGN_SIZE( sizeof( struct xSLAB * ) )
+
+/*-----------------------------------------------------------*/
+
+/* The structure placed at the start of each slab, followed by the slab's
+ * control blocks. */
+    typedef struct xSLAB
+    {
+        struct xSLAB * pxNextSlab;         /*<< The next slab in the cache's list of slabs that have free control blocks. */
+        struct xSLAB * pxPreviousSlab;     /*<< The previous slab in the cache's list of slabs that have free control blocks. */
+        struct xSLAB_CACHE * pxCache;      /*<< The cache to which the slab belongs. */
+        void * pvFreeObjects;              /*<< The first free control block in the slab. */
+        UBaseType_t uxNumberOfFreeObjects; /*<< The number of free control blocks in the slab. */
+    } Slab_t;
+
+    typedef struct xSLAB_CACHE
+    {
+        size_t xObjectSize;                    /*<< The size of each control block, set by the first allocation. */
+        Slab_t * pxAvailableSlabs;             /*<< The slabs that have at least one free control block. */
+        UBaseType_t uxNumberOfSlabs;           /*<< The number of slabs allocated from the heap. */
+        UBaseType_t uxNumberOfEmptySlabs;      /*<< The number of slabs in which every control block is free. */
+        UBaseType_t uxObjectsInUse;            /*<< The number of control blocks in use. */
+        UBaseType_t uxMaximumObjectsInUse;     /*<< The maximum number of control blocks there have been in use. */
+        size_t xNumberOfSuccessfulAllocations; /*<< The number of calls to pvSlabAllocate() that returned a control block. */
+        size_t xNumberOfSuccessfulFrees;       /*<< The number of calls to vSlabFree(). */
+    } SlabCache_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Allocate a new slab for a cache from the heap and link its control blocks
+ * into the slab's free list.  Returns NULL if the heap does not have enough
+ * space.  The heap is not used with the scheduler suspended, so the slab is
+ * added to the cache separately by prvAddSlab().
+ */
+    static Slab_t * prvCreateSlab( SlabCache_t * const pxCache ) PRIVILEGED_FUNCTION;
+
+/*
+ * Add a slab created by prvCreateSlab() to its cache.  Must be called with the
+ * scheduler suspended.
+ */
+    static void prvAddSlab( Slab_t * const pxSlab ) PRIVILEGED_FUNCTION;
+
+/*
+ * Take a control block from the first slab of a cache that has a free control
+ * block.  Returns NULL if no slab has a free control block.  Must be called
+ * with the scheduler suspended.
+ */
+    static void * prvTakeObject( SlabCache_t * const pxCache ) PRIVILEGED_FUNCTION;
+
+/*
+ * Add a slab to, and remove a slab from, the list of slabs of its cache that
+ * have free control blocks.
+ */
+    static void prvInsertAvailableSlab( Slab_t * const pxSlab ) PRIVILEGED_FUNCTION;
+    static void prvRemoveAvailableSlab( Slab_t * const pxSlab ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+/* The size of the structure at the start of each slab must be correctly byte
+ * aligned. */
+    static const size_t xSlabStructSize = slabALIGN_SIZE( sizeof( Slab_t ) );
+
+    PRIVILEGED_DATA static SlabCache_t xSlabCaches[ slabNUMBER_OF_CACHES ];
+
+/*-----------------------------------------------------------*/
+
+    void * pvSlabAllocate( eSlabCache eCache,
+                           size_t xObjectSize )
+    {
+        SlabCache_t * pxCache;
+        Slab_t * pxSlab;
+        void * pvReturn;
+
+        configASSERT( ( UBaseType_t ) eCache < slabNUMBER_OF_CACHES );
+        configASSERT( xObjectSize > ( size_t ) 0 );
+
+        pxCache = &( xSlabCaches[ eCache ] );
+
+        vTaskSuspendAll();
+        {
+            if( pxCache->xObjectSize == ( size_t ) 0 )
+            {
+                pxCache->xObjectSize = xObjectSize;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            configASSERT( pxCache->xObjectSize == xObjectSize );
+
+            pvReturn = prvTakeObject( pxCache );
+        }
+        ( void ) xTaskResumeAll();
+
+        if( pvReturn == NULL )
+        {
+            /* No slab has a free control block, so allocate another slab from
+             * the heap with the scheduler running. */
+            pxSlab = prvCreateSlab( pxCache );
+
+            if( pxSlab != NULL )
+            {
+                vTaskSuspendAll();
+                {
+                    prvAddSlab( pxSlab );
+                    pvReturn = prvTakeObject( pxCache );
+                }
+                ( void ) xTaskResumeAll();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pvReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void vSlabFree( void * pv )
+    {
+        Slab_t * pxSlab;
+        Slab_t * pxSlabToFree = NULL;
+        SlabCache_t * pxCache;
+
+        configASSERT( pv );
+
+        /* The slab that holds the control block is recorded immediately before
+         * it. */
+        pxSlab = *( ( Slab_t ** ) ( ( ( uint8_t * ) pv ) - slabOBJECT_HEADER_SIZE ) ); /*lint !e9087 !e9079 The pointer was stored by prvCreateSlab() so is known to be correctly aligned. */
+        pxCache = pxSlab->pxCache;
+
+        configASSERT( pxSlab->uxNumberOfFreeObjects < ( UBaseType_t ) configSLAB_CACHE_OBJECTS_PER_SLAB );
+
+        vTaskSuspendAll();
+        {
+            *( ( void ** ) pv ) = pxSlab->pvFreeObjects;
+            pxSlab->pvFreeObjects = pv;
+
+            if( pxSlab->uxNumberOfFreeObjects == ( UBaseType_t ) 0 )
+            {
+                prvInsertAvailableSlab( pxSlab );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxSlab->uxNumberOfFreeObjects++;
+            pxCache->uxObjectsInUse--;
+            pxCache->xNumberOfSuccessfulFrees++;
+
+            if( pxSlab->uxNumberOfFreeObjects == ( UBaseType_t ) configSLAB_CACHE_OBJECTS_PER_SLAB )
+            {
+                /* Keep one empty slab so creating and deleting an object does
+                 * not allocate and free a slab each time, but return any other
+                 * empty slab to the heap. */
+                if( pxCache->uxNumberOfEmptySlabs > ( UBaseType_t ) 0 )
+                {
+                    prvRemoveAvailableSlab( pxSlab );
+                    pxCache->uxNumberOfSlabs--;
+                    pxSlabToFree = pxSlab;
+                }
+                else
+                {
+                    pxCache->uxNumberOfEmptySlabs++;
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        if( pxSlabToFree != NULL )
+        {
+            vPortFree( pxSlabToFree );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static Slab_t * prvCreateSlab( SlabCache_t * const pxCache )
+    {
+        Slab_t * pxSlab;
+        uint8_t * pucObject;
+        size_t xObjectStride;
+        UBaseType_t uxObject;
+
+        xObjectStride = slabOBJECT_HEADER_SIZE + slabALIGN_SIZE( pxCache->xObjectSize );
+        pxSlab = ( Slab_t * ) pvPortMalloc( xSlabStructSize + ( xObjectStride * ( size_t ) configSLAB_CACHE_OBJECTS_PER_SLAB ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of Slab_t is a pointer. */
+
+        if( pxSlab != NULL )
+        {
+            pxSlab->pxCache = pxCache;
+            pxSlab->pvFreeObjects = NULL;
+            pxSlab->uxNumberOfFreeObjects = ( UBaseType_t ) configSLAB_CACHE_OBJECTS_PER_SLAB;
+
+            /* Record the slab before each control block and link the control
+             * blocks into the slab's free list, last first so they are
+             * allocated in address order. */
+            pucObject = ( ( uint8_t * ) pxSlab ) + xSlabStructSize + ( xObjectStride * ( size_t ) configSLAB_CACHE_OBJECTS_PER_SLAB );
+
+            for( uxObject = 0; uxObject < ( UBaseType_t ) configSLAB_CACHE_OBJECTS_PER_SLAB; uxObject++ )
+            {
+                pucObject -= xObjectStride;
+                *( ( Slab_t ** ) pucObject ) = pxSlab; /*lint !e9087 !e9079 The stride is a multiple of portBYTE_ALIGNMENT. */
+                *( ( void ** ) ( pucObject + slabOBJECT_HEADER_SIZE ) ) = pxSlab->pvFreeObjects;
+                pxSlab->pvFreeObjects = ( void * ) ( pucObject + slabOBJECT_HEADER_SIZE );
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pxSlab;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvAddSlab( Slab_t * const pxSlab )
+    {
+        SlabCache_t * const pxCache = pxSlab->pxCache;
+
+        pxCache->uxNumberOfSlabs++;
+        pxCache->uxNumberOfEmptySlabs++;
+        prvInsertAvailableSlab( pxSlab );
+    }
+/*-----------------------------------------------------------*/
+
+    static void * prvTakeObject( SlabCache_t * const pxCache )
+    {
+        Slab_t * const pxSlab = pxCache->pxAvailableSlabs;
+        void * pvReturn = NULL;
+
+        if( pxSlab != NULL )
+        {
+            pvReturn = pxSlab->pvFreeObjects;
+            pxSlab->pvFreeObjects = *( ( void ** ) pvReturn );
+
+            if( pxSlab->uxNumberOfFreeObjects == ( UBaseType_t ) configSLAB_CACHE_OBJECTS_PER_SLAB )
+            {
+                pxCache->uxNumberOfEmptySlabs--;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxSlab->uxNumberOfFreeObjects--;
+
+            if( pxSlab->uxNumberOfFreeObjects == ( UBaseType_t ) 0 )
+            {
+                prvRemoveAvailableSlab( pxSlab );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxCache->uxObjectsInUse++;
+
+            if( pxCache->uxObjectsInUse > pxCache->uxMaximumObjectsInUse )
+            {
+                pxCache->uxMaximumObjectsInUse = pxCache->uxObjectsInUse;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxCache->xNumberOfSuccessfulAllocations++;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pvReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvInsertAvailableSlab( Slab_t * const pxSlab )
+    {
+        SlabCache_t * const pxCache = pxSlab->pxCache;
+
+        pxSlab->pxPreviousSlab = NULL;
+        pxSlab->pxNextSlab = pxCache->pxAvailableSlabs;
+
+        if( pxCache->pxAvailableSlabs != NULL )
+        {
+            pxCache->pxAvailableSlabs->pxPreviousSlab = pxSlab;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxCache->pxAvailableSlabs = pxSlab;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvRemoveAvailableSlab( Slab_t * const pxSlab )
+    {
+        SlabCache_t * const pxCache = pxSlab->pxCache;
+
+        if( pxSlab->pxPreviousSlab != NULL )
+        {
+            pxSlab->pxPreviousSlab->pxNextSlab = pxSlab->pxNextSlab;
+        }
+        else
+        {
+            pxCache->pxAvailableSlabs = pxSlab->pxNextSlab;
+        }
+
+        if( pxSlab->pxNextSlab != NULL )
+        {
+            pxSlab->pxNextSlab->pxPreviousSlab = pxSlab->pxPreviousSlab;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vSlabGetStats( eSlabCache eCache,
+                        SlabStats_t * pxSlabStats )
+    {
+        const SlabCache_t * pxCache;
+
+        configASSERT( ( UBaseType_t ) eCache < slabNUMBER_OF_CACHES );
+        configASSERT( pxSlabStats );
+
+        pxCache = &( xSlabCaches[ eCache ] );
+
+        vTaskSuspendAll();
+        {
+            pxSlabStats->xObjectSize = pxCache->xObjectSize;
+            pxSlabStats->uxObjectsPerSlab = ( UBaseType_t ) configSLAB_CACHE_OBJECTS_PER_SLAB;
+            pxSlabStats->uxNumberOfSlabs = pxCache->uxNumberOfSlabs;
+            pxSlabStats->uxObjectsInUse = pxCache->uxObjectsInUse;
+            pxSlabStats->uxMaximumObjectsInUse = pxCache->uxMaximumObjectsInUse;
+            pxSlabStats->xNumberOfSuccessfulAllocations = pxCache->xNumberOfSuccessfulAllocations;
+            pxSlabStats->xNumberOfSuccessfulFrees = pxCache->xNumberOfSuccessfulFrees;
+        }
+        ( void ) xTaskResumeAll();
+    }
+
+/* This entire source file will be skipped if the application is not configured
+ * to use slab caches.  If you want to use slab caches then ensure
+ * configUSE_SLAB_CACHES is set to 1 in FreeRTOSConfig.h. */
+#endif /* configUSE_SLAB_CACHES == 1 */
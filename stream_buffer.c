@@ -135,16 +135,94 @@
 /* Bits stored in the ucFlags field of the stream buffer. */
 #define sbFLAGS_IS_MESSAGE_BUFFER          ( ( uint8_t ) 1 ) /* Set if the stream buffer was created as a message buffer, in which case it holds discrete messages rather than a stream. */
 #define sbFLAGS_IS_STATICALLY_ALLOCATED    ( ( uint8_t ) 2 ) /* Set if the stream buffer was created using statically allocated memory. */
+#define sbFLAGS_IS_POWER_OF_TWO_RING       ( ( uint8_t ) 4 ) /* Set if the buffer length is a power of two, in which case xHead and xTail are free running counters that are masked to index the buffer. */
+#define sbFLAGS_IS_SHARED                  ( ( uint8_t ) 8 ) /* Set if the stream buffer lives in memory shared with another FreeRTOS instance, in which case the reader and writer are in different instances. */
+
+/* Power of two rings use the whole storage area, so can hold xLength bytes.
+ * Other stream buffers keep one byte free to distinguish a full buffer from an
+ * empty buffer, so can hold xLength - 1 bytes. */
+#define sbIS_POWER_OF_TWO_RING( pxStreamBuffer )    ( ( ( pxStreamBuffer )->ucFlags & sbFLAGS_IS_POWER_OF_TWO_RING ) != ( uint8_t ) 0 )
+
+#if ( configUSE_SHARED_STREAM_BUFFERS == 1 )
+
+/* The storage area of a shared stream buffer immediately follows the
+ * structure.  Each FreeRTOS instance may map the shared memory at a different
+ * address, so the storage area is located relative to the structure rather than
+ * through pucBuffer, which holds an address in the creating instance. */
+    #define sbGET_STORAGE_AREA( pxStreamBuffer )                                   \
+    ( ( ( ( pxStreamBuffer )->ucFlags & sbFLAGS_IS_SHARED ) != ( uint8_t ) 0 ) ? \
+      ( ( uint8_t * ) &( ( pxStreamBuffer )[ 1 ] ) ) : ( pxStreamBuffer )->pucBuffer )
+
+/* The task handles held in a shared stream buffer are only meaningful to the
+ * FreeRTOS instance that set them, so the instance that completes a send or
+ * receive asks the port to interrupt the other instance, which then unblocks its
+ * own task by calling xStreamBufferSendCompletedFromISR() or
+ * xStreamBufferReceiveCompletedFromISR(). */
+    #define sbNOTIFY_SEND_COMPLETED( pxStreamBuffer )                              \
+    do {                                                                           \
+        if( ( ( pxStreamBuffer )->ucFlags & sbFLAGS_IS_SHARED ) != ( uint8_t ) 0 ) \
+        {                                                                          \
+            portSTREAM_BUFFER_SHARED_SEND_COMPLETED( pxStreamBuffer );             \
+        }                                                                          \
+        else                                                                       \
+        {                                                                          \
+            sbSEND_COMPLETED( pxStreamBuffer );                                    \
+        }                                                                          \
+    } while( 0 )
+
+    #define sbNOTIFY_SEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken ) \
+    do {                                                                                 \
+        if( ( ( pxStreamBuffer )->ucFlags & sbFLAGS_IS_SHARED ) != ( uint8_t ) 0 )       \
+        {                                                                                \
+            portSTREAM_BUFFER_SHARED_SEND_COMPLETED( pxStreamBuffer );                   \
+        }                                                                                \
+        else                                                                             \
+        {                                                                                \
+            sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );       \
+        }                                                                                \
+    } while( 0 )
+
+    #define sbNOTIFY_RECEIVE_COMPLETED( pxStreamBuffer )                           \
+    do {                                                                           \
+        if( ( ( pxStreamBuffer )->ucFlags & sbFLAGS_IS_SHARED ) != ( uint8_t ) 0 ) \
+        {                                                                          \
+            portSTREAM_BUFFER_SHARED_RECEIVE_COMPLETED( pxStreamBuffer );          \
+        }                                                                          \
+        else                                                                       \
+        {                                                                          \
+            sbRECEIVE_COMPLETED( pxStreamBuffer );                                 \
+        }                                                                          \
+    } while( 0 )
+
+    #define sbNOTIFY_RECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken ) \
+    do {                                                                                     \
+        if( ( ( pxStreamBuffer )->ucFlags & sbFLAGS_IS_SHARED ) != ( uint8_t ) 0 )           \
+        {                                                                                    \
+            portSTREAM_BUFFER_SHARED_RECEIVE_COMPLETED( pxStreamBuffer );                    \
+        }                                                                                    \
+        else                                                                                 \
+        {                                                                                    \
+            sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );       \
+        }                                                                                    \
+    } while( 0 )
+#else /* if ( configUSE_SHARED_STREAM_BUFFERS == 1 ) */
+    #define sbGET_STORAGE_AREA( pxStreamBuffer )                                             ( ( pxStreamBuffer )->pucBuffer )
+    #define sbNOTIFY_SEND_COMPLETED( pxStreamBuffer )                                        sbSEND_COMPLETED( pxStreamBuffer )
+    #define sbNOTIFY_SEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken )     sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken )
+    #define sbNOTIFY_RECEIVE_COMPLETED( pxStreamBuffer )                                     sbRECEIVE_COMPLETED( pxStreamBuffer )
+    #define sbNOTIFY_RECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken ) sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken )
+#endif /* configUSE_SHARED_STREAM_BUFFERS */
 
 /*-----------------------------------------------------------*/
 
 /* Structure that hold state information on the buffer. */
 typedef struct StreamBufferDef_t                 /*lint !e9058 Style convention uses tag. */
 {
-    volatile size_t xTail;                       /* Index to the next item to read within the buffer. */
-    volatile size_t xHead;                       /* Index to the next item to write within the buffer. */
+    volatile size_t xTail;                       /* Index to the next item to read within the buffer, or a free running read counter if the buffer is a power of two ring. */
+    volatile size_t xHead;                       /* Index to the next item to write within the buffer, or a free running write counter if the buffer is a power of two ring. */
     size_t xLength;                              /* The length of the buffer pointed to by pucBuffer. */
     size_t xTriggerLevelBytes;                   /* The number of bytes that must be in the stream buffer before a task that is waiting for data is unblocked. */
+    size_t xSpaceTriggerLevelBytes;              /* The number of bytes that must be free in the stream buffer before a task that is waiting for space is unblocked. */
     volatile TaskHandle_t xTaskWaitingToReceive; /* Holds the handle of a task waiting for data, or NULL if no tasks are waiting. */
     volatile TaskHandle_t xTaskWaitingToSend;    /* Holds the handle of a task waiting to send data to a message buffer that is full. */
     uint8_t * pucBuffer;                         /* Points to the buffer itself - that is - the RAM that stores the data passed through the buffer. */
@@ -234,16 +312,19 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 
     StreamBufferHandle_t xStreamBufferGenericCreate( size_t xBufferSizeBytes,
                                                      size_t xTriggerLevelBytes,
-                                                     BaseType_t xIsMessageBuffer )
+                                                     BaseType_t xStreamBufferType )
     {
         uint8_t * pucAllocatedMemory;
+        uint8_t * pucStorageArea = NULL;
+        size_t xAlignmentBytes = ( size_t ) 0;
         uint8_t ucFlags;
+        StreamBuffer_t * pxStreamBuffer = NULL;
 
         /* In case the stream buffer is going to be used as a message buffer
          * (that is, it will hold discrete messages with a little meta data that
          * says how big the next message is) check the buffer will be large enough
          * to hold at least one message. */
-        if( xIsMessageBuffer == pdTRUE )
+        if( ( xStreamBufferType & sbTYPE_MESSAGE_BUFFER ) != ( BaseType_t ) 0 )
         {
             /* Is a message buffer but not statically allocated. */
             ucFlags = sbFLAGS_IS_MESSAGE_BUFFER;
@@ -265,40 +346,109 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
             xTriggerLevelBytes = ( size_t ) 1;
         }
 
-        /* A stream buffer requires a StreamBuffer_t structure and a buffer.
-         * Both are allocated in a single call to pvPortMalloc().  The
-         * StreamBuffer_t structure is placed at the start of the allocated memory
-         * and the buffer follows immediately after.  The requested size is
-         * incremented so the free space is returned as the user would expect -
-         * this is a quirk of the implementation that means otherwise the free
-         * space would be reported as one byte smaller than would be logically
-         * expected. */
-        if( xBufferSizeBytes < ( xBufferSizeBytes + 1 + sizeof( StreamBuffer_t ) ) )
+        if( ( xStreamBufferType & sbTYPE_FLAG_POWER_OF_TWO_RING ) != ( BaseType_t ) 0 )
         {
-            xBufferSizeBytes++;
-            pucAllocatedMemory = ( uint8_t * ) pvPortMalloc( xBufferSizeBytes + sizeof( StreamBuffer_t ) ); /*lint !e9079 malloc() only returns void*. */
+            /* The head and tail counters are masked with ( xBufferSizeBytes - 1 )
+             * so the length must be a power of two.  The whole storage area is
+             * usable, so the length is not incremented, but the storage area is
+             * aligned to configSTREAM_BUFFER_STORAGE_ALIGNMENT. */
+            configASSERT( ( xBufferSizeBytes & ( xBufferSizeBytes - ( size_t ) 1 ) ) == ( size_t ) 0 );
+            ucFlags |= sbFLAGS_IS_POWER_OF_TWO_RING;
+
+            #if ( configUSE_ALIGNED_HEAP_ALLOCATION == 1 )
+            {
+                /* The storage area is placed at the start of an aligned block
+                 * of memory, and the structure follows it, rounded up to a
+                 * portBYTE_ALIGNMENT boundary.  The handle points to the
+                 * structure, so vStreamBufferDelete() frees the block through
+                 * the structure's pointer to the storage area. */
+                xAlignmentBytes = ( ( size_t ) 0 - xBufferSizeBytes ) & ( size_t ) portBYTE_ALIGNMENT_MASK;
+
+                if( xBufferSizeBytes < ( xBufferSizeBytes + xAlignmentBytes + sizeof( StreamBuffer_t ) ) )
+                {
+                    pucAllocatedMemory = ( uint8_t * ) pvPortMallocAligned( xBufferSizeBytes + xAlignmentBytes + sizeof( StreamBuffer_t ), ( size_t ) configSTREAM_BUFFER_STORAGE_ALIGNMENT ); /*lint !e9079 malloc() only returns void*. */
+                }
+                else
+                {
+                    pucAllocatedMemory = NULL;
+                }
+
+                if( pucAllocatedMemory != NULL )
+                {
+                    pucStorageArea = pucAllocatedMemory;
+                    pxStreamBuffer = ( StreamBuffer_t * ) ( pucAllocatedMemory + xBufferSizeBytes + xAlignmentBytes ); /*lint !e9087 !e826 Safe cast as the structure is placed at an aligned offset. */
+                }
+            }
+            #else /* if ( configUSE_ALIGNED_HEAP_ALLOCATION == 1 ) */
+            {
+                /* The storage area follows the structure, and up to
+                 * ( configSTREAM_BUFFER_STORAGE_ALIGNMENT - 1 ) padding bytes
+                 * are allocated so it can be aligned. */
+                xAlignmentBytes = ( size_t ) configSTREAM_BUFFER_STORAGE_ALIGNMENT - ( size_t ) 1;
+
+                if( xBufferSizeBytes < ( xBufferSizeBytes + xAlignmentBytes + sizeof( StreamBuffer_t ) ) )
+                {
+                    pucAllocatedMemory = ( uint8_t * ) pvPortMalloc( xBufferSizeBytes + xAlignmentBytes + sizeof( StreamBuffer_t ) ); /*lint !e9079 malloc() only returns void*. */
+                }
+                else
+                {
+                    pucAllocatedMemory = NULL;
+                }
+
+                if( pucAllocatedMemory != NULL )
+                {
+                    /* Round the start of the storage area, which follows the
+                     * structure, up to the next aligned address. */
+                    pucStorageArea = pucAllocatedMemory + sizeof( StreamBuffer_t );
+                    pucStorageArea += ( ( size_t ) 0 - ( size_t ) ( portPOINTER_SIZE_TYPE ) pucStorageArea ) & xAlignmentBytes; /*lint !e923 !e9078 Address arithmetic is used to align the storage area. */
+                    pxStreamBuffer = ( StreamBuffer_t * ) pucAllocatedMemory; /*lint !e9087 !e826 Safe cast as allocated memory is aligned. */
+                }
+            }
+            #endif /* if ( configUSE_ALIGNED_HEAP_ALLOCATION == 1 ) */
         }
         else
         {
-            pucAllocatedMemory = NULL;
+            /* A stream buffer requires a StreamBuffer_t structure and a buffer.
+             * Both are allocated in a single call to pvPortMalloc().  The
+             * StreamBuffer_t structure is placed at the start of the allocated memory
+             * and the buffer follows immediately after.  The requested size is
+             * incremented so the free space is returned as the user would expect -
+             * this is a quirk of the implementation that means otherwise the free
+             * space would be reported as one byte smaller than would be logically
+             * expected. */
+            if( xBufferSizeBytes < ( xBufferSizeBytes + 1 + sizeof( StreamBuffer_t ) ) )
+            {
+                xBufferSizeBytes++;
+                pucAllocatedMemory = ( uint8_t * ) pvPortMalloc( xBufferSizeBytes + sizeof( StreamBuffer_t ) ); /*lint !e9079 malloc() only returns void*. */
+            }
+            else
+            {
+                pucAllocatedMemory = NULL;
+            }
+
+            if( pucAllocatedMemory != NULL )
+            {
+                pucStorageArea = pucAllocatedMemory + sizeof( StreamBuffer_t ); /*lint !e9016 Indexing past structure valid for uint8_t pointer, also storage area has no alignment requirement. */
+                pxStreamBuffer = ( StreamBuffer_t * ) pucAllocatedMemory;        /*lint !e9087 Safe cast as allocated memory is aligned. */ /*lint !e826 Area is not too small and alignment is guaranteed provided malloc() behaves as expected and returns aligned buffer. */
+            }
         }
 
-        if( pucAllocatedMemory != NULL )
+        if( pxStreamBuffer != NULL )
         {
-            prvInitialiseNewStreamBuffer( ( StreamBuffer_t * ) pucAllocatedMemory,       /* Structure at the start of the allocated memory. */ /*lint !e9087 Safe cast as allocated memory is aligned. */ /*lint !e826 Area is not too small and alignment is guaranteed provided malloc() behaves as expected and returns aligned buffer. */
-                                          pucAllocatedMemory + sizeof( StreamBuffer_t ), /* Storage area follows. */ /*lint !e9016 Indexing past structure valid for uint8_t pointer, also storage area has no alignment requirement. */
+            prvInitialiseNewStreamBuffer( pxStreamBuffer,
+                                          pucStorageArea,
                                           xBufferSizeBytes,
                                           xTriggerLevelBytes,
                                           ucFlags );
 
-            traceSTREAM_BUFFER_CREATE( ( ( StreamBuffer_t * ) pucAllocatedMemory ), xIsMessageBuffer );
+            traceSTREAM_BUFFER_CREATE( pxStreamBuffer, ( xStreamBufferType & sbTYPE_MESSAGE_BUFFER ) );
         }
         else
         {
-            traceSTREAM_BUFFER_CREATE_FAILED( xIsMessageBuffer );
+            traceSTREAM_BUFFER_CREATE_FAILED( ( xStreamBufferType & sbTYPE_MESSAGE_BUFFER ) );
         }
 
-        return ( StreamBufferHandle_t ) pucAllocatedMemory; /*lint !e9087 !e826 Safe cast as allocated memory is aligned. */
+        return ( StreamBufferHandle_t ) pxStreamBuffer;
     }
 
 #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
@@ -308,7 +458,7 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 
     StreamBufferHandle_t xStreamBufferGenericCreateStatic( size_t xBufferSizeBytes,
                                                            size_t xTriggerLevelBytes,
-                                                           BaseType_t xIsMessageBuffer,
+                                                           BaseType_t xStreamBufferType,
                                                            uint8_t * const pucStreamBufferStorageArea,
                                                            StaticStreamBuffer_t * const pxStaticStreamBuffer )
     {
@@ -327,7 +477,7 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
             xTriggerLevelBytes = ( size_t ) 1;
         }
 
-        if( xIsMessageBuffer != pdFALSE )
+        if( ( xStreamBufferType & sbTYPE_MESSAGE_BUFFER ) != ( BaseType_t ) 0 )
         {
             /* Statically allocated message buffer. */
             ucFlags = sbFLAGS_IS_MESSAGE_BUFFER | sbFLAGS_IS_STATICALLY_ALLOCATED;
@@ -338,6 +488,14 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
             ucFlags = sbFLAGS_IS_STATICALLY_ALLOCATED;
         }
 
+        if( ( xStreamBufferType & sbTYPE_FLAG_POWER_OF_TWO_RING ) != ( BaseType_t ) 0 )
+        {
+            /* The head and tail counters are masked with ( xBufferSizeBytes - 1 )
+             * so the length must be a power of two. */
+            configASSERT( ( xBufferSizeBytes & ( xBufferSizeBytes - ( size_t ) 1 ) ) == ( size_t ) 0 );
+            ucFlags |= sbFLAGS_IS_POWER_OF_TWO_RING;
+        }
+
         /* In case the stream buffer is going to be used as a message buffer
          * (that is, it will hold discrete messages with a little meta data that
          * says how big the next message is) check the buffer will be large enough
@@ -366,14 +524,14 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
              * again. */
             pxStreamBuffer->ucFlags |= sbFLAGS_IS_STATICALLY_ALLOCATED;
 
-            traceSTREAM_BUFFER_CREATE( pxStreamBuffer, xIsMessageBuffer );
+            traceSTREAM_BUFFER_CREATE( pxStreamBuffer, ( xStreamBufferType & sbTYPE_MESSAGE_BUFFER ) );
 
             xReturn = ( StreamBufferHandle_t ) pxStaticStreamBuffer; /*lint !e9087 Data hiding requires cast to opaque type. */
         }
         else
         {
             xReturn = NULL;
-            traceSTREAM_BUFFER_CREATE_STATIC_FAILED( xReturn, xIsMessageBuffer );
+            traceSTREAM_BUFFER_CREATE_STATIC_FAILED( xReturn, ( xStreamBufferType & sbTYPE_MESSAGE_BUFFER ) );
         }
 
         return xReturn;
@@ -382,6 +540,96 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 #endif /* ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_SHARED_STREAM_BUFFERS == 1 )
+
+    StreamBufferHandle_t xStreamBufferGenericCreateShared( size_t xBufferSizeBytes,
+                                                           size_t xTriggerLevelBytes,
+                                                           BaseType_t xStreamBufferType,
+                                                           void * const pvSharedMemory )
+    {
+        StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) pvSharedMemory; /*lint !e9079 !e9087 The shared memory is required to be aligned for a StreamBuffer_t. */
+        uint8_t ucFlags;
+
+        configASSERT( pvSharedMemory );
+        configASSERT( xTriggerLevelBytes <= xBufferSizeBytes );
+        configASSERT( ( ( ( portPOINTER_SIZE_TYPE ) pvSharedMemory ) & ( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) ) == ( portPOINTER_SIZE_TYPE ) 0 ); /*lint !e923 Cast is only used to check alignment. */
+
+        /* A trigger level of 0 would cause a waiting task to unblock even when
+         * the buffer was empty. */
+        if( xTriggerLevelBytes == ( size_t ) 0 )
+        {
+            xTriggerLevelBytes = ( size_t ) 1;
+        }
+
+        /* The shared memory is owned by the application so must never be
+         * passed to vPortFree(), hence it is marked as statically allocated. */
+        ucFlags = sbFLAGS_IS_SHARED | sbFLAGS_IS_STATICALLY_ALLOCATED;
+
+        if( ( xStreamBufferType & sbTYPE_MESSAGE_BUFFER ) != ( BaseType_t ) 0 )
+        {
+            ucFlags |= sbFLAGS_IS_MESSAGE_BUFFER;
+            configASSERT( xBufferSizeBytes > sbBYTES_TO_STORE_MESSAGE_LENGTH );
+        }
+        else
+        {
+            configASSERT( xBufferSizeBytes > 0 );
+        }
+
+        if( ( xStreamBufferType & sbTYPE_FLAG_POWER_OF_TWO_RING ) != ( BaseType_t ) 0 )
+        {
+            configASSERT( ( xBufferSizeBytes & ( xBufferSizeBytes - ( size_t ) 1 ) ) == ( size_t ) 0 );
+            ucFlags |= sbFLAGS_IS_POWER_OF_TWO_RING;
+        }
+
+        if( pvSharedMemory != NULL )
+        {
+            /* The storage area follows the structure in the shared memory. */
+            prvInitialiseNewStreamBuffer( pxStreamBuffer,
+                                          ( uint8_t * ) &( pxStreamBuffer[ 1 ] ),
+                                          xBufferSizeBytes,
+                                          xTriggerLevelBytes,
+                                          ucFlags );
+
+            traceSTREAM_BUFFER_CREATE( pxStreamBuffer, ( xStreamBufferType & sbTYPE_MESSAGE_BUFFER ) );
+        }
+        else
+        {
+            traceSTREAM_BUFFER_CREATE_FAILED( ( xStreamBufferType & sbTYPE_MESSAGE_BUFFER ) );
+        }
+
+        return ( StreamBufferHandle_t ) pxStreamBuffer;
+    }
+
+#endif /* configUSE_SHARED_STREAM_BUFFERS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_SHARED_STREAM_BUFFERS == 1 )
+
+    StreamBufferHandle_t xStreamBufferOpenShared( void * const pvSharedMemory )
+    {
+        StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) pvSharedMemory; /*lint !e9079 !e9087 The shared memory is required to be aligned for a StreamBuffer_t. */
+        StreamBufferHandle_t xReturn;
+
+        configASSERT( pvSharedMemory );
+
+        /* The structure was initialised by the FreeRTOS instance that created
+         * the stream buffer, so just check it is a shared stream buffer and use
+         * its local address as the handle. */
+        if( ( pxStreamBuffer != NULL ) && ( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_SHARED ) != ( uint8_t ) 0 ) )
+        {
+            xReturn = ( StreamBufferHandle_t ) pxStreamBuffer;
+        }
+        else
+        {
+            xReturn = NULL;
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_SHARED_STREAM_BUFFERS */
+/*-----------------------------------------------------------*/
+
 void vStreamBufferDelete( StreamBufferHandle_t xStreamBuffer )
 {
     StreamBuffer_t * pxStreamBuffer = xStreamBuffer;
@@ -394,9 +642,27 @@ void vStreamBufferDelete( StreamBufferHandle_t xStreamBuffer )
     {
         #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
         {
-            /* Both the structure and the buffer were allocated using a single call
-            * to pvPortMalloc(), hence only one call to vPortFree() is required. */
-            vPortFree( ( void * ) pxStreamBuffer ); /*lint !e9087 Standard free() semantics require void *, plus pxStreamBuffer was allocated by pvPortMalloc(). */
+            #if ( configUSE_ALIGNED_HEAP_ALLOCATION == 1 )
+            {
+                /* The storage area of a power of two ring is at the start of
+                 * the block allocated by pvPortMallocAligned(), with the
+                 * structure after it. */
+                if( sbIS_POWER_OF_TWO_RING( pxStreamBuffer ) != pdFALSE )
+                {
+                    vPortFreeAligned( ( void * ) pxStreamBuffer->pucBuffer );
+                }
+                else
+                {
+                    vPortFree( ( void * ) pxStreamBuffer ); /*lint !e9087 Standard free() semantics require void *, plus pxStreamBuffer was allocated by pvPortMalloc(). */
+                }
+            }
+            #else
+            {
+                /* Both the structure and the buffer were allocated using a single call
+                * to pvPortMalloc(), hence only one call to vPortFree() is required. */
+                vPortFree( ( void * ) pxStreamBuffer ); /*lint !e9087 Standard free() semantics require void *, plus pxStreamBuffer was allocated by pvPortMalloc(). */
+            }
+            #endif /* if ( configUSE_ALIGNED_HEAP_ALLOCATION == 1 ) */
         }
         #else
         {
@@ -419,6 +685,7 @@ BaseType_t xStreamBufferReset( StreamBufferHandle_t xStreamBuffer )
 {
     StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
     BaseType_t xReturn = pdFAIL;
+    size_t xSpaceTriggerLevelBytes;
 
     #if ( configUSE_TRACE_FACILITY == 1 )
         UBaseType_t uxStreamBufferNumber;
@@ -441,11 +708,16 @@ BaseType_t xStreamBufferReset( StreamBufferHandle_t xStreamBuffer )
         {
             if( pxStreamBuffer->xTaskWaitingToSend == NULL )
             {
+                /* The space trigger level is not a parameter of
+                 * prvInitialiseNewStreamBuffer() so is restored after the
+                 * reset. */
+                xSpaceTriggerLevelBytes = pxStreamBuffer->xSpaceTriggerLevelBytes;
                 prvInitialiseNewStreamBuffer( pxStreamBuffer,
-                                              pxStreamBuffer->pucBuffer,
+                                              sbGET_STORAGE_AREA( pxStreamBuffer ),
                                               pxStreamBuffer->xLength,
                                               pxStreamBuffer->xTriggerLevelBytes,
                                               pxStreamBuffer->ucFlags );
+                pxStreamBuffer->xSpaceTriggerLevelBytes = xSpaceTriggerLevelBytes;
                 xReturn = pdPASS;
 
                 #if ( configUSE_TRACE_FACILITY == 1 )
@@ -479,8 +751,10 @@ BaseType_t xStreamBufferSetTriggerLevel( StreamBufferHandle_t xStreamBuffer,
     }
 
     /* The trigger level is the number of bytes that must be in the stream
-     * buffer before a task that is waiting for data is unblocked. */
-    if( xTriggerLevel < pxStreamBuffer->xLength )
+     * buffer before a task that is waiting for data is unblocked, so cannot be
+     * more than the capacity of the buffer. */
+    if( ( xTriggerLevel < pxStreamBuffer->xLength ) ||
+        ( ( sbIS_POWER_OF_TWO_RING( pxStreamBuffer ) != pdFALSE ) && ( xTriggerLevel == pxStreamBuffer->xLength ) ) )
     {
         pxStreamBuffer->xTriggerLevelBytes = xTriggerLevel;
         xReturn = pdPASS;
@@ -494,6 +768,38 @@ BaseType_t xStreamBufferSetTriggerLevel( StreamBufferHandle_t xStreamBuffer,
 }
 /*-----------------------------------------------------------*/
 
+BaseType_t xStreamBufferSetSpaceTriggerLevel( StreamBufferHandle_t xStreamBuffer,
+                                              size_t xTriggerLevel )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    BaseType_t xReturn;
+
+    configASSERT( pxStreamBuffer );
+
+    /* It is not valid for the trigger level to be 0. */
+    if( xTriggerLevel == ( size_t ) 0 )
+    {
+        xTriggerLevel = ( size_t ) 1;
+    }
+
+    /* The space trigger level is the number of bytes that must be free in the
+     * stream buffer before a task that is waiting for space is unblocked, so
+     * cannot be more than the capacity of the buffer. */
+    if( ( xTriggerLevel < pxStreamBuffer->xLength ) ||
+        ( ( sbIS_POWER_OF_TWO_RING( pxStreamBuffer ) != pdFALSE ) && ( xTriggerLevel == pxStreamBuffer->xLength ) ) )
+    {
+        pxStreamBuffer->xSpaceTriggerLevelBytes = xTriggerLevel;
+        xReturn = pdPASS;
+    }
+    else
+    {
+        xReturn = pdFALSE;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
 size_t xStreamBufferSpacesAvailable( StreamBufferHandle_t xStreamBuffer )
 {
     const StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
@@ -502,25 +808,41 @@ size_t xStreamBufferSpacesAvailable( StreamBufferHandle_t xStreamBuffer )
 
     configASSERT( pxStreamBuffer );
 
-    /* The code below reads xTail and then xHead.  This is safe if the stream
-     * buffer is updated once between the two reads - but not if the stream buffer
-     * is updated more than once between the two reads - hence the loop. */
-    do
-    {
-        xOriginalTail = pxStreamBuffer->xTail;
-        xSpace = pxStreamBuffer->xLength + pxStreamBuffer->xTail;
-        xSpace -= pxStreamBuffer->xHead;
-    } while( xOriginalTail != pxStreamBuffer->xTail );
-
-    xSpace -= ( size_t ) 1;
-
-    if( xSpace >= pxStreamBuffer->xLength )
+    if( sbIS_POWER_OF_TWO_RING( pxStreamBuffer ) != pdFALSE )
     {
-        xSpace -= pxStreamBuffer->xLength;
+        /* xHead and xTail are free running counters, so their difference is
+         * the number of bytes in the buffer even after they wrap.  A task other
+         * than the writer could see xHead move more than xLength bytes past the
+         * xTail it read first if the buffer is drained and refilled between the
+         * two reads, so xTail is read again until it is stable. */
+        do
+        {
+            xOriginalTail = pxStreamBuffer->xTail;
+            xSpace = pxStreamBuffer->xLength - ( pxStreamBuffer->xHead - xOriginalTail );
+        } while( xOriginalTail != pxStreamBuffer->xTail );
     }
     else
     {
-        mtCOVERAGE_TEST_MARKER();
+        /* The code below reads xTail and then xHead.  This is safe if the stream
+         * buffer is updated once between the two reads - but not if the stream buffer
+         * is updated more than once between the two reads - hence the loop. */
+        do
+        {
+            xOriginalTail = pxStreamBuffer->xTail;
+            xSpace = pxStreamBuffer->xLength + pxStreamBuffer->xTail;
+            xSpace -= pxStreamBuffer->xHead;
+        } while( xOriginalTail != pxStreamBuffer->xTail );
+
+        xSpace -= ( size_t ) 1;
+
+        if( xSpace >= pxStreamBuffer->xLength )
+        {
+            xSpace -= pxStreamBuffer->xLength;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
     }
 
     return xSpace;
@@ -554,8 +876,16 @@ size_t xStreamBufferSend( StreamBufferHandle_t xStreamBuffer,
     configASSERT( pxStreamBuffer );
 
     /* The maximum amount of space a stream buffer will ever report is its length
-     * minus 1. */
-    xMaxReportedSpace = pxStreamBuffer->xLength - ( size_t ) 1;
+     * minus 1, unless it is a power of two ring, which can use its entire
+     * length. */
+    if( sbIS_POWER_OF_TWO_RING( pxStreamBuffer ) != pdFALSE )
+    {
+        xMaxReportedSpace = pxStreamBuffer->xLength;
+    }
+    else
+    {
+        xMaxReportedSpace = pxStreamBuffer->xLength - ( size_t ) 1;
+    }
 
     /* This send function is used to write to both message buffers and stream
      * buffers.  If this is a message buffer then the space needed must be
@@ -653,7 +983,7 @@ size_t xStreamBufferSend( StreamBufferHandle_t xStreamBuffer,
         /* Was a task waiting for the data? */
         if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
         {
-            sbSEND_COMPLETED( pxStreamBuffer );
+            sbNOTIFY_SEND_COMPLETED( pxStreamBuffer );
         }
         else
         {
@@ -703,7 +1033,7 @@ size_t xStreamBufferSendFromISR( StreamBufferHandle_t xStreamBuffer,
         /* Was a task waiting for the data? */
         if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
         {
-            sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+            sbNOTIFY_SEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
         }
         else
         {
@@ -858,7 +1188,16 @@ size_t xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer,
         if( xReceivedLength != ( size_t ) 0 )
         {
             traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength );
-            sbRECEIVE_COMPLETED( pxStreamBuffer );
+
+            /* Only wake a writer once enough space has been freed. */
+            if( xStreamBufferSpacesAvailable( pxStreamBuffer ) >= pxStreamBuffer->xSpaceTriggerLevelBytes )
+            {
+                sbNOTIFY_RECEIVE_COMPLETED( pxStreamBuffer );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
         }
         else
         {
@@ -951,10 +1290,12 @@ size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
     {
         xReceivedLength = prvReadMessageFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes, xBytesAvailable );
 
-        /* Was a task waiting for space in the buffer? */
-        if( xReceivedLength != ( size_t ) 0 )
+        /* Was a task waiting for space in the buffer?  Only wake a writer
+         * once enough space has been freed. */
+        if( ( xReceivedLength != ( size_t ) 0 ) &&
+            ( xStreamBufferSpacesAvailable( pxStreamBuffer ) >= pxStreamBuffer->xSpaceTriggerLevelBytes ) )
         {
-            sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+            sbNOTIFY_RECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
         }
         else
         {
@@ -1150,18 +1491,30 @@ static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer,
                                      size_t xCount,
                                      size_t xHead )
 {
-    size_t xFirstLength;
+    size_t xFirstLength, xIndex;
+    uint8_t * const pucBuffer = sbGET_STORAGE_AREA( pxStreamBuffer );
 
     configASSERT( xCount > ( size_t ) 0 );
 
+    /* In a power of two ring xHead is a free running counter, so mask it to
+     * obtain the index into the buffer. */
+    if( sbIS_POWER_OF_TWO_RING( pxStreamBuffer ) != pdFALSE )
+    {
+        xIndex = xHead & ( pxStreamBuffer->xLength - ( size_t ) 1 );
+    }
+    else
+    {
+        xIndex = xHead;
+    }
+
     /* Calculate the number of bytes that can be added in the first write -
      * which may be less than the total number of bytes that need to be added if
      * the buffer will wrap back to the beginning. */
-    xFirstLength = configMIN( pxStreamBuffer->xLength - xHead, xCount );
+    xFirstLength = configMIN( pxStreamBuffer->xLength - xIndex, xCount );
 
     /* Write as many bytes as can be written in the first write. */
-    configASSERT( ( xHead + xFirstLength ) <= pxStreamBuffer->xLength );
-    ( void ) memcpy( ( void * ) ( &( pxStreamBuffer->pucBuffer[ xHead ] ) ), ( const void * ) pucData, xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+    configASSERT( ( xIndex + xFirstLength ) <= pxStreamBuffer->xLength );
+    ( void ) memcpy( ( void * ) ( &( pucBuffer[ xIndex ] ) ), ( const void * ) pucData, xFirstLength ); /*lint !e9087 memcpy() requires void *. */
 
     /* If the number of bytes written was less than the number that could be
      * written in the first write... */
@@ -1169,7 +1522,7 @@ static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer,
     {
         /* ...then write the remaining bytes to the start of the buffer. */
         configASSERT( ( xCount - xFirstLength ) <= pxStreamBuffer->xLength );
-        ( void ) memcpy( ( void * ) pxStreamBuffer->pucBuffer, ( const void * ) &( pucData[ xFirstLength ] ), xCount - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+        ( void ) memcpy( ( void * ) pucBuffer, ( const void * ) &( pucData[ xFirstLength ] ), xCount - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
     }
     else
     {
@@ -1178,7 +1531,8 @@ static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer,
 
     xHead += xCount;
 
-    if( xHead >= pxStreamBuffer->xLength )
+    /* A free running counter is allowed to run past the end of the buffer. */
+    if( ( sbIS_POWER_OF_TWO_RING( pxStreamBuffer ) == pdFALSE ) && ( xHead >= pxStreamBuffer->xLength ) )
     {
         xHead -= pxStreamBuffer->xLength;
     }
@@ -1196,37 +1550,50 @@ static size_t prvReadBytesFromBuffer( StreamBuffer_t * pxStreamBuffer,
                                       size_t xCount,
                                       size_t xTail )
 {
-    size_t xFirstLength;
+    size_t xFirstLength, xIndex;
+    uint8_t * const pucBuffer = sbGET_STORAGE_AREA( pxStreamBuffer );
 
     configASSERT( xCount != ( size_t ) 0 );
 
+    /* In a power of two ring xTail is a free running counter, so mask it to
+     * obtain the index into the buffer. */
+    if( sbIS_POWER_OF_TWO_RING( pxStreamBuffer ) != pdFALSE )
+    {
+        xIndex = xTail & ( pxStreamBuffer->xLength - ( size_t ) 1 );
+    }
+    else
+    {
+        xIndex = xTail;
+    }
+
     /* Calculate the number of bytes that can be read - which may be
      * less than the number wanted if the data wraps around to the start of
      * the buffer. */
-    xFirstLength = configMIN( pxStreamBuffer->xLength - xTail, xCount );
+    xFirstLength = configMIN( pxStreamBuffer->xLength - xIndex, xCount );
 
     /* Obtain the number of bytes it is possible to obtain in the first
      * read.  Asserts check bounds of read and write. */
     configASSERT( xFirstLength <= xCount );
-    configASSERT( ( xTail + xFirstLength ) <= pxStreamBuffer->xLength );
-    ( void ) memcpy( ( void * ) pucData, ( const void * ) &( pxStreamBuffer->pucBuffer[ xTail ] ), xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+    configASSERT( ( xIndex + xFirstLength ) <= pxStreamBuffer->xLength );
+    ( void ) memcpy( ( void * ) pucData, ( const void * ) &( pucBuffer[ xIndex ] ), xFirstLength ); /*lint !e9087 memcpy() requires void *. */
 
     /* If the total number of wanted bytes is greater than the number
      * that could be read in the first read... */
     if( xCount > xFirstLength )
     {
         /* ...then read the remaining bytes from the start of the buffer. */
-        ( void ) memcpy( ( void * ) &( pucData[ xFirstLength ] ), ( void * ) ( pxStreamBuffer->pucBuffer ), xCount - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+        ( void ) memcpy( ( void * ) &( pucData[ xFirstLength ] ), ( void * ) pucBuffer, xCount - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
     }
     else
     {
         mtCOVERAGE_TEST_MARKER();
     }
 
-    /* Move the tail pointer to effectively remove the data read from the buffer. */
+    /* Move the tail pointer to effectively remove the data read from the buffer.
+     * A free running counter is allowed to run past the end of the buffer. */
     xTail += xCount;
 
-    if( xTail >= pxStreamBuffer->xLength )
+    if( ( sbIS_POWER_OF_TWO_RING( pxStreamBuffer ) == pdFALSE ) && ( xTail >= pxStreamBuffer->xLength ) )
     {
         xTail -= pxStreamBuffer->xLength;
     }
@@ -1240,16 +1607,25 @@ static size_t prvBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer )
 /* Returns the distance between xTail and xHead. */
     size_t xCount;
 
-    xCount = pxStreamBuffer->xLength + pxStreamBuffer->xHead;
-    xCount -= pxStreamBuffer->xTail;
-
-    if( xCount >= pxStreamBuffer->xLength )
+    if( sbIS_POWER_OF_TWO_RING( pxStreamBuffer ) != pdFALSE )
     {
-        xCount -= pxStreamBuffer->xLength;
+        /* Free running counters - unsigned subtraction gives the distance even
+         * after xHead has wrapped past zero. */
+        xCount = pxStreamBuffer->xHead - pxStreamBuffer->xTail;
     }
     else
     {
-        mtCOVERAGE_TEST_MARKER();
+        xCount = pxStreamBuffer->xLength + pxStreamBuffer->xHead;
+        xCount -= pxStreamBuffer->xTail;
+
+        if( xCount >= pxStreamBuffer->xLength )
+        {
+            xCount -= pxStreamBuffer->xLength;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
     }
 
     return xCount;
@@ -1279,6 +1655,7 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
     pxStreamBuffer->pucBuffer = pucBuffer;
     pxStreamBuffer->xLength = xBufferSizeBytes;
     pxStreamBuffer->xTriggerLevelBytes = xTriggerLevelBytes;
+    pxStreamBuffer->xSpaceTriggerLevelBytes = ( size_t ) 1;
     pxStreamBuffer->ucFlags = ucFlags;
 }
 
@@ -40,6 +40,7 @@
 #include "task.h"
 #include "timers.h"
 #include "stack_macros.h"
+#include "slab.h"
 
 /* Lint e9021, e961 and e750 are suppressed as a MISRA exception justified
  * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
@@ -83,6 +84,16 @@
 #define tskSTATICALLY_ALLOCATED_STACK_ONLY        ( ( uint8_t ) 1 )
 #define tskSTATICALLY_ALLOCATED_STACK_AND_TCB     ( ( uint8_t ) 2 )
 
+/* Dynamically allocated TCBs come from the task slab cache when slab caches
+ * are in use, otherwise directly from the heap. */
+#if ( configUSE_SLAB_CACHES == 1 )
+    #define tskALLOCATE_TCB()       ( ( TCB_t * ) pvSlabAllocate( eSlabCacheTask, sizeof( TCB_t ) ) )
+    #define tskFREE_TCB( pxTCB )    vSlabFree( pxTCB )
+#else
+    #define tskALLOCATE_TCB()       ( ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) ) )
+    #define tskFREE_TCB( pxTCB )    vPortFree( pxTCB )
+#endif
+
 /* If any of the following are set then task stacks are filled with a known
  * value so the high water mark can be determined.  If none of the following are
  * set then don't fill the stack so there is no unnecessary dependency on memset. */
@@ -329,6 +340,14 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
     #if ( configUSE_POSIX_ERRNO == 1 )
         int iTaskErrno;
     #endif
+
+    #if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+        uint64_t ullEventItemValue; /*< Holds the bits a task is waiting for, or was unblocked with, when the task's event list item is used by a 64-bit event group - the list item value is too narrow. */
+    #endif
+
+    #if ( configHEAP_TRACK_TASK_ALLOCATIONS == 1 )
+        size_t xHeapBytesInUse; /*< The number of bytes the task has allocated from the heap and not yet freed.  Only updated by the heap, with the heap locked. */
+    #endif
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
@@ -692,7 +711,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             /* Allocate space for the TCB.  Where the memory comes from depends
              * on the implementation of the port malloc function and whether or
              * not static allocation is being used. */
-            pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+            pxNewTCB = tskALLOCATE_TCB();
 
             if( pxNewTCB != NULL )
             {
@@ -749,7 +768,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             /* Allocate space for the TCB.  Where the memory comes from depends on
              * the implementation of the port malloc function and whether or not static
              * allocation is being used. */
-            pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+            pxNewTCB = tskALLOCATE_TCB();
 
             if( pxNewTCB != NULL )
             {
@@ -763,7 +782,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                 if( pxNewTCB->pxStack == NULL )
                 {
                     /* Could not allocate the stack.  Delete the allocated TCB. */
-                    vPortFree( pxNewTCB );
+                    tskFREE_TCB( pxNewTCB );
                     pxNewTCB = NULL;
                 }
             }
@@ -778,7 +797,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             if( pxStack != NULL )
             {
                 /* Allocate space for the TCB. */
-                pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of TCB_t is always a pointer to the task's stack. */
+                pxNewTCB = tskALLOCATE_TCB(); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of TCB_t is always a pointer to the task's stack. */
 
                 if( pxNewTCB != NULL )
                 {
@@ -2874,6 +2893,23 @@ BaseType_t xTaskIncrementTick( void )
         }
         #endif /* configUSE_TICK_HOOK */
 
+        #if ( configUSE_HARD_TIMERS == 1 )
+        {
+            /* As for the tick hook, hard timers are processed once for each
+             * tick interrupt, not again when the pended ticks are unwound.  A
+             * hard timer callback can unblock a task, so this is done before
+             * checking for a pending yield. */
+            if( xPendedTicks == ( TickType_t ) 0 )
+            {
+                vTimerProcessHardTimersFromISR();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_HARD_TIMERS */
+
         #if ( configUSE_PREEMPTION == 1 )
         {
             if( xYieldPending != pdFALSE )
@@ -2898,6 +2934,13 @@ BaseType_t xTaskIncrementTick( void )
             vApplicationTickHook();
         }
         #endif
+
+        /* Hard timers are also processed while the scheduler is locked. */
+        #if ( configUSE_HARD_TIMERS == 1 )
+        {
+            vTimerProcessHardTimersFromISR();
+        }
+        #endif
     }
 
     return xSwitchRequired;
@@ -3136,13 +3179,30 @@ void vTaskPlaceOnUnorderedEventList( List_t * pxEventList,
      * list.  It is safe to access the event list here because it is part of an
      * event group implementation - and interrupts don't access event groups
      * directly (instead they access them indirectly by pending function calls to
-     * the task level). */
+     * the task level), or, if configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS is greater
+     * than 0, only access event groups that are not locked by a task. */
     listINSERT_END( pxEventList, &( pxCurrentTCB->xEventListItem ) );
 
     prvAddCurrentTaskToDelayedList( xTicksToWait, pdTRUE );
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+
+    void vTaskPlaceOnUnorderedEventList64( List_t * pxEventList,
+                                           const uint64_t ullItemValue,
+                                           const TickType_t xTicksToWait )
+    {
+        /* The event list item value itself only marks the item as in use - the
+         * full width value is held in the TCB.  It is safe to access the TCB
+         * here for the same reasons given in vTaskPlaceOnUnorderedEventList(). */
+        pxCurrentTCB->ullEventItemValue = ullItemValue;
+        vTaskPlaceOnUnorderedEventList( pxEventList, ( TickType_t ) 0, xTicksToWait );
+    }
+
+#endif /* configUSE_64_BIT_EVENT_GROUPS */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_TIMERS == 1 )
 
     void vTaskPlaceOnEventListRestricted( List_t * const pxEventList,
@@ -3295,6 +3355,119 @@ void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+
+    void vTaskRemoveFromUnorderedEventList64( ListItem_t * pxEventListItem,
+                                              const uint64_t ullItemValue )
+    {
+        TCB_t * pxUnblockedTCB;
+
+        pxUnblockedTCB = listGET_LIST_ITEM_OWNER( pxEventListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+        configASSERT( pxUnblockedTCB );
+        pxUnblockedTCB->ullEventItemValue = ullItemValue;
+
+        vTaskRemoveFromUnorderedEventList( pxEventListItem, ( TickType_t ) 0 );
+    }
+
+#endif /* configUSE_64_BIT_EVENT_GROUPS */
+/*-----------------------------------------------------------*/
+
+#if ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 )
+
+    BaseType_t xTaskRemoveFromUnorderedEventListFromISR( ListItem_t * pxEventListItem,
+                                                         const TickType_t xItemValue )
+    {
+        TCB_t * pxUnblockedTCB;
+        BaseType_t xReturn;
+
+        /* THIS FUNCTION MUST BE CALLED FROM A CRITICAL SECTION.  It can also be
+         * called from a critical section within an ISR.  It is used by the event
+         * groups implementation to unblock tasks from interrupts without
+         * deferring to the timer task, and performs the same function as
+         * vTaskRemoveFromUnorderedEventList() without requiring the scheduler
+         * to be suspended. */
+
+        /* Store the new item value in the event list item. */
+        listSET_LIST_ITEM_VALUE( pxEventListItem, xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
+
+        pxUnblockedTCB = listGET_LIST_ITEM_OWNER( pxEventListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+        configASSERT( pxUnblockedTCB );
+        listREMOVE_ITEM( pxEventListItem );
+
+        if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+        {
+            listREMOVE_ITEM( &( pxUnblockedTCB->xStateListItem ) );
+            prvAddTaskToReadyList( pxUnblockedTCB );
+
+            #if ( configUSE_TICKLESS_IDLE != 0 )
+            {
+                /* See the comment in xTaskRemoveFromEventList(). */
+                prvResetNextTaskUnblockTime();
+            }
+            #endif
+        }
+        else
+        {
+            /* The delayed and ready lists cannot be accessed, so hold this task
+             * pending until the scheduler is resumed.  The item value is
+             * retained while the item is in the pending ready list. */
+            listINSERT_END( &( xPendingReadyList ), pxEventListItem );
+        }
+
+        if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+        {
+            /* Return true if the task removed from the event list has a higher
+             * priority than the calling task, and mark that a yield is pending
+             * in case the caller does not use the return value. */
+            xReturn = pdTRUE;
+            xYieldPending = pdTRUE;
+        }
+        else
+        {
+            xReturn = pdFALSE;
+        }
+
+        return xReturn;
+    }
+
+#endif /* configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS */
+/*-----------------------------------------------------------*/
+
+#if ( ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 ) && ( configUSE_64_BIT_EVENT_GROUPS == 1 ) )
+
+    BaseType_t xTaskRemoveFromUnorderedEventListFromISR64( ListItem_t * pxEventListItem,
+                                                           const uint64_t ullItemValue )
+    {
+        TCB_t * pxUnblockedTCB;
+
+        pxUnblockedTCB = listGET_LIST_ITEM_OWNER( pxEventListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+        configASSERT( pxUnblockedTCB );
+        pxUnblockedTCB->ullEventItemValue = ullItemValue;
+
+        return xTaskRemoveFromUnorderedEventListFromISR( pxEventListItem, ( TickType_t ) 0 );
+    }
+
+#endif /* ( ( configEVENT_GROUP_DIRECT_ISR_MAX_WAITERS > 0 ) && ( configUSE_64_BIT_EVENT_GROUPS == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+
+    uint64_t ullTaskGetEventItemValue64( const ListItem_t * pxEventListItem )
+    {
+        const TCB_t * pxTCB;
+
+        /* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED.  It is used
+         * by the event groups implementation to inspect the tasks in an event
+         * group's list of waiting tasks. */
+        pxTCB = listGET_LIST_ITEM_OWNER( pxEventListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+        configASSERT( pxTCB );
+
+        return pxTCB->ullEventItemValue;
+    }
+
+#endif /* configUSE_64_BIT_EVENT_GROUPS */
+/*-----------------------------------------------------------*/
+
 void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
 {
     configASSERT( pxTimeOut );
@@ -3822,6 +3995,12 @@ static void prvCheckTasksWaitingTermination( void )
         {
             pxTaskStatus->usStackHighWaterMark = 0;
         }
+
+        #if ( configHEAP_TRACK_TASK_ALLOCATIONS == 1 )
+        {
+            pxTaskStatus->xHeapBytesInUse = pxTCB->xHeapBytesInUse;
+        }
+        #endif
     }
 
 #endif /* configUSE_TRACE_FACILITY */
@@ -3969,12 +4148,29 @@ static void prvCheckTasksWaitingTermination( void )
         }
         #endif /* configUSE_NEWLIB_REENTRANT */
 
+        #if ( configHEAP_TRACK_TASK_ALLOCATIONS == 1 )
+        {
+            /* Any memory the task allocated and did not free is left in the
+             * heap, but must no longer refer to the TCB that is about to be
+             * freed.  The task cannot allocate any more memory, so if its count
+             * is zero it owns no blocks. */
+            if( pxTCB->xHeapBytesInUse != ( size_t ) 0 )
+            {
+                vPortHeapDisownTask( pxTCB );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configHEAP_TRACK_TASK_ALLOCATIONS */
+
         #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( portUSING_MPU_WRAPPERS == 0 ) )
         {
             /* The task can only have been allocated dynamically - free both
              * the stack and TCB. */
             vPortFreeStack( pxTCB->pxStack );
-            vPortFree( pxTCB );
+            tskFREE_TCB( pxTCB );
         }
         #elif ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
         {
@@ -3986,13 +4182,13 @@ static void prvCheckTasksWaitingTermination( void )
                 /* Both the stack and TCB were allocated dynamically, so both
                  * must be freed. */
                 vPortFreeStack( pxTCB->pxStack );
-                vPortFree( pxTCB );
+                tskFREE_TCB( pxTCB );
             }
             else if( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY )
             {
                 /* Only the stack was statically allocated, so the TCB is the
                  * only memory that must be freed. */
-                vPortFree( pxTCB );
+                tskFREE_TCB( pxTCB );
             }
             else
             {
@@ -4689,6 +4885,24 @@ TickType_t uxTaskResetEventItemValue( void )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+
+    uint64_t ullTaskResetEventItemValue64( void )
+    {
+        uint64_t ullReturn;
+
+        ullReturn = pxCurrentTCB->ullEventItemValue;
+        pxCurrentTCB->ullEventItemValue = 0;
+
+        /* Return the event list item to its normal use too. */
+        ( void ) uxTaskResetEventItemValue();
+
+        return ullReturn;
+    }
+
+#endif /* configUSE_64_BIT_EVENT_GROUPS */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_MUTEXES == 1 )
 
     TaskHandle_t pvTaskIncrementMutexHeldCount( void )
@@ -4706,6 +4920,48 @@ TickType_t uxTaskResetEventItemValue( void )
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if ( configHEAP_TRACK_TASK_ALLOCATIONS == 1 )
+
+    TaskHandle_t pvTaskAddHeapBytesInUse( size_t xBytes )
+    {
+        TCB_t * pxTCB = NULL;
+
+        /* Memory allocated before the scheduler has started, while the
+         * application is creating its tasks and other objects, is not
+         * attributed to a task. */
+        if( xSchedulerRunning != pdFALSE )
+        {
+            pxTCB = pxCurrentTCB;
+            pxTCB->xHeapBytesInUse += xBytes;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pxTCB;
+    }
+/*-----------------------------------------------------------*/
+
+    void vTaskRemoveHeapBytesInUse( TaskHandle_t xTask,
+                                    size_t xBytes )
+    {
+        TCB_t * const pxTCB = xTask;
+
+        if( pxTCB != NULL )
+        {
+            configASSERT( pxTCB->xHeapBytesInUse >= xBytes );
+            pxTCB->xHeapBytesInUse -= xBytes;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configHEAP_TRACK_TASK_ALLOCATIONS */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_TASK_NOTIFICATIONS == 1 )
 
     uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWait,
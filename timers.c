@@ -38,6 +38,7 @@
 #include "task.h"
 #include "queue.h"
 #include "timers.h"
+#include "slab.h"
 
 #if ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 0 )
     #error configUSE_TIMERS must be set to 1 to make the xTimerPendFunctionCall() function available.
@@ -70,6 +71,27 @@
     #define tmrSTATUS_IS_ACTIVE                  ( ( uint8_t ) 0x01 )
     #define tmrSTATUS_IS_STATICALLY_ALLOCATED    ( ( uint8_t ) 0x02 )
     #define tmrSTATUS_IS_AUTORELOAD              ( ( uint8_t ) 0x04 )
+    #define tmrSTATUS_IS_HARD                    ( ( uint8_t ) 0x08 )
+
+    #if ( configUSE_TIMER_COMMAND_COALESCING == 1 )
+
+/* The value of xPendingCommandID when a timer has no pending command.  Timer
+ * commands are never negative. */
+        #define tmrNO_PENDING_COMMAND                ( ( BaseType_t ) -1 )
+        #define tmrHAS_PENDING_COMMAND( pxTimer )    ( ( ( pxTimer )->xPendingCommandID != tmrNO_PENDING_COMMAND ) ? pdTRUE : pdFALSE )
+    #else
+        #define tmrHAS_PENDING_COMMAND( pxTimer )    pdFALSE
+    #endif
+
+/* Dynamically allocated timers come from the timer slab cache when slab caches
+ * are in use, otherwise directly from the heap. */
+    #if ( configUSE_SLAB_CACHES == 1 )
+        #define tmrALLOCATE_TIMER()         ( ( Timer_t * ) pvSlabAllocate( eSlabCacheTimer, sizeof( Timer_t ) ) )
+        #define tmrFREE_TIMER( pxTimer )    vSlabFree( pxTimer )
+    #else
+        #define tmrALLOCATE_TIMER()         ( ( Timer_t * ) pvPortMalloc( sizeof( Timer_t ) ) )
+        #define tmrFREE_TIMER( pxTimer )    vPortFree( pxTimer )
+    #endif
 
 /* The definition of the timers themselves. */
     typedef struct tmrTimerControl                  /* The old naming convention is used to prevent breaking kernel aware debuggers. */
@@ -83,6 +105,18 @@
             UBaseType_t uxTimerNumber;              /*<< An ID assigned by trace tools such as FreeRTOS+Trace */
         #endif
         uint8_t ucStatus;                           /*<< Holds bits to say if the timer was statically allocated or not, and if it is active or not. */
+        #if ( configUSE_TIMER_COMMAND_COALESCING == 1 )
+            BaseType_t xPendingCommandID;                      /*<< The most recent command sent to the timer that has not yet been processed, or tmrNO_PENDING_COMMAND. */
+            TickType_t xPendingCommandValue;                   /*<< The value sent with xPendingCommandID. */
+            TickType_t xPendingPeriodInTicks;                  /*<< A new period that has not yet been applied, or 0. */
+            struct tmrTimerControl * pxNextTimerWithCommand; /*<< The next timer in the list of timers with pending commands. */
+        #endif
+        #if ( configTIMER_SERVICE_TASKS > 1 )
+            struct tmrTimerService * pxTimerService; /*<< The timer service task that services the timer. */
+        #endif
+        #if ( configUSE_TIMER_SLACK == 1 )
+            TickType_t xTimerSlackInTicks; /*<< How long after its expiry time the timer's callback can be called so its expiry can be batched with that of other timers. */
+        #endif
     } xTIMER;
 
 /* The old xTIMER name is maintained above then typedefed to the new Timer_t
@@ -128,20 +162,123 @@
 /*lint -save -e956 A manual analysis and inspection has been used to determine
  * which static variables must be declared volatile. */
 
-/* The list in which active timers are stored.  Timers are referenced in expire
- * time order, with the nearest expiry time at the front of the list.  Only the
- * timer service task is allowed to access these lists.
- * xActiveTimerList1 and xActiveTimerList2 could be at function scope but that
+    #if ( configTIMER_WHEEL_SLOTS > 0 )
+        #define tmrWHEEL_SLOT( xTime )    ( ( UBaseType_t ) ( xTime ) & ( ( UBaseType_t ) configTIMER_WHEEL_SLOTS - ( UBaseType_t ) 1 ) )
+    #endif
+
+/* The state of a timer service task.  Each timer is serviced by one timer
+ * service task, which is the only task allowed to access the active timers it
+ * services. */
+    typedef struct tmrTimerService
+    {
+        #if ( configTIMER_WHEEL_SLOTS > 0 )
+
+            /* The timing wheel in which active timers are stored.  A timer is
+             * held, unsorted, in the slot selected by the low bits of its expiry
+             * time, so it can be added and removed in constant time.
+             * xTimerWheelTime is the tick up to which the wheel has been
+             * processed - every timer in the wheel expires after it.  Timers
+             * that have expired are moved to xExpiredTimerList, in expiry order,
+             * before their callbacks are called. */
+            List_t xTimerWheel[ configTIMER_WHEEL_SLOTS ];
+            List_t xExpiredTimerList;
+            TickType_t xTimerWheelTime;
+            UBaseType_t uxTimersInWheel;
+        #else
+
+            /* The list in which active timers are stored.  Timers are referenced
+             * in expire time order, with the nearest expiry time at the front of
+             * the list. */
+            List_t xActiveTimerList1;
+            List_t xActiveTimerList2;
+            List_t * pxCurrentTimerList;
+            List_t * pxOverflowTimerList;
+        #endif /* configTIMER_WHEEL_SLOTS */
+
+        TickType_t xLastTime; /*< The tick count when prvSampleTimeNow() was last called. */
+
+        /* A queue that is used to send commands to the timer service task. */
+        QueueHandle_t xTimerQueue;
+        TaskHandle_t xTimerTaskHandle;
+
+        #if ( configUSE_TIMER_COMMAND_COALESCING == 1 )
+
+            /* Timers that have a pending command, in the order in which their
+             * commands were first sent.  Accessed from interrupts so only
+             * accessed in critical sections. */
+            Timer_t * pxFirstTimerWithCommand;
+            Timer_t * pxLastTimerWithCommand;
+        #endif
+
+        #if ( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configTIMER_PEND_FUNCTION_RING_LENGTH > 0 ) )
+
+            /* The ring of function calls pended to this timer service task.
+             * Function calls are added at uxPendedCallTail, in a critical
+             * section, and removed at uxPendedCallHead by this timer service
+             * task only.  Both are free running counts. */
+            CallbackParameters_t xPendedCalls[ configTIMER_PEND_FUNCTION_RING_LENGTH ];
+            volatile UBaseType_t uxPendedCallHead;
+            volatile UBaseType_t uxPendedCallTail;
+            UBaseType_t uxPendedCallsMaximum;
+            UBaseType_t uxPendedCallOverflows;
+        #endif
+
+        #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+
+            /* Set by the timer service task immediately before it blocks, and
+             * cleared when it runs again.  The timer service task does not access
+             * the active timers while it is blocked, so other tasks can access
+             * them with the scheduler suspended.  The time at which the timer
+             * service task blocked, and the time at which it will unblock if no
+             * command is received, are also recorded so a task that updates a
+             * timer knows if the timer service task needs unblocking. */
+            volatile BaseType_t xTimerTaskIsBlocked;
+            TickType_t xTimerTaskBlockTime;
+            TickType_t xTimerTaskWakeTime;
+            BaseType_t xTimerTaskWaitsIndefinitely;
+        #endif
+    } TimerService_t;
+
+/* The timer service tasks.  xTimerServices could be at function scope but that
  * breaks some kernel aware debuggers, and debuggers that reply on removing the
  * static qualifier. */
-    PRIVILEGED_DATA static List_t xActiveTimerList1;
-    PRIVILEGED_DATA static List_t xActiveTimerList2;
-    PRIVILEGED_DATA static List_t * pxCurrentTimerList;
-    PRIVILEGED_DATA static List_t * pxOverflowTimerList;
+    PRIVILEGED_DATA static TimerService_t xTimerServices[ configTIMER_SERVICE_TASKS ];
+
+    #if ( configTIMER_SERVICE_TASKS > 1 )
+        #define tmrGET_TIMER_SERVICE( pxTimer )    ( ( pxTimer )->pxTimerService )
+    #else
+        #define tmrGET_TIMER_SERVICE( pxTimer )    ( &( xTimerServices[ 0 ] ) )
+    #endif
+
+    #if ( configTIMER_PEND_FUNCTION_RING_LENGTH > 0 )
+        #define tmrPENDED_CALL_INDEX( uxCount )    ( ( uxCount ) & ( ( UBaseType_t ) configTIMER_PEND_FUNCTION_RING_LENGTH - ( UBaseType_t ) 1 ) )
+    #endif
+
+    #if ( configUSE_HARD_TIMERS != 0 )
+
+/* The timing wheel in which active hard timers are stored, and the list to
+ * which hard timers are moved when they expire, before their callbacks are
+ * called.  xHardTimerTime counts the calls to vTimerProcessHardTimersFromISR().
+ * Only accessed with interrupts masked. */
+        PRIVILEGED_DATA static List_t xHardTimerWheel[ configHARD_TIMER_WHEEL_SLOTS ];
+        PRIVILEGED_DATA static List_t xExpiredHardTimerList;
+        PRIVILEGED_DATA static volatile TickType_t xHardTimerTime = ( TickType_t ) configINITIAL_TICK_COUNT;
+        PRIVILEGED_DATA static volatile UBaseType_t uxActiveHardTimers = ( UBaseType_t ) 0U;
+
+        #define tmrHARD_WHEEL_SLOT( xTime )    ( ( UBaseType_t ) ( xTime ) & ( ( UBaseType_t ) configHARD_TIMER_WHEEL_SLOTS - ( UBaseType_t ) 1 ) )
+    #endif
+
+    #if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+
+/* The active high resolution timers, in order of expiry time.  Only accessed
+ * with interrupts masked. */
+        PRIVILEGED_DATA static HighResolutionTimer_t * pxHighResolutionTimerList = NULL;
+    #endif
 
-/* A queue that is used to send commands to the timer service task. */
-    PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
-    PRIVILEGED_DATA static TaskHandle_t xTimerTaskHandle = NULL;
+/* The priority and stack depth of each timer service task.  Timer service task 0
+ * uses the original configuration constants. */
+    #define tmrSERVICE_TASK_PRIORITY( uxServiceTask )       ( ( ( uxServiceTask ) == ( UBaseType_t ) 0 ) ? ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) : ( ( UBaseType_t ) configTIMER_SERVICE_TASK_PRIORITY( uxServiceTask ) ) )
+    #define tmrSERVICE_TASK_STACK_DEPTH( uxServiceTask )    ( ( ( uxServiceTask ) == ( UBaseType_t ) 0 ) ? ( ( configSTACK_DEPTH_TYPE ) configTIMER_TASK_STACK_DEPTH ) : ( ( configSTACK_DEPTH_TYPE ) configTIMER_SERVICE_TASK_STACK_DEPTH( uxServiceTask ) ) )
 
 /*lint -restore */
 
@@ -164,7 +301,14 @@
  * Called by the timer service task to interpret and process a command it
  * received on the timer queue.
  */
-    static void prvProcessReceivedCommands( void ) PRIVILEGED_FUNCTION;
+    static void prvProcessReceivedCommands( TimerService_t * const pxService ) PRIVILEGED_FUNCTION;
+
+/*
+ * Apply a command to a timer.  Called by the timer service task.
+ */
+    static void prvProcessTimerCommand( Timer_t * const pxTimer,
+                                        const BaseType_t xCommandID,
+                                        const TickType_t xMessageValue ) PRIVILEGED_FUNCTION;
 
 /*
  * Insert the timer into either xActiveTimerList1, or xActiveTimerList2,
@@ -188,20 +332,33 @@
  * An active timer has reached its expire time.  Reload the timer if it is an
  * auto-reload timer, then call its callback.
  */
-    static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
+    static void prvProcessExpiredTimer( TimerService_t * const pxService,
+                                        const TickType_t xNextExpireTime,
                                         const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
+    #if ( configTIMER_WHEEL_SLOTS > 0 )
+
+/*
+ * Move every timer in the timing wheel that expires after xTimerWheelTime and
+ * at or before xTimeNow to xExpiredTimerList, then process each in turn.
+ */
+        static void prvProcessExpiredTimers( TimerService_t * const pxService,
+                                             const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+    #else
+
 /*
  * The tick count has overflowed.  Switch the timer lists after ensuring the
  * current timer list does not still reference some timers.
  */
-    static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+        static void prvSwitchTimerLists( TimerService_t * const pxService ) PRIVILEGED_FUNCTION;
+    #endif
 
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
  * if a tick count overflow occurred since prvSampleTimeNow() was last called.
  */
-    static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched ) PRIVILEGED_FUNCTION;
+    static TickType_t prvSampleTimeNow( TimerService_t * const pxService,
+                                        BaseType_t * const pxTimerListsWereSwitched ) PRIVILEGED_FUNCTION;
 
 /*
  * If the timer list contains any active timers then return the expire time of
@@ -209,15 +366,139 @@
  * timer list does not contain any timers then return 0 and set *pxListWasEmpty
  * to pdTRUE.
  */
-    static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty ) PRIVILEGED_FUNCTION;
+    static TickType_t prvGetNextExpireTime( TimerService_t * const pxService,
+                                            BaseType_t * const pxListWasEmpty ) PRIVILEGED_FUNCTION;
 
 /*
  * If a timer has expired, process it.  Otherwise, block the timer service task
  * until either a timer does expire or a command is received.
  */
-    static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
+    static void prvProcessTimerOrBlockTask( TimerService_t * const pxService,
+                                            const TickType_t xNextExpireTime,
                                             BaseType_t xListWasEmpty ) PRIVILEGED_FUNCTION;
 
+    #if ( configUSE_TIMER_SLACK == 1 )
+
+/*
+ * Return the time at which the timer service task must unblock to process the
+ * active timers within their slack, which is the earliest expiry time plus
+ * slack time of the timers that expire before then.  xNextExpireTime and
+ * xListWasEmpty are as returned by prvGetNextExpireTime().
+ */
+        static TickType_t prvGetNextWakeTime( TimerService_t * const pxService,
+                                              const TickType_t xNextExpireTime,
+                                              const BaseType_t xListWasEmpty ) PRIVILEGED_FUNCTION;
+    #endif
+
+    #if ( configUSE_TIMER_COMMAND_COALESCING == 1 )
+
+/*
+ * Called by xTimerGenericCommand() to record a command in the timer, replacing
+ * any command that has not yet been processed, and to unblock the timer service
+ * task if no other timer has a pending command.
+ */
+        static BaseType_t prvPendTimerCommand( Timer_t * const pxTimer,
+                                               const BaseType_t xCommandID,
+                                               const TickType_t xOptionalValue,
+                                               BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called by the timer service task to process the pending timer commands.
+ */
+        static void prvProcessPendingCommands( TimerService_t * const pxService ) PRIVILEGED_FUNCTION;
+    #endif
+
+    #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+
+/*
+ * Called by xTimerGenericCommand() to apply a start, reset, stop or change
+ * period command to the active timers directly, rather than sending it to the
+ * timer service task.  Returns pdFAIL if the command could not be applied
+ * directly, in which case it must be sent to the timer service task.
+ */
+        static BaseType_t prvApplyCommandDirectly( Timer_t * const pxTimer,
+                                                   const BaseType_t xCommandID,
+                                                   const TickType_t xOptionalValue ) PRIVILEGED_FUNCTION;
+    #endif
+
+    #if ( INCLUDE_xTimerPendFunctionCall == 1 )
+
+/*
+ * Pend a function call to the timer service task pxService, using its ring of
+ * pended function calls if there is one, otherwise its timer command queue.
+ */
+        static BaseType_t prvPendFunctionCall( TimerService_t * const pxService,
+                                               PendedFunction_t xFunctionToPend,
+                                               void * pvParameter1,
+                                               uint32_t ulParameter2,
+                                               BaseType_t * const pxHigherPriorityTaskWoken,
+                                               const TickType_t xTicksToWait,
+                                               const BaseType_t xFromISR ) PRIVILEGED_FUNCTION;
+
+        #if ( configTIMER_PEND_FUNCTION_RING_LENGTH > 0 )
+
+/*
+ * Add a function call to the ring of pended function calls of pxService, and
+ * unblock the timer service task if the ring was empty.  Returns pdFAIL if the
+ * ring is full.
+ */
+            static BaseType_t prvAddToPendedFunctionRing( TimerService_t * const pxService,
+                                                          PendedFunction_t xFunctionToPend,
+                                                          void * pvParameter1,
+                                                          uint32_t ulParameter2,
+                                                          BaseType_t * const pxHigherPriorityTaskWoken,
+                                                          const BaseType_t xFromISR ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called by the timer service task to call each function in its ring of
+ * pended function calls.
+ */
+            static void prvProcessPendedFunctionRing( TimerService_t * const pxService ) PRIVILEGED_FUNCTION;
+        #endif
+    #endif /* INCLUDE_xTimerPendFunctionCall */
+
+    #if ( configUSE_HARD_TIMERS != 0 )
+
+/*
+ * Called by xTimerGenericCommand() to apply a command to a hard timer.  Returns
+ * pdFAIL if the command must also be sent to the timer service task, which is
+ * only the case when the timer is being deleted.
+ */
+        static BaseType_t prvApplyHardTimerCommand( Timer_t * const pxTimer,
+                                                    const BaseType_t xCommandID,
+                                                    const TickType_t xOptionalValue ) PRIVILEGED_FUNCTION;
+
+/*
+ * Insert a hard timer into the hard timer wheel.  Must be called with
+ * interrupts masked.
+ */
+        static void prvInsertHardTimer( Timer_t * const pxTimer,
+                                        const TickType_t xExpiryTime ) PRIVILEGED_FUNCTION;
+    #endif
+
+    #if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+
+/*
+ * Remove a high resolution timer from the list of active high resolution timers
+ * if it is in the list.  Must be called with interrupts masked.
+ */
+        static void prvRemoveHighResolutionTimer( HighResolutionTimer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Insert a high resolution timer into the list of active high resolution
+ * timers, and set the port's compare if the timer is now the next to expire.
+ * Must be called with interrupts masked.
+ */
+        static void prvInsertHighResolutionTimer( HighResolutionTimer_t * const pxTimer,
+                                                  const uint64_t ullExpiryTime ) PRIVILEGED_FUNCTION;
+
+/*
+ * The callback of the high resolution timer used by vTimerDelayHighResolution(),
+ * which unblocks the delayed task.
+ */
+        static void prvHighResolutionDelayCallback( HighResolutionTimer_t * pxTimer ) PRIVILEGED_FUNCTION;
+    #endif
+
 /*
  * Called after a Timer_t structure has been allocated either statically or
  * dynamically to fill in the structure's members.
@@ -232,7 +513,9 @@
 
     BaseType_t xTimerCreateTimerTask( void )
     {
-        BaseType_t xReturn = pdFAIL;
+        BaseType_t xReturn = pdPASS;
+        TimerService_t * pxService;
+        UBaseType_t uxServiceTask;
 
         /* This function is called when the scheduler is started if
          * configUSE_TIMERS is set to 1.  Check that the infrastructure used by the
@@ -240,42 +523,60 @@
          * been created then the initialisation will already have been performed. */
         prvCheckForValidListAndQueue();
 
-        if( xTimerQueue != NULL )
+        for( uxServiceTask = 0; ( uxServiceTask < ( UBaseType_t ) configTIMER_SERVICE_TASKS ) && ( xReturn != pdFAIL ); uxServiceTask++ )
         {
-            #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+            pxService = &( xTimerServices[ uxServiceTask ] );
+            xReturn = pdFAIL;
+
+            if( pxService->xTimerQueue != NULL )
             {
-                StaticTask_t * pxTimerTaskTCBBuffer = NULL;
-                StackType_t * pxTimerTaskStackBuffer = NULL;
-                uint32_t ulTimerTaskStackSize;
+                #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+                {
+                    StaticTask_t * pxTimerTaskTCBBuffer = NULL;
+                    StackType_t * pxTimerTaskStackBuffer = NULL;
+                    uint32_t ulTimerTaskStackSize = 0;
+
+                    if( uxServiceTask == ( UBaseType_t ) 0 )
+                    {
+                        vApplicationGetTimerTaskMemory( &pxTimerTaskTCBBuffer, &pxTimerTaskStackBuffer, &ulTimerTaskStackSize );
+                    }
+                    else
+                    {
+                        #if ( configTIMER_SERVICE_TASKS > 1 )
+                        {
+                            vApplicationGetTimerServiceTaskMemory( uxServiceTask, &pxTimerTaskTCBBuffer, &pxTimerTaskStackBuffer, &ulTimerTaskStackSize );
+                        }
+                        #endif
+                    }
 
-                vApplicationGetTimerTaskMemory( &pxTimerTaskTCBBuffer, &pxTimerTaskStackBuffer, &ulTimerTaskStackSize );
-                xTimerTaskHandle = xTaskCreateStatic( prvTimerTask,
-                                                      configTIMER_SERVICE_TASK_NAME,
-                                                      ulTimerTaskStackSize,
-                                                      NULL,
-                                                      ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
-                                                      pxTimerTaskStackBuffer,
-                                                      pxTimerTaskTCBBuffer );
+                    pxService->xTimerTaskHandle = xTaskCreateStatic( prvTimerTask,
+                                                                     configTIMER_SERVICE_TASK_NAME,
+                                                                     ulTimerTaskStackSize,
+                                                                     ( void * ) pxService,
+                                                                     tmrSERVICE_TASK_PRIORITY( uxServiceTask ) | portPRIVILEGE_BIT,
+                                                                     pxTimerTaskStackBuffer,
+                                                                     pxTimerTaskTCBBuffer );
 
-                if( xTimerTaskHandle != NULL )
+                    if( pxService->xTimerTaskHandle != NULL )
+                    {
+                        xReturn = pdPASS;
+                    }
+                }
+                #else /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
                 {
-                    xReturn = pdPASS;
+                    xReturn = xTaskCreate( prvTimerTask,
+                                           configTIMER_SERVICE_TASK_NAME,
+                                           tmrSERVICE_TASK_STACK_DEPTH( uxServiceTask ),
+                                           ( void * ) pxService,
+                                           tmrSERVICE_TASK_PRIORITY( uxServiceTask ) | portPRIVILEGE_BIT,
+                                           &( pxService->xTimerTaskHandle ) );
                 }
+                #endif /* configSUPPORT_STATIC_ALLOCATION */
             }
-            #else /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+            else
             {
-                xReturn = xTaskCreate( prvTimerTask,
-                                       configTIMER_SERVICE_TASK_NAME,
-                                       configTIMER_TASK_STACK_DEPTH,
-                                       NULL,
-                                       ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
-                                       &xTimerTaskHandle );
+                mtCOVERAGE_TEST_MARKER();
             }
-            #endif /* configSUPPORT_STATIC_ALLOCATION */
-        }
-        else
-        {
-            mtCOVERAGE_TEST_MARKER();
         }
 
         configASSERT( xReturn );
@@ -293,7 +594,7 @@
         {
             Timer_t * pxNewTimer;
 
-            pxNewTimer = ( Timer_t * ) pvPortMalloc( sizeof( Timer_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of Timer_t is always a pointer to the timer's mame. */
+            pxNewTimer = tmrALLOCATE_TIMER(); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of Timer_t is always a pointer to the timer's mame. */
 
             if( pxNewTimer != NULL )
             {
@@ -372,6 +673,27 @@
         pxNewTimer->xTimerPeriodInTicks = xTimerPeriodInTicks;
         pxNewTimer->pvTimerID = pvTimerID;
         pxNewTimer->pxCallbackFunction = pxCallbackFunction;
+
+        #if ( configTIMER_SERVICE_TASKS > 1 )
+        {
+            pxNewTimer->pxTimerService = &( xTimerServices[ 0 ] );
+        }
+        #endif
+
+        #if ( configUSE_TIMER_SLACK == 1 )
+        {
+            pxNewTimer->xTimerSlackInTicks = ( TickType_t ) 0U;
+        }
+        #endif
+
+        #if ( configUSE_TIMER_COMMAND_COALESCING == 1 )
+        {
+            pxNewTimer->xPendingCommandID = tmrNO_PENDING_COMMAND;
+            pxNewTimer->xPendingCommandValue = ( TickType_t ) 0U;
+            pxNewTimer->xPendingPeriodInTicks = ( TickType_t ) 0U;
+            pxNewTimer->pxNextTimerWithCommand = NULL;
+        }
+        #endif
         vListInitialiseItem( &( pxNewTimer->xTimerListItem ) );
 
         if( xAutoReload != pdFALSE )
@@ -391,32 +713,77 @@
     {
         BaseType_t xReturn = pdFAIL;
         DaemonTaskMessage_t xMessage;
+        TimerService_t * pxService;
 
         configASSERT( xTimer );
+        pxService = tmrGET_TIMER_SERVICE( xTimer );
 
         /* Send a message to the timer service task to perform a particular action
          * on a particular timer definition. */
-        if( xTimerQueue != NULL )
+        if( pxService->xTimerQueue != NULL )
         {
-            /* Send a command to the timer service task to start the xTimer timer. */
-            xMessage.xMessageID = xCommandID;
-            xMessage.u.xTimerParameters.xMessageValue = xOptionalValue;
-            xMessage.u.xTimerParameters.pxTimer = xTimer;
+            #if ( configUSE_HARD_TIMERS != 0 )
+            {
+                if( ( xTimer->ucStatus & tmrSTATUS_IS_HARD ) != 0 )
+                {
+                    xReturn = prvApplyHardTimerCommand( xTimer, xCommandID, xOptionalValue );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_HARD_TIMERS */
 
-            if( xCommandID < tmrFIRST_FROM_ISR_COMMAND )
+            #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
             {
-                if( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING )
+                if( ( xReturn == pdFAIL ) && ( xCommandID < tmrFIRST_FROM_ISR_COMMAND ) && ( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING ) )
                 {
-                    xReturn = xQueueSendToBack( xTimerQueue, &xMessage, xTicksToWait );
+                    xReturn = prvApplyCommandDirectly( xTimer, xCommandID, xOptionalValue );
                 }
                 else
                 {
-                    xReturn = xQueueSendToBack( xTimerQueue, &xMessage, tmrNO_DELAY );
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_TIMER_DIRECT_COMMANDS */
+
+            if( xReturn == pdFAIL )
+            {
+                #if ( configUSE_TIMER_COMMAND_COALESCING == 1 )
+                {
+                    ( void ) xMessage;
+                    ( void ) xTicksToWait;
+                    xReturn = prvPendTimerCommand( xTimer, xCommandID, xOptionalValue, pxHigherPriorityTaskWoken );
+                }
+                #else
+                {
+                    /* Send a command to the timer service task to start the xTimer timer. */
+                    xMessage.xMessageID = xCommandID;
+                    xMessage.u.xTimerParameters.xMessageValue = xOptionalValue;
+                    xMessage.u.xTimerParameters.pxTimer = xTimer;
+
+                    if( xCommandID < tmrFIRST_FROM_ISR_COMMAND )
+                    {
+                        if( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING )
+                        {
+                            xReturn = xQueueSendToBack( pxService->xTimerQueue, &xMessage, xTicksToWait );
+                        }
+                        else
+                        {
+                            xReturn = xQueueSendToBack( pxService->xTimerQueue, &xMessage, tmrNO_DELAY );
+                        }
+                    }
+                    else
+                    {
+                        xReturn = xQueueSendToBackFromISR( pxService->xTimerQueue, &xMessage, pxHigherPriorityTaskWoken );
+                    }
                 }
+                #endif /* configUSE_TIMER_COMMAND_COALESCING */
             }
             else
             {
-                xReturn = xQueueSendToBackFromISR( xTimerQueue, &xMessage, pxHigherPriorityTaskWoken );
+                mtCOVERAGE_TEST_MARKER();
             }
 
             traceTIMER_COMMAND_SEND( xTimer, xCommandID, xOptionalValue, xReturn );
@@ -430,76 +797,832 @@
     }
 /*-----------------------------------------------------------*/
 
-    TaskHandle_t xTimerGetTimerDaemonTaskHandle( void )
-    {
-        /* If xTimerGetTimerDaemonTaskHandle() is called before the scheduler has been
-         * started, then xTimerTaskHandle will be NULL. */
-        configASSERT( ( xTimerTaskHandle != NULL ) );
-        return xTimerTaskHandle;
-    }
-/*-----------------------------------------------------------*/
-
-    TickType_t xTimerGetPeriod( TimerHandle_t xTimer )
-    {
-        Timer_t * pxTimer = xTimer;
+    #if ( configUSE_HARD_TIMERS != 0 )
 
-        configASSERT( xTimer );
-        return pxTimer->xTimerPeriodInTicks;
-    }
-/*-----------------------------------------------------------*/
+        static BaseType_t prvApplyHardTimerCommand( Timer_t * const pxTimer,
+                                                    const BaseType_t xCommandID,
+                                                    const TickType_t xOptionalValue )
+        {
+            BaseType_t xReturn = pdPASS;
+            UBaseType_t uxSavedInterruptStatus = 0;
 
-    void vTimerSetReloadMode( TimerHandle_t xTimer,
-                              const BaseType_t xAutoReload )
-    {
-        Timer_t * pxTimer = xTimer;
+            #if ( configUSE_HARD_TIMERS == 1 )
+                TickType_t xTimeNow;
+                TickType_t xElapsedTime;
+            #endif
 
-        configASSERT( xTimer );
-        taskENTER_CRITICAL();
-        {
-            if( xAutoReload != pdFALSE )
+            if( xCommandID < tmrFIRST_FROM_ISR_COMMAND )
             {
-                pxTimer->ucStatus |= tmrSTATUS_IS_AUTORELOAD;
+                #if ( configUSE_HARD_TIMERS == 1 )
+                {
+                    xTimeNow = xTaskGetTickCount();
+                }
+                #endif
+
+                taskENTER_CRITICAL();
             }
             else
             {
-                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_AUTORELOAD );
+                #if ( configUSE_HARD_TIMERS == 1 )
+                {
+                    xTimeNow = xTaskGetTickCountFromISR();
+                }
+                #endif
+
+                uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
             }
-        }
-        taskEXIT_CRITICAL();
-    }
-/*-----------------------------------------------------------*/
 
-    BaseType_t xTimerGetReloadMode( TimerHandle_t xTimer )
-    {
-        Timer_t * pxTimer = xTimer;
-        BaseType_t xReturn;
+            {
+                /* The timer is either in the hard timer wheel or, if it has
+                 * expired but its callback has not yet been called, in the list
+                 * of expired hard timers. */
+                if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
+                {
+                    ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                    uxActiveHardTimers--;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
 
-        configASSERT( xTimer );
-        taskENTER_CRITICAL();
-        {
-            if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) == 0 )
+                switch( xCommandID )
+                {
+                    case tmrCOMMAND_START:
+                    case tmrCOMMAND_START_FROM_ISR:
+                    case tmrCOMMAND_RESET:
+                    case tmrCOMMAND_RESET_FROM_ISR:
+
+                        #if ( configUSE_HARD_TIMERS == 1 )
+                        {
+                            /* The hard timer time advances with each tick
+                             * interrupt, so, as for other timers, the period is
+                             * measured from the time the command was issued
+                             * rather than from the time it is applied.  If the
+                             * period has already elapsed then the timer expires
+                             * on the next tick. */
+                            xElapsedTime = xTimeNow - xOptionalValue;
+
+                            if( xElapsedTime < pxTimer->xTimerPeriodInTicks )
+                            {
+                                prvInsertHardTimer( pxTimer, xHardTimerTime + ( pxTimer->xTimerPeriodInTicks - xElapsedTime ) );
+                            }
+                            else
+                            {
+                                prvInsertHardTimer( pxTimer, xHardTimerTime + ( TickType_t ) 1 );
+                            }
+                        }
+                        #else /* if ( configUSE_HARD_TIMERS == 1 ) */
+                        {
+                            /* The command time is in ticks, and the hard timer time
+                             * counts calls to vTimerProcessHardTimersFromISR(), so
+                             * the timer is started from the current hard timer
+                             * time instead. */
+                            prvInsertHardTimer( pxTimer, xHardTimerTime + pxTimer->xTimerPeriodInTicks );
+                        }
+                        #endif /* if ( configUSE_HARD_TIMERS == 1 ) */
+                        break;
+
+                    case tmrCOMMAND_CHANGE_PERIOD:
+                    case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR:
+                        configASSERT( ( xOptionalValue > 0 ) );
+                        pxTimer->xTimerPeriodInTicks = xOptionalValue;
+                        prvInsertHardTimer( pxTimer, xHardTimerTime + xOptionalValue );
+                        break;
+
+                    case tmrCOMMAND_DELETE:
+
+                        /* The timer service task frees the timer, as memory
+                         * cannot be freed from an interrupt. */
+                        xReturn = pdFAIL;
+                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                        break;
+
+                    case tmrCOMMAND_STOP:
+                    case tmrCOMMAND_STOP_FROM_ISR:
+                    default:
+                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                        break;
+                }
+            }
+
+            if( xCommandID < tmrFIRST_FROM_ISR_COMMAND )
             {
-                /* Not an auto-reload timer. */
-                xReturn = pdFALSE;
+                taskEXIT_CRITICAL();
             }
             else
             {
-                /* Is an auto-reload timer. */
-                xReturn = pdTRUE;
+                portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
             }
-        }
-        taskEXIT_CRITICAL();
 
-        return xReturn;
-    }
+            return xReturn;
+        }
+/*-----------------------------------------------------------*/
 
-    UBaseType_t uxTimerGetReloadMode( TimerHandle_t xTimer )
-    {
-        return ( UBaseType_t ) xTimerGetReloadMode( xTimer );
-    }
+        static void prvInsertHardTimer( Timer_t * const pxTimer,
+                                        const TickType_t xExpiryTime )
+        {
+            /* Timers in a slot are not sorted.  A slot holds the timers that
+             * expire at any time that maps to it, so the expiry time is compared
+             * when the slot is processed. */
+            listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xExpiryTime );
+            listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
+            vListInsertEnd( &( xHardTimerWheel[ tmrHARD_WHEEL_SLOT( xExpiryTime ) ] ), &( pxTimer->xTimerListItem ) );
+            uxActiveHardTimers++;
+            pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+        }
 /*-----------------------------------------------------------*/
 
-    TickType_t xTimerGetExpiryTime( TimerHandle_t xTimer )
+        void vTimerProcessHardTimersFromISR( void )
+        {
+            List_t * pxSlot;
+            ListItem_t * pxListItem;
+            ListItem_t * pxNextListItem;
+            Timer_t * pxTimer;
+            TickType_t xTimeNow;
+            UBaseType_t uxSavedInterruptStatus;
+
+            uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+            {
+                xHardTimerTime++;
+                xTimeNow = xHardTimerTime;
+
+                /* Move the timers in the slot for this time that expire now,
+                 * rather than on a later revolution of the wheel, to the list of
+                 * expired hard timers.  The wheel is not accessed until a hard
+                 * timer has been started, as it is initialised when the first
+                 * timer is created. */
+                if( uxActiveHardTimers > ( UBaseType_t ) 0U )
+                {
+                    pxSlot = &( xHardTimerWheel[ tmrHARD_WHEEL_SLOT( xTimeNow ) ] );
+                    pxListItem = listGET_HEAD_ENTRY( pxSlot );
+
+                    while( pxListItem != listGET_END_MARKER( pxSlot ) )
+                    {
+                        pxNextListItem = listGET_NEXT( pxListItem );
+
+                        if( listGET_LIST_ITEM_VALUE( pxListItem ) == xTimeNow )
+                        {
+                            ( void ) uxListRemove( pxListItem );
+                            vListInsertEnd( &xExpiredHardTimerList, pxListItem );
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+
+                        pxListItem = pxNextListItem;
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+            /* Call the callback of each expired timer.  The kernel does not hold
+             * its own interrupt mask while a callback executes, so callbacks run
+             * in the context of the tick interrupt with whatever masking the port
+             * applies there.  A callback can start or stop any hard timer, so
+             * each timer is removed from the list of expired timers in turn. */
+            do
+            {
+                uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+                {
+                    if( listLIST_IS_EMPTY( &xExpiredHardTimerList ) == pdFALSE )
+                    {
+                        pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( &xExpiredHardTimerList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+                        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                        uxActiveHardTimers--;
+
+                        if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
+                        {
+                            prvInsertHardTimer( pxTimer, xTimeNow + pxTimer->xTimerPeriodInTicks );
+                        }
+                        else
+                        {
+                            pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                        }
+                    }
+                    else
+                    {
+                        pxTimer = NULL;
+                    }
+                }
+                portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+                if( pxTimer != NULL )
+                {
+                    traceTIMER_EXPIRED( pxTimer );
+                    pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            } while( pxTimer != NULL );
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerSetHardTimer( TimerHandle_t xTimer )
+        {
+            Timer_t * const pxTimer = xTimer;
+
+            configASSERT( xTimer );
+
+            /* Hard timers are not accessed by the timer service task, so a timer
+             * can only become a hard timer while it is not active. */
+            configASSERT( ( pxTimer->ucStatus & tmrSTATUS_IS_ACTIVE ) == 0 );
+
+            taskENTER_CRITICAL();
+            {
+                pxTimer->ucStatus |= tmrSTATUS_IS_HARD;
+            }
+            taskEXIT_CRITICAL();
+        }
+
+    #endif /* configUSE_HARD_TIMERS */
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_HIGH_RESOLUTION_TIMERS == 1 )
+
+        static void prvRemoveHighResolutionTimer( HighResolutionTimer_t * const pxTimer )
+        {
+            HighResolutionTimer_t ** ppxLink = &pxHighResolutionTimerList;
+
+            /* The port's compare is not moved if the timer was the next to
+             * expire.  xTimerProcessHighResolutionTimersFromISR() finds that no
+             * timer has expired when the compare is reached, and sets the
+             * compare for the timer that is then at the front of the list. */
+            if( pxTimer->xIsActive != pdFALSE )
+            {
+                while( *ppxLink != pxTimer )
+                {
+                    ppxLink = &( ( *ppxLink )->pxNext );
+                }
+
+                *ppxLink = pxTimer->pxNext;
+                pxTimer->xIsActive = pdFALSE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+/*-----------------------------------------------------------*/
+
+        static void prvInsertHighResolutionTimer( HighResolutionTimer_t * const pxTimer,
+                                                  const uint64_t ullExpiryTime )
+        {
+            HighResolutionTimer_t ** ppxLink = &pxHighResolutionTimerList;
+
+            /* Timers that expire at the same time expire in the order in which
+             * they were started. */
+            while( ( *ppxLink != NULL ) && ( ( *ppxLink )->ullExpiryTime <= ullExpiryTime ) )
+            {
+                ppxLink = &( ( *ppxLink )->pxNext );
+            }
+
+            pxTimer->ullExpiryTime = ullExpiryTime;
+            pxTimer->pxNext = *ppxLink;
+            pxTimer->xIsActive = pdTRUE;
+            *ppxLink = pxTimer;
+
+            if( pxHighResolutionTimerList == pxTimer )
+            {
+                portSET_HIGH_RESOLUTION_COMPARE( ullExpiryTime );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerInitialiseHighResolution( HighResolutionTimer_t * pxTimer,
+                                             HighResolutionTimerCallbackFunction_t pxCallbackFunction,
+                                             void * pvTimerID )
+        {
+            configASSERT( pxTimer );
+            configASSERT( pxCallbackFunction );
+
+            pxTimer->ullExpiryTime = 0;
+            pxTimer->pxNext = NULL;
+            pxTimer->pxCallbackFunction = pxCallbackFunction;
+            pxTimer->pvTimerID = pvTimerID;
+            pxTimer->xIsActive = pdFALSE;
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerStartHighResolution( HighResolutionTimer_t * pxTimer,
+                                        uint64_t ullDelayNs )
+        {
+            configASSERT( pxTimer );
+
+            taskENTER_CRITICAL();
+            {
+                prvRemoveHighResolutionTimer( pxTimer );
+                prvInsertHighResolutionTimer( pxTimer, portGET_HIGH_RESOLUTION_TIME_NS() + ullDelayNs );
+            }
+            taskEXIT_CRITICAL();
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerStartHighResolutionFromISR( HighResolutionTimer_t * pxTimer,
+                                               uint64_t ullDelayNs )
+        {
+            UBaseType_t uxSavedInterruptStatus;
+
+            configASSERT( pxTimer );
+
+            uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+            {
+                prvRemoveHighResolutionTimer( pxTimer );
+                prvInsertHighResolutionTimer( pxTimer, portGET_HIGH_RESOLUTION_TIME_NS() + ullDelayNs );
+            }
+            portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerStopHighResolution( HighResolutionTimer_t * pxTimer )
+        {
+            configASSERT( pxTimer );
+
+            taskENTER_CRITICAL();
+            {
+                prvRemoveHighResolutionTimer( pxTimer );
+            }
+            taskEXIT_CRITICAL();
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerStopHighResolutionFromISR( HighResolutionTimer_t * pxTimer )
+        {
+            UBaseType_t uxSavedInterruptStatus;
+
+            configASSERT( pxTimer );
+
+            uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+            {
+                prvRemoveHighResolutionTimer( pxTimer );
+            }
+            portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+        }
+/*-----------------------------------------------------------*/
+
+        BaseType_t xTimerIsHighResolutionTimerActive( const HighResolutionTimer_t * pxTimer )
+        {
+            configASSERT( pxTimer );
+
+            return pxTimer->xIsActive;
+        }
+/*-----------------------------------------------------------*/
+
+        uint64_t ullTimerGetHighResolutionTime( void )
+        {
+            return portGET_HIGH_RESOLUTION_TIME_NS();
+        }
+/*-----------------------------------------------------------*/
+
+        BaseType_t xTimerProcessHighResolutionTimersFromISR( void )
+        {
+            HighResolutionTimer_t * pxTimer;
+            BaseType_t xCallbackCalled = pdFALSE;
+            UBaseType_t uxSavedInterruptStatus;
+
+            /* Call the callback of each expired timer.  The kernel does not hold
+             * its own interrupt mask while a callback executes, so callbacks run
+             * in the context of the high resolution timer interrupt with whatever
+             * masking the port applies there.  A callback can start or stop any
+             * high resolution timer, so the front of the list is checked again,
+             * against the time now, after each callback.  A timer that expires
+             * while earlier callbacks execute is therefore processed without
+             * waiting for another interrupt. */
+            do
+            {
+                uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+                {
+                    pxTimer = pxHighResolutionTimerList;
+
+                    if( pxTimer != NULL )
+                    {
+                        if( pxTimer->ullExpiryTime <= portGET_HIGH_RESOLUTION_TIME_NS() )
+                        {
+                            pxHighResolutionTimerList = pxTimer->pxNext;
+                            pxTimer->xIsActive = pdFALSE;
+                        }
+                        else
+                        {
+                            /* The timer at the front of the list has not
+                             * expired yet, so wait for it. */
+                            portSET_HIGH_RESOLUTION_COMPARE( pxTimer->ullExpiryTime );
+                            pxTimer = NULL;
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+                if( pxTimer != NULL )
+                {
+                    pxTimer->pxCallbackFunction( pxTimer );
+                    xCallbackCalled = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            } while( pxTimer != NULL );
+
+            return xCallbackCalled;
+        }
+/*-----------------------------------------------------------*/
+
+        static void prvHighResolutionDelayCallback( HighResolutionTimer_t * pxTimer )
+        {
+            vTaskNotifyGiveFromISR( ( TaskHandle_t ) pxTimer->pvTimerID, NULL );
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerDelayHighResolution( uint64_t ullDelayNs )
+        {
+            HighResolutionTimer_t xDelayTimer;
+            TaskHandle_t xCurrentTask = xTaskGetCurrentTaskHandle();
+            UBaseType_t uxNotificationsTaken = 0;
+
+            vTimerInitialiseHighResolution( &xDelayTimer, prvHighResolutionDelayCallback, xCurrentTask );
+            vTimerStartHighResolution( &xDelayTimer, ullDelayNs );
+
+            /* The timer is marked as expired before its callback gives the
+             * notification, and both happen in the same interrupt, so the
+             * notification has been given by the time the task sees that the
+             * timer has expired. */
+            while( xDelayTimer.xIsActive != pdFALSE )
+            {
+                if( ulTaskNotifyTake( pdFALSE, portMAX_DELAY ) != 0UL )
+                {
+                    uxNotificationsTaken++;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            /* Only the notification given by the timer is consumed.  Any
+             * notifications given by other code that unblocked the task early
+             * are given back, so they are still pending. */
+            if( uxNotificationsTaken == ( UBaseType_t ) 0 )
+            {
+                ( void ) ulTaskNotifyTake( pdFALSE, 0 );
+            }
+            else
+            {
+                while( uxNotificationsTaken > ( UBaseType_t ) 1 )
+                {
+                    ( void ) xTaskNotifyGive( xCurrentTask );
+                    uxNotificationsTaken--;
+                }
+            }
+        }
+
+    #endif /* configUSE_HIGH_RESOLUTION_TIMERS */
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TIMER_COMMAND_COALESCING == 1 )
+
+        static BaseType_t prvPendTimerCommand( Timer_t * const pxTimer,
+                                               const BaseType_t xCommandID,
+                                               const TickType_t xOptionalValue,
+                                               BaseType_t * const pxHigherPriorityTaskWoken )
+        {
+            TimerService_t * const pxService = tmrGET_TIMER_SERVICE( pxTimer );
+            BaseType_t xWakeTimerTask = pdFALSE;
+            UBaseType_t uxSavedInterruptStatus = 0;
+            DaemonTaskMessage_t xMessage;
+
+            if( xCommandID < tmrFIRST_FROM_ISR_COMMAND )
+            {
+                taskENTER_CRITICAL();
+            }
+            else
+            {
+                uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+            }
+
+            {
+                /* A change of period cannot simply be replaced by a later
+                 * command, as the new period must still be used, so it is held
+                 * separately. */
+                if( ( xCommandID == tmrCOMMAND_CHANGE_PERIOD ) || ( xCommandID == tmrCOMMAND_CHANGE_PERIOD_FROM_ISR ) )
+                {
+                    configASSERT( ( xOptionalValue > 0 ) );
+                    pxTimer->xPendingPeriodInTicks = xOptionalValue;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( pxTimer->xPendingCommandID == tmrNO_PENDING_COMMAND )
+                {
+                    /* Add the timer to the end of the list of timers with
+                     * pending commands.  The timer service task only needs
+                     * unblocking if the list was empty, as otherwise it has
+                     * already been unblocked. */
+                    pxTimer->pxNextTimerWithCommand = NULL;
+
+                    if( pxService->pxLastTimerWithCommand == NULL )
+                    {
+                        pxService->pxFirstTimerWithCommand = pxTimer;
+                        xWakeTimerTask = pdTRUE;
+                    }
+                    else
+                    {
+                        pxService->pxLastTimerWithCommand->pxNextTimerWithCommand = pxTimer;
+                    }
+
+                    pxService->pxLastTimerWithCommand = pxTimer;
+                }
+                else
+                {
+                    /* The earlier command is replaced. */
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                pxTimer->xPendingCommandID = xCommandID;
+                pxTimer->xPendingCommandValue = xOptionalValue;
+            }
+
+            if( xCommandID < tmrFIRST_FROM_ISR_COMMAND )
+            {
+                taskEXIT_CRITICAL();
+            }
+            else
+            {
+                portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+            }
+
+            if( xWakeTimerTask != pdFALSE )
+            {
+                /* If the queue is full then the timer service task will process
+                 * the pending commands after the commands already in the
+                 * queue. */
+                xMessage.xMessageID = tmrCOMMAND_WAKE_TIMER_TASK;
+                xMessage.u.xTimerParameters.xMessageValue = ( TickType_t ) 0U;
+                xMessage.u.xTimerParameters.pxTimer = NULL;
+
+                if( xCommandID < tmrFIRST_FROM_ISR_COMMAND )
+                {
+                    ( void ) xQueueSendToBack( pxService->xTimerQueue, &xMessage, tmrNO_DELAY );
+                }
+                else
+                {
+                    ( void ) xQueueSendToBackFromISR( pxService->xTimerQueue, &xMessage, pxHigherPriorityTaskWoken );
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return pdPASS;
+        }
+
+    #endif /* configUSE_TIMER_COMMAND_COALESCING */
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+
+        static BaseType_t prvApplyCommandDirectly( Timer_t * const pxTimer,
+                                                   const BaseType_t xCommandID,
+                                                   const TickType_t xOptionalValue )
+        {
+            TimerService_t * const pxService = tmrGET_TIMER_SERVICE( pxTimer );
+            BaseType_t xReturn = pdFAIL;
+            BaseType_t xWakeTimerTask = pdFALSE;
+            TickType_t xTimeNow, xNextExpiryTime = ( TickType_t ) 0U;
+            DaemonTaskMessage_t xMessage;
+
+            vTaskSuspendAll();
+            {
+                xTimeNow = xTaskGetTickCount();
+
+                /* The timer can only be updated here if the timer service task
+                 * is blocked, and if no earlier commands are waiting to be
+                 * processed by the timer service task, either in the timer
+                 * command queue or held in the timer itself (so commands are
+                 * applied in order).  If the active timers are held in sorted
+                 * lists then the tick count must also not have overflowed since
+                 * the timer service task blocked, as only the timer service task
+                 * can switch the lists. */
+                if( ( pxService->xTimerTaskIsBlocked != pdFALSE ) &&
+                    ( uxQueueMessagesWaiting( pxService->xTimerQueue ) == ( UBaseType_t ) 0U ) &&
+                    ( tmrHAS_PENDING_COMMAND( pxTimer ) == pdFALSE ) &&
+                    ( ( configTIMER_WHEEL_SLOTS > 0 ) || ( xTimeNow >= pxService->xTimerTaskBlockTime ) ) )
+                {
+                    switch( xCommandID )
+                    {
+                        case tmrCOMMAND_START:
+                        case tmrCOMMAND_RESET:
+
+                            /* If the timer has already expired then its callback
+                             * must be called by the timer service task. */
+                            if( ( ( TickType_t ) ( xTimeNow - xOptionalValue ) ) < pxTimer->xTimerPeriodInTicks )
+                            {
+                                xNextExpiryTime = xOptionalValue + pxTimer->xTimerPeriodInTicks;
+                                xReturn = pdPASS;
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
+
+                            break;
+
+                        case tmrCOMMAND_CHANGE_PERIOD:
+                            configASSERT( ( xOptionalValue > 0 ) );
+                            xNextExpiryTime = xTimeNow + xOptionalValue;
+                            xReturn = pdPASS;
+                            break;
+
+                        case tmrCOMMAND_STOP:
+                            xReturn = pdPASS;
+                            break;
+
+                        default:
+                            /* Other commands are always processed by the timer
+                             * service task. */
+                            break;
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( xReturn != pdFAIL )
+                {
+                    traceTIMER_COMMAND_RECEIVED( pxTimer, xCommandID, xOptionalValue );
+
+                    if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
+                    {
+                        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+
+                        #if ( configTIMER_WHEEL_SLOTS > 0 )
+                        {
+                            pxService->uxTimersInWheel--;
+                        }
+                        #endif
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    if( xCommandID == tmrCOMMAND_STOP )
+                    {
+                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                    }
+                    else
+                    {
+                        if( xCommandID == tmrCOMMAND_CHANGE_PERIOD )
+                        {
+                            pxTimer->xTimerPeriodInTicks = xOptionalValue;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+
+                        pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+
+                        /* The expiry time was checked above, so the timer does
+                         * not need processing now. */
+                        ( void ) prvInsertTimerInActiveList( pxTimer, xNextExpiryTime, xTimeNow, ( xCommandID == tmrCOMMAND_CHANGE_PERIOD ) ? xTimeNow : xOptionalValue );
+
+                        /* Only unblock the timer service task if the timer
+                         * must be processed before the timer service task would
+                         * otherwise unblock. */
+                        #if ( configUSE_TIMER_SLACK == 1 )
+                        {
+                            xNextExpiryTime += pxTimer->xTimerSlackInTicks;
+                        }
+                        #endif
+
+                        if( ( pxService->xTimerTaskWaitsIndefinitely != pdFALSE ) ||
+                            ( ( ( TickType_t ) ( xNextExpiryTime - pxService->xTimerTaskBlockTime ) ) < ( ( TickType_t ) ( pxService->xTimerTaskWakeTime - pxService->xTimerTaskBlockTime ) ) ) )
+                        {
+                            xWakeTimerTask = pdTRUE;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            ( void ) xTaskResumeAll();
+
+            if( xWakeTimerTask != pdFALSE )
+            {
+                /* If the queue is full the timer service task will unblock to
+                 * process the commands already in it. */
+                xMessage.xMessageID = tmrCOMMAND_WAKE_TIMER_TASK;
+                xMessage.u.xTimerParameters.xMessageValue = ( TickType_t ) 0U;
+                xMessage.u.xTimerParameters.pxTimer = NULL;
+                ( void ) xQueueSendToBack( pxService->xTimerQueue, &xMessage, tmrNO_DELAY );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return xReturn;
+        }
+
+    #endif /* configUSE_TIMER_DIRECT_COMMANDS */
+/*-----------------------------------------------------------*/
+
+    TaskHandle_t xTimerGetTimerDaemonTaskHandle( void )
+    {
+        /* If xTimerGetTimerDaemonTaskHandle() is called before the scheduler has been
+         * started, then xTimerTaskHandle will be NULL.  The timer service task
+         * returned is the one that executes pended functions. */
+        configASSERT( ( xTimerServices[ 0 ].xTimerTaskHandle != NULL ) );
+        return xTimerServices[ 0 ].xTimerTaskHandle;
+    }
+/*-----------------------------------------------------------*/
+
+    TickType_t xTimerGetPeriod( TimerHandle_t xTimer )
+    {
+        Timer_t * pxTimer = xTimer;
+
+        configASSERT( xTimer );
+        return pxTimer->xTimerPeriodInTicks;
+    }
+/*-----------------------------------------------------------*/
+
+    void vTimerSetReloadMode( TimerHandle_t xTimer,
+                              const BaseType_t xAutoReload )
+    {
+        Timer_t * pxTimer = xTimer;
+
+        configASSERT( xTimer );
+        taskENTER_CRITICAL();
+        {
+            if( xAutoReload != pdFALSE )
+            {
+                pxTimer->ucStatus |= tmrSTATUS_IS_AUTORELOAD;
+            }
+            else
+            {
+                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_AUTORELOAD );
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xTimerGetReloadMode( TimerHandle_t xTimer )
+    {
+        Timer_t * pxTimer = xTimer;
+        BaseType_t xReturn;
+
+        configASSERT( xTimer );
+        taskENTER_CRITICAL();
+        {
+            if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) == 0 )
+            {
+                /* Not an auto-reload timer. */
+                xReturn = pdFALSE;
+            }
+            else
+            {
+                /* Is an auto-reload timer. */
+                xReturn = pdTRUE;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return xReturn;
+    }
+
+    UBaseType_t uxTimerGetReloadMode( TimerHandle_t xTimer )
+    {
+        return ( UBaseType_t ) xTimerGetReloadMode( xTimer );
+    }
+/*-----------------------------------------------------------*/
+
+    TickType_t xTimerGetExpiryTime( TimerHandle_t xTimer )
     {
         Timer_t * pxTimer = xTimer;
         TickType_t xReturn;
@@ -538,10 +1661,15 @@
     }
 /*-----------------------------------------------------------*/
 
-    static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
+    static void prvProcessExpiredTimer( TimerService_t * const pxService,
+                                        const TickType_t xNextExpireTime,
                                         const TickType_t xTimeNow )
     {
-        Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+        #if ( configTIMER_WHEEL_SLOTS > 0 )
+            Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxService->xExpiredTimerList ) ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+        #else
+            Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxService->pxCurrentTimerList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+        #endif
 
         /* Remove the timer from the list of active timers.  A check has already
          * been performed to ensure the list is not empty. */
@@ -570,8 +1698,8 @@
         TickType_t xNextExpireTime;
         BaseType_t xListWasEmpty;
 
-        /* Just to avoid compiler warnings. */
-        ( void ) pvParameters;
+        /* The timer service task state is passed in as the task parameter. */
+        TimerService_t * const pxService = ( TimerService_t * ) pvParameters;
 
         #if ( configUSE_DAEMON_TASK_STARTUP_HOOK == 1 )
         {
@@ -580,8 +1708,12 @@
             /* Allow the application writer to execute some code in the context of
              * this task at the point the task starts executing.  This is useful if the
              * application includes initialisation code that would benefit from
-             * executing after the scheduler has been started. */
-            vApplicationDaemonTaskStartupHook();
+             * executing after the scheduler has been started.  Only the first timer
+             * service task calls the hook. */
+            if( pxService == &( xTimerServices[ 0 ] ) )
+            {
+                vApplicationDaemonTaskStartupHook();
+            }
         }
         #endif /* configUSE_DAEMON_TASK_STARTUP_HOOK */
 
@@ -589,22 +1721,23 @@
         {
             /* Query the timers list to see if it contains any timers, and if so,
              * obtain the time at which the next timer will expire. */
-            xNextExpireTime = prvGetNextExpireTime( &xListWasEmpty );
+            xNextExpireTime = prvGetNextExpireTime( pxService, &xListWasEmpty );
 
             /* If a timer has expired, process it.  Otherwise, block this task
              * until either a timer does expire, or a command is received. */
-            prvProcessTimerOrBlockTask( xNextExpireTime, xListWasEmpty );
+            prvProcessTimerOrBlockTask( pxService, xNextExpireTime, xListWasEmpty );
 
             /* Empty the command queue. */
-            prvProcessReceivedCommands();
+            prvProcessReceivedCommands( pxService );
         }
     }
 /*-----------------------------------------------------------*/
 
-    static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
+    static void prvProcessTimerOrBlockTask( TimerService_t * const pxService,
+                                            const TickType_t xNextExpireTime,
                                             BaseType_t xListWasEmpty )
     {
-        TickType_t xTimeNow;
+        TickType_t xTimeNow, xWakeTime;
         BaseType_t xTimerListsWereSwitched;
 
         vTaskSuspendAll();
@@ -614,16 +1747,27 @@
              * then don't process this timer as any timers that remained in the list
              * when the lists were switched will have been processed within the
              * prvSampleTimeNow() function. */
-            xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+            xTimeNow = prvSampleTimeNow( pxService, &xTimerListsWereSwitched );
 
             if( xTimerListsWereSwitched == pdFALSE )
             {
                 /* The tick count has not overflowed, has the timer expired? */
-                if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
-                {
-                    ( void ) xTaskResumeAll();
-                    prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
-                }
+                #if ( configTIMER_WHEEL_SLOTS > 0 )
+                    /* The timing wheel does not depend on the tick count not
+                     * overflowing, so times are compared relative to the time up
+                     * to which the wheel has been processed. */
+                    if( ( xListWasEmpty == pdFALSE ) && ( ( TickType_t ) ( xNextExpireTime - pxService->xTimerWheelTime ) <= ( TickType_t ) ( xTimeNow - pxService->xTimerWheelTime ) ) )
+                    {
+                        ( void ) xTaskResumeAll();
+                        prvProcessExpiredTimers( pxService, xTimeNow );
+                    }
+                #else
+                    if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
+                    {
+                        ( void ) xTaskResumeAll();
+                        prvProcessExpiredTimer( pxService, xNextExpireTime, xTimeNow );
+                    }
+                #endif /* configTIMER_WHEEL_SLOTS */
                 else
                 {
                     /* The tick count has not overflowed, and the next expire
@@ -632,14 +1776,42 @@
                      * received - whichever comes first.  The following line cannot
                      * be reached unless xNextExpireTime > xTimeNow, except in the
                      * case when the current timer list is empty. */
-                    if( xListWasEmpty != pdFALSE )
+                    #if ( configTIMER_WHEEL_SLOTS == 0 )
+                    {
+                        if( xListWasEmpty != pdFALSE )
+                        {
+                            /* The current timer list is empty - is the overflow list
+                             * also empty? */
+                            xListWasEmpty = listLIST_IS_EMPTY( pxService->pxOverflowTimerList );
+                        }
+                    }
+                    #endif
+
+                    #if ( configUSE_TIMER_SLACK == 1 )
+                    {
+                        /* Block until a timer must be processed, rather than
+                         * until the next timer expires, so timers whose slack
+                         * overlaps are processed when this task next runs. */
+                        xWakeTime = prvGetNextWakeTime( pxService, xNextExpireTime, xListWasEmpty );
+                    }
+                    #else
+                    {
+                        xWakeTime = xNextExpireTime;
+                    }
+                    #endif
+
+                    #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
                     {
-                        /* The current timer list is empty - is the overflow list
-                         * also empty? */
-                        xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+                        /* Allow other tasks to update the active timers until
+                         * this task runs again. */
+                        pxService->xTimerTaskBlockTime = xTimeNow;
+                        pxService->xTimerTaskWakeTime = xWakeTime;
+                        pxService->xTimerTaskWaitsIndefinitely = xListWasEmpty;
+                        pxService->xTimerTaskIsBlocked = pdTRUE;
                     }
+                    #endif
 
-                    vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
+                    vQueueWaitForMessageRestricted( pxService->xTimerQueue, ( xWakeTime - xTimeNow ), xListWasEmpty );
 
                     if( xTaskResumeAll() == pdFALSE )
                     {
@@ -653,6 +1825,12 @@
                     {
                         mtCOVERAGE_TEST_MARKER();
                     }
+
+                    #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+                    {
+                        pxService->xTimerTaskIsBlocked = pdFALSE;
+                    }
+                    #endif
                 }
             }
             else
@@ -663,7 +1841,8 @@
     }
 /*-----------------------------------------------------------*/
 
-    static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
+    static TickType_t prvGetNextExpireTime( TimerService_t * const pxService,
+                                            BaseType_t * const pxListWasEmpty )
     {
         TickType_t xNextExpireTime;
 
@@ -674,40 +1853,203 @@
          * this task to unblock when the tick count overflows, at which point the
          * timer lists will be switched and the next expiry time can be
          * re-assessed.  */
-        *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
-
-        if( *pxListWasEmpty == pdFALSE )
+        #if ( configTIMER_WHEEL_SLOTS > 0 )
         {
-            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            UBaseType_t uxSlotsSearched;
+
+            /* Timers in the timing wheel are not sorted, so return the time of
+             * the first slot after xTimerWheelTime that holds any timers.  The
+             * timers in that slot might not expire until a later revolution of
+             * the wheel, in which case the time returned is earlier than
+             * necessary, but never later.  If there are no active timers then
+             * this task can block until a command is received. */
+            *pxListWasEmpty = ( pxService->uxTimersInWheel == ( UBaseType_t ) 0U ) ? pdTRUE : pdFALSE;
+            xNextExpireTime = ( TickType_t ) 0U;
+
+            if( *pxListWasEmpty == pdFALSE )
+            {
+                xNextExpireTime = pxService->xTimerWheelTime + ( TickType_t ) 1U;
+
+                for( uxSlotsSearched = ( UBaseType_t ) 1U; uxSlotsSearched < ( UBaseType_t ) configTIMER_WHEEL_SLOTS; uxSlotsSearched++ )
+                {
+                    if( listLIST_IS_EMPTY( &( pxService->xTimerWheel[ tmrWHEEL_SLOT( xNextExpireTime ) ] ) ) == pdFALSE )
+                    {
+                        break;
+                    }
+
+                    xNextExpireTime++;
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
         }
-        else
+        #else /* if ( configTIMER_WHEEL_SLOTS > 0 ) */
         {
-            /* Ensure the task unblocks when the tick count rolls over. */
-            xNextExpireTime = ( TickType_t ) 0U;
+            *pxListWasEmpty = listLIST_IS_EMPTY( pxService->pxCurrentTimerList );
+
+            if( *pxListWasEmpty == pdFALSE )
+            {
+                xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxService->pxCurrentTimerList );
+            }
+            else
+            {
+                /* Ensure the task unblocks when the tick count rolls over. */
+                xNextExpireTime = ( TickType_t ) 0U;
+            }
         }
+        #endif /* if ( configTIMER_WHEEL_SLOTS > 0 ) */
 
         return xNextExpireTime;
     }
 /*-----------------------------------------------------------*/
 
-    static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
+    #if ( configUSE_TIMER_SLACK == 1 )
+
+        static TickType_t prvGetNextWakeTime( TimerService_t * const pxService,
+                                              const TickType_t xNextExpireTime,
+                                              const BaseType_t xListWasEmpty )
+        {
+            TickType_t xWakeTime = xNextExpireTime;
+            TickType_t xExpiryTime, xLatestTime;
+            const ListItem_t * pxListItem;
+            const ListItem_t * pxListEnd;
+            const Timer_t * pxTimer;
+
+            #if ( configTIMER_WHEEL_SLOTS > 0 )
+            {
+                TickType_t xSlotTime;
+                const List_t * pxSlot;
+
+                if( xListWasEmpty == pdFALSE )
+                {
+                    /* Search the slots in time order, from the first slot that
+                     * holds any timers, until the slot for the earliest latest
+                     * time found so far.  Timers in a slot that expire on a later
+                     * revolution of the wheel are ignored.  If no timer expires
+                     * within one revolution then unblock after one revolution. */
+                    xWakeTime = pxService->xTimerWheelTime + ( TickType_t ) configTIMER_WHEEL_SLOTS;
+
+                    for( xSlotTime = xNextExpireTime; ( TickType_t ) ( xSlotTime - pxService->xTimerWheelTime ) <= ( TickType_t ) ( xWakeTime - pxService->xTimerWheelTime ); xSlotTime++ )
+                    {
+                        pxSlot = &( pxService->xTimerWheel[ tmrWHEEL_SLOT( xSlotTime ) ] );
+                        pxListEnd = listGET_END_MARKER( pxSlot );
+
+                        for( pxListItem = listGET_HEAD_ENTRY( pxSlot ); pxListItem != pxListEnd; pxListItem = listGET_NEXT( pxListItem ) )
+                        {
+                            xExpiryTime = listGET_LIST_ITEM_VALUE( pxListItem );
+
+                            if( xExpiryTime == xSlotTime )
+                            {
+                                pxTimer = ( const Timer_t * ) listGET_LIST_ITEM_OWNER( pxListItem ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+                                xLatestTime = xExpiryTime + pxTimer->xTimerSlackInTicks;
+
+                                if( ( TickType_t ) ( xLatestTime - pxService->xTimerWheelTime ) < ( TickType_t ) ( xWakeTime - pxService->xTimerWheelTime ) )
+                                {
+                                    xWakeTime = xLatestTime;
+                                }
+                                else
+                                {
+                                    mtCOVERAGE_TEST_MARKER();
+                                }
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
+                        }
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #else /* if ( configTIMER_WHEEL_SLOTS > 0 ) */
+            {
+                ( void ) xListWasEmpty;
+
+                /* If the current timer list is empty then this task must unblock
+                 * when the tick count overflows.  Otherwise search the current
+                 * timer list, which is in expiry time order, until the earliest
+                 * latest time found so far.  The latest time of a timer is
+                 * limited to the time before the tick count overflows, at which
+                 * point the lists are switched and all the timers remaining in
+                 * the current list are processed anyway. */
+                if( listLIST_IS_EMPTY( pxService->pxCurrentTimerList ) == pdFALSE )
+                {
+                    xWakeTime = tmrMAX_TIME_BEFORE_OVERFLOW;
+                    pxListEnd = listGET_END_MARKER( pxService->pxCurrentTimerList );
+
+                    for( pxListItem = listGET_HEAD_ENTRY( pxService->pxCurrentTimerList ); ( pxListItem != pxListEnd ) && ( listGET_LIST_ITEM_VALUE( pxListItem ) <= xWakeTime ); pxListItem = listGET_NEXT( pxListItem ) )
+                    {
+                        pxTimer = ( const Timer_t * ) listGET_LIST_ITEM_OWNER( pxListItem ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+                        xExpiryTime = listGET_LIST_ITEM_VALUE( pxListItem );
+                        xLatestTime = xExpiryTime + pxTimer->xTimerSlackInTicks;
+
+                        if( xLatestTime < xExpiryTime )
+                        {
+                            /* The latest time is after the tick count overflows. */
+                            xLatestTime = tmrMAX_TIME_BEFORE_OVERFLOW;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+
+                        if( xLatestTime < xWakeTime )
+                        {
+                            xWakeTime = xLatestTime;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* if ( configTIMER_WHEEL_SLOTS > 0 ) */
+
+            return xWakeTime;
+        }
+
+    #endif /* configUSE_TIMER_SLACK */
+/*-----------------------------------------------------------*/
+
+    static TickType_t prvSampleTimeNow( TimerService_t * const pxService,
+                                        BaseType_t * const pxTimerListsWereSwitched )
     {
         TickType_t xTimeNow;
-        PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Variable is only accessible to one task. */
 
         xTimeNow = xTaskGetTickCount();
 
-        if( xTimeNow < xLastTime )
-        {
-            prvSwitchTimerLists();
-            *pxTimerListsWereSwitched = pdTRUE;
-        }
-        else
+        #if ( configTIMER_WHEEL_SLOTS > 0 )
         {
+            /* The timing wheel is indexed by the low bits of the expiry time so
+             * is not affected by the tick count overflowing. */
+            ( void ) pxService;
             *pxTimerListsWereSwitched = pdFALSE;
         }
+        #else
+        {
+            if( xTimeNow < pxService->xLastTime )
+            {
+                prvSwitchTimerLists( pxService );
+                *pxTimerListsWereSwitched = pdTRUE;
+            }
+            else
+            {
+                *pxTimerListsWereSwitched = pdFALSE;
+            }
 
-        xLastTime = xTimeNow;
+            pxService->xLastTime = xTimeNow;
+        }
+        #endif /* configTIMER_WHEEL_SLOTS */
 
         return xTimeNow;
     }
@@ -718,53 +2060,84 @@
                                                   const TickType_t xTimeNow,
                                                   const TickType_t xCommandTime )
     {
+        TimerService_t * const pxService = tmrGET_TIMER_SERVICE( pxTimer );
         BaseType_t xProcessTimerNow = pdFALSE;
 
         listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
         listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
 
-        if( xNextExpiryTime <= xTimeNow )
+        #if ( configTIMER_WHEEL_SLOTS > 0 )
         {
             /* Has the expiry time elapsed between the command to start/reset a
-             * timer was issued, and the time the command was processed? */
-            if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= pxTimer->xTimerPeriodInTicks ) /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+             * timer was issued, and the time the command was processed?  Times
+             * are compared relative to the command time so the comparison is
+             * not affected by the tick count overflowing. */
+            if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= ( ( TickType_t ) ( xNextExpiryTime - xCommandTime ) ) ) /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
             {
-                /* The time between a command being issued and the command being
-                 * processed actually exceeds the timers period.  */
                 xProcessTimerNow = pdTRUE;
             }
             else
             {
-                vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                if( pxService->uxTimersInWheel == ( UBaseType_t ) 0U )
+                {
+                    /* Nothing in the wheel can expire before xTimeNow, so move
+                     * the wheel on without searching it.  This also stops the
+                     * wheel falling so far behind the tick count that times can
+                     * no longer be compared relative to it. */
+                    pxService->xTimerWheelTime = xTimeNow;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                vListInsertEnd( &( pxService->xTimerWheel[ tmrWHEEL_SLOT( xNextExpiryTime ) ] ), &( pxTimer->xTimerListItem ) );
+                pxService->uxTimersInWheel++;
             }
         }
-        else
+        #else /* if ( configTIMER_WHEEL_SLOTS > 0 ) */
         {
-            if( ( xTimeNow < xCommandTime ) && ( xNextExpiryTime >= xCommandTime ) )
+            if( xNextExpiryTime <= xTimeNow )
             {
-                /* If, since the command was issued, the tick count has overflowed
-                 * but the expiry time has not, then the timer must have already passed
-                 * its expiry time and should be processed immediately. */
-                xProcessTimerNow = pdTRUE;
+                /* Has the expiry time elapsed between the command to start/reset a
+                 * timer was issued, and the time the command was processed? */
+                if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= pxTimer->xTimerPeriodInTicks ) /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+                {
+                    /* The time between a command being issued and the command being
+                     * processed actually exceeds the timers period.  */
+                    xProcessTimerNow = pdTRUE;
+                }
+                else
+                {
+                    vListInsert( pxService->pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                }
             }
             else
             {
-                vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                if( ( xTimeNow < xCommandTime ) && ( xNextExpiryTime >= xCommandTime ) )
+                {
+                    /* If, since the command was issued, the tick count has overflowed
+                     * but the expiry time has not, then the timer must have already passed
+                     * its expiry time and should be processed immediately. */
+                    xProcessTimerNow = pdTRUE;
+                }
+                else
+                {
+                    vListInsert( pxService->pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                }
             }
         }
+        #endif /* if ( configTIMER_WHEEL_SLOTS > 0 ) */
 
         return xProcessTimerNow;
     }
 /*-----------------------------------------------------------*/
 
-    static void prvProcessReceivedCommands( void )
+    static void prvProcessReceivedCommands( TimerService_t * const pxService )
     {
         DaemonTaskMessage_t xMessage;
-        Timer_t * pxTimer;
-        BaseType_t xTimerListsWereSwitched;
-        TickType_t xTimeNow;
 
-        while( xQueueReceive( xTimerQueue, &xMessage, tmrNO_DELAY ) != pdFAIL ) /*lint !e603 xMessage does not have to be initialised as it is passed out, not in, and it is not used unless xQueueReceive() returns pdTRUE. */
+        while( xQueueReceive( pxService->xTimerQueue, &xMessage, tmrNO_DELAY ) != pdFAIL ) /*lint !e603 xMessage does not have to be initialised as it is passed out, not in, and it is not used unless xQueueReceive() returns pdTRUE. */
         {
             #if ( INCLUDE_xTimerPendFunctionCall == 1 )
             {
@@ -789,188 +2162,392 @@
             #endif /* INCLUDE_xTimerPendFunctionCall */
 
             /* Commands that are positive are timer commands rather than pended
-             * function calls. */
-            if( xMessage.xMessageID >= ( BaseType_t ) 0 )
+             * function calls.  tmrCOMMAND_WAKE_TIMER_TASK only unblocks this task
+             * so requires no processing. */
+            if( ( xMessage.xMessageID >= ( BaseType_t ) 0 ) && ( xMessage.xMessageID != tmrCOMMAND_WAKE_TIMER_TASK ) )
             {
                 /* The messages uses the xTimerParameters member to work on a
                  * software timer. */
-                pxTimer = xMessage.u.xTimerParameters.pxTimer;
+                prvProcessTimerCommand( xMessage.u.xTimerParameters.pxTimer, xMessage.xMessageID, xMessage.u.xTimerParameters.xMessageValue );
+            }
+        }
 
-                if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
+        #if ( configUSE_TIMER_COMMAND_COALESCING == 1 )
+        {
+            prvProcessPendingCommands( pxService );
+        }
+        #endif
+
+        #if ( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configTIMER_PEND_FUNCTION_RING_LENGTH > 0 ) )
+        {
+            prvProcessPendedFunctionRing( pxService );
+        }
+        #endif
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TIMER_COMMAND_COALESCING == 1 )
+
+        static void prvProcessPendingCommands( TimerService_t * const pxService )
+        {
+            Timer_t * pxTimer;
+            BaseType_t xCommandID = tmrNO_PENDING_COMMAND;
+            TickType_t xCommandValue = ( TickType_t ) 0U;
+            TickType_t xPeriodInTicks = ( TickType_t ) 0U;
+
+            do
+            {
+                /* Take the next timer with a pending command, and the command,
+                 * so a new command can be sent to the timer while this one is
+                 * processed. */
+                taskENTER_CRITICAL();
                 {
-                    /* The timer is in a list, remove it. */
-                    ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                    pxTimer = pxService->pxFirstTimerWithCommand;
+
+                    if( pxTimer != NULL )
+                    {
+                        pxService->pxFirstTimerWithCommand = pxTimer->pxNextTimerWithCommand;
+
+                        if( pxService->pxFirstTimerWithCommand == NULL )
+                        {
+                            pxService->pxLastTimerWithCommand = NULL;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+
+                        xCommandID = pxTimer->xPendingCommandID;
+                        xCommandValue = pxTimer->xPendingCommandValue;
+                        xPeriodInTicks = pxTimer->xPendingPeriodInTicks;
+                        pxTimer->xPendingCommandID = tmrNO_PENDING_COMMAND;
+                        pxTimer->xPendingPeriodInTicks = ( TickType_t ) 0U;
+                        pxTimer->pxNextTimerWithCommand = NULL;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                taskEXIT_CRITICAL();
+
+                if( pxTimer != NULL )
+                {
+                    /* Apply any change of period that was replaced by a later
+                     * command before the later command itself. */
+                    if( xPeriodInTicks != ( TickType_t ) 0U )
+                    {
+                        pxTimer->xTimerPeriodInTicks = xPeriodInTicks;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    prvProcessTimerCommand( pxTimer, xCommandID, xCommandValue );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            } while( pxTimer != NULL );
+        }
+
+    #endif /* configUSE_TIMER_COMMAND_COALESCING */
+/*-----------------------------------------------------------*/
+
+    static void prvProcessTimerCommand( Timer_t * const pxTimer,
+                                        const BaseType_t xCommandID,
+                                        const TickType_t xMessageValue )
+    {
+        TimerService_t * const pxService = tmrGET_TIMER_SERVICE( pxTimer );
+        BaseType_t xTimerListsWereSwitched;
+        TickType_t xTimeNow;
+
+        if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
+        {
+            /* The timer is in a list, remove it. */
+            ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+
+            #if ( configTIMER_WHEEL_SLOTS > 0 )
+            {
+                pxService->uxTimersInWheel--;
+            }
+            #endif
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceTIMER_COMMAND_RECEIVED( pxTimer, xCommandID, xMessageValue );
+
+        /* In this case the xTimerListsWereSwitched parameter is not used, but
+         *  it must be present in the function call.  prvSampleTimeNow() must be
+         *  called after the message is received from xTimerQueue so there is no
+         *  possibility of a higher priority task adding a message to the message
+         *  queue with a time that is ahead of the timer daemon task (because it
+         *  pre-empted the timer daemon task after the xTimeNow value was set). */
+        xTimeNow = prvSampleTimeNow( pxService, &xTimerListsWereSwitched );
+
+        switch( xCommandID )
+        {
+            case tmrCOMMAND_START:
+            case tmrCOMMAND_START_FROM_ISR:
+            case tmrCOMMAND_RESET:
+            case tmrCOMMAND_RESET_FROM_ISR:
+                /* Start or restart a timer. */
+                pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+
+                if( prvInsertTimerInActiveList( pxTimer, xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, xMessageValue ) != pdFALSE )
+                {
+                    /* The timer expired before it was added to the active
+                     * timer list.  Process it now. */
+                    if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
+                    {
+                        prvReloadTimer( pxTimer, xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow );
+                    }
+                    else
+                    {
+                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                    }
+
+                    /* Call the timer callback. */
+                    traceTIMER_EXPIRED( pxTimer );
+                    pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                break;
+
+            case tmrCOMMAND_STOP:
+            case tmrCOMMAND_STOP_FROM_ISR:
+                /* The timer has already been removed from the active list. */
+                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                break;
+
+            case tmrCOMMAND_CHANGE_PERIOD:
+            case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR:
+                pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+                pxTimer->xTimerPeriodInTicks = xMessageValue;
+                configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
+
+                /* The new period does not really have a reference, and can
+                 * be longer or shorter than the old one.  The command time is
+                 * therefore set to the current time, and as the period cannot
+                 * be zero the next expiry time can only be in the future,
+                 * meaning (unlike for the xTimerStart() case above) there is
+                 * no fail case that needs to be handled here. */
+                ( void ) prvInsertTimerInActiveList( pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
+                break;
+
+            case tmrCOMMAND_DELETE:
+                #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+                {
+                    /* The timer has already been removed from the active list,
+                     * just free up the memory if the memory was dynamically
+                     * allocated. */
+                    if( ( pxTimer->ucStatus & tmrSTATUS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) 0 )
+                    {
+                        tmrFREE_TIMER( pxTimer );
+                    }
+                    else
+                    {
+                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                    }
                 }
-                else
+                #else /* if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) */
                 {
-                    mtCOVERAGE_TEST_MARKER();
+                    /* If dynamic allocation is not enabled, the memory
+                     * could not have been dynamically allocated. So there is
+                     * no need to free the memory - just mark the timer as
+                     * "not active". */
+                    pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
                 }
+                #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+                break;
 
-                traceTIMER_COMMAND_RECEIVED( pxTimer, xMessage.xMessageID, xMessage.u.xTimerParameters.xMessageValue );
+            default:
+                /* Don't expect to get here. */
+                break;
+        }
+    }
+/*-----------------------------------------------------------*/
 
-                /* In this case the xTimerListsWereSwitched parameter is not used, but
-                 *  it must be present in the function call.  prvSampleTimeNow() must be
-                 *  called after the message is received from xTimerQueue so there is no
-                 *  possibility of a higher priority task adding a message to the message
-                 *  queue with a time that is ahead of the timer daemon task (because it
-                 *  pre-empted the timer daemon task after the xTimeNow value was set). */
-                xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+    #if ( configTIMER_WHEEL_SLOTS > 0 )
 
-                switch( xMessage.xMessageID )
-                {
-                    case tmrCOMMAND_START:
-                    case tmrCOMMAND_START_FROM_ISR:
-                    case tmrCOMMAND_RESET:
-                    case tmrCOMMAND_RESET_FROM_ISR:
-                        /* Start or restart a timer. */
-                        pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+        static void prvProcessExpiredTimers( TimerService_t * const pxService,
+                                             const TickType_t xTimeNow )
+        {
+            ListItem_t * pxListItem, * pxNext;
+            ListItem_t const * pxListEnd;
+            List_t * pxSlot;
+            TickType_t xTicksElapsed, xTick;
+            UBaseType_t uxSlotsToSearch;
+
+            /* Timers that expire in the next xTicksElapsed ticks after
+             * xTimerWheelTime are in the slots for those ticks.  Only the slots
+             * for the ticks that have elapsed need to be searched, up to every
+             * slot once if a complete revolution of the wheel has elapsed. */
+            xTicksElapsed = ( TickType_t ) ( xTimeNow - pxService->xTimerWheelTime );
+
+            if( xTicksElapsed < ( TickType_t ) configTIMER_WHEEL_SLOTS )
+            {
+                uxSlotsToSearch = ( UBaseType_t ) xTicksElapsed;
+            }
+            else
+            {
+                uxSlotsToSearch = ( UBaseType_t ) configTIMER_WHEEL_SLOTS;
+            }
 
-                        if( prvInsertTimerInActiveList( pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, xMessage.u.xTimerParameters.xMessageValue ) != pdFALSE )
-                        {
-                            /* The timer expired before it was added to the active
-                             * timer list.  Process it now. */
-                            if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
-                            {
-                                prvReloadTimer( pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow );
-                            }
-                            else
-                            {
-                                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-                            }
+            for( xTick = pxService->xTimerWheelTime + ( TickType_t ) 1U; uxSlotsToSearch > ( UBaseType_t ) 0U; uxSlotsToSearch-- )
+            {
+                pxSlot = &( pxService->xTimerWheel[ tmrWHEEL_SLOT( xTick ) ] );
+                pxListEnd = listGET_END_MARKER( pxSlot ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+                pxListItem = listGET_HEAD_ENTRY( pxSlot );
 
-                            /* Call the timer callback. */
-                            traceTIMER_EXPIRED( pxTimer );
-                            pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
-                        }
-                        else
-                        {
-                            mtCOVERAGE_TEST_MARKER();
-                        }
+                while( pxListItem != pxListEnd )
+                {
+                    pxNext = listGET_NEXT( pxListItem );
 
-                        break;
+                    /* A slot also holds timers that expire in later revolutions
+                     * of the wheel, which must be left in place. */
+                    if( ( TickType_t ) ( listGET_LIST_ITEM_VALUE( pxListItem ) - pxService->xTimerWheelTime - ( TickType_t ) 1U ) < xTicksElapsed )
+                    {
+                        ( void ) uxListRemove( pxListItem );
+                        vListInsertEnd( &( pxService->xExpiredTimerList ), pxListItem );
+                        pxService->uxTimersInWheel--;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
 
-                    case tmrCOMMAND_STOP:
-                    case tmrCOMMAND_STOP_FROM_ISR:
-                        /* The timer has already been removed from the active list. */
-                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-                        break;
+                    pxListItem = pxNext;
+                }
 
-                    case tmrCOMMAND_CHANGE_PERIOD:
-                    case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR:
-                        pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
-                        pxTimer->xTimerPeriodInTicks = xMessage.u.xTimerParameters.xMessageValue;
-                        configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
-
-                        /* The new period does not really have a reference, and can
-                         * be longer or shorter than the old one.  The command time is
-                         * therefore set to the current time, and as the period cannot
-                         * be zero the next expiry time can only be in the future,
-                         * meaning (unlike for the xTimerStart() case above) there is
-                         * no fail case that needs to be handled here. */
-                        ( void ) prvInsertTimerInActiveList( pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
-                        break;
+                xTick++;
+            }
 
-                    case tmrCOMMAND_DELETE:
-                        #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
-                        {
-                            /* The timer has already been removed from the active list,
-                             * just free up the memory if the memory was dynamically
-                             * allocated. */
-                            if( ( pxTimer->ucStatus & tmrSTATUS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) 0 )
-                            {
-                                vPortFree( pxTimer );
-                            }
-                            else
-                            {
-                                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-                            }
-                        }
-                        #else /* if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) */
-                        {
-                            /* If dynamic allocation is not enabled, the memory
-                             * could not have been dynamically allocated. So there is
-                             * no need to free the memory - just mark the timer as
-                             * "not active". */
-                            pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-                        }
-                        #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
-                        break;
+            pxService->xTimerWheelTime = xTimeNow;
 
-                    default:
-                        /* Don't expect to get here. */
-                        break;
-                }
+            /* Process the expired timers.  Auto-reload timers are put back in
+             * the wheel, after xTimeNow, as each is processed. */
+            while( listLIST_IS_EMPTY( &( pxService->xExpiredTimerList ) ) == pdFALSE )
+            {
+                prvProcessExpiredTimer( pxService, listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxService->xExpiredTimerList ) ), xTimeNow );
             }
         }
-    }
-/*-----------------------------------------------------------*/
 
-    static void prvSwitchTimerLists( void )
-    {
-        TickType_t xNextExpireTime;
-        List_t * pxTemp;
+    #else /* if ( configTIMER_WHEEL_SLOTS > 0 ) */
 
-        /* The tick count has overflowed.  The timer lists must be switched.
-         * If there are any timers still referenced from the current timer list
-         * then they must have expired and should be processed before the lists
-         * are switched. */
-        while( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE )
+        static void prvSwitchTimerLists( TimerService_t * const pxService )
         {
-            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            TickType_t xNextExpireTime;
+            List_t * pxTemp;
+
+            /* The tick count has overflowed.  The timer lists must be switched.
+             * If there are any timers still referenced from the current timer list
+             * then they must have expired and should be processed before the lists
+             * are switched. */
+            while( listLIST_IS_EMPTY( pxService->pxCurrentTimerList ) == pdFALSE )
+            {
+                xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxService->pxCurrentTimerList );
+
+                /* Process the expired timer.  For auto-reload timers, be careful to
+                 * process only expirations that occur on the current list.  Further
+                 * expirations must wait until after the lists are switched. */
+                prvProcessExpiredTimer( pxService, xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW );
+            }
 
-            /* Process the expired timer.  For auto-reload timers, be careful to
-             * process only expirations that occur on the current list.  Further
-             * expirations must wait until after the lists are switched. */
-            prvProcessExpiredTimer( xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW );
+            pxTemp = pxService->pxCurrentTimerList;
+            pxService->pxCurrentTimerList = pxService->pxOverflowTimerList;
+            pxService->pxOverflowTimerList = pxTemp;
         }
 
-        pxTemp = pxCurrentTimerList;
-        pxCurrentTimerList = pxOverflowTimerList;
-        pxOverflowTimerList = pxTemp;
-    }
+    #endif /* if ( configTIMER_WHEEL_SLOTS > 0 ) */
 /*-----------------------------------------------------------*/
 
     static void prvCheckForValidListAndQueue( void )
     {
-        /* Check that the list from which active timers are referenced, and the
-         * queue used to communicate with the timer service, have been
-         * initialised. */
+        TimerService_t * pxService;
+        UBaseType_t uxServiceTask;
+
+        /* Check that the lists from which active timers are referenced, and the
+         * queues used to communicate with the timer services, have been
+         * initialised.  All the timer services are initialised together. */
         taskENTER_CRITICAL();
         {
-            if( xTimerQueue == NULL )
+            if( xTimerServices[ 0 ].xTimerQueue == NULL )
             {
-                vListInitialise( &xActiveTimerList1 );
-                vListInitialise( &xActiveTimerList2 );
-                pxCurrentTimerList = &xActiveTimerList1;
-                pxOverflowTimerList = &xActiveTimerList2;
-
-                #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+                #if ( configUSE_HARD_TIMERS != 0 )
                 {
-                    /* The timer queue is allocated statically in case
-                     * configSUPPORT_DYNAMIC_ALLOCATION is 0. */
-                    PRIVILEGED_DATA static StaticQueue_t xStaticTimerQueue;                                                                          /*lint !e956 Ok to declare in this manner to prevent additional conditional compilation guards in other locations. */
-                    PRIVILEGED_DATA static uint8_t ucStaticTimerQueueStorage[ ( size_t ) configTIMER_QUEUE_LENGTH * sizeof( DaemonTaskMessage_t ) ]; /*lint !e956 Ok to declare in this manner to prevent additional conditional compilation guards in other locations. */
+                    UBaseType_t uxSlot;
 
-                    xTimerQueue = xQueueCreateStatic( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, ( UBaseType_t ) sizeof( DaemonTaskMessage_t ), &( ucStaticTimerQueueStorage[ 0 ] ), &xStaticTimerQueue );
-                }
-                #else
-                {
-                    xTimerQueue = xQueueCreate( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, sizeof( DaemonTaskMessage_t ) );
+                    for( uxSlot = ( UBaseType_t ) 0U; uxSlot < ( UBaseType_t ) configHARD_TIMER_WHEEL_SLOTS; uxSlot++ )
+                    {
+                        vListInitialise( &( xHardTimerWheel[ uxSlot ] ) );
+                    }
+
+                    vListInitialise( &xExpiredHardTimerList );
                 }
-                #endif /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+                #endif /* configUSE_HARD_TIMERS */
 
-                #if ( configQUEUE_REGISTRY_SIZE > 0 )
+                for( uxServiceTask = ( UBaseType_t ) 0U; uxServiceTask < ( UBaseType_t ) configTIMER_SERVICE_TASKS; uxServiceTask++ )
                 {
-                    if( xTimerQueue != NULL )
+                    pxService = &( xTimerServices[ uxServiceTask ] );
+
+                    #if ( configTIMER_WHEEL_SLOTS > 0 )
+                    {
+                        UBaseType_t uxSlot;
+
+                        for( uxSlot = ( UBaseType_t ) 0U; uxSlot < ( UBaseType_t ) configTIMER_WHEEL_SLOTS; uxSlot++ )
+                        {
+                            vListInitialise( &( pxService->xTimerWheel[ uxSlot ] ) );
+                        }
+
+                        vListInitialise( &( pxService->xExpiredTimerList ) );
+                    }
+                    #else
                     {
-                        vQueueAddToRegistry( xTimerQueue, "TmrQ" );
+                        vListInitialise( &( pxService->xActiveTimerList1 ) );
+                        vListInitialise( &( pxService->xActiveTimerList2 ) );
+                        pxService->pxCurrentTimerList = &( pxService->xActiveTimerList1 );
+                        pxService->pxOverflowTimerList = &( pxService->xActiveTimerList2 );
                     }
-                    else
+                    #endif /* configTIMER_WHEEL_SLOTS */
+
+                    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                     {
-                        mtCOVERAGE_TEST_MARKER();
+                        /* The timer queues are allocated statically in case
+                         * configSUPPORT_DYNAMIC_ALLOCATION is 0. */
+                        PRIVILEGED_DATA static StaticQueue_t xStaticTimerQueue[ configTIMER_SERVICE_TASKS ];                                                                          /*lint !e956 Ok to declare in this manner to prevent additional conditional compilation guards in other locations. */
+                        PRIVILEGED_DATA static uint8_t ucStaticTimerQueueStorage[ configTIMER_SERVICE_TASKS ][ ( size_t ) configTIMER_QUEUE_LENGTH * sizeof( DaemonTaskMessage_t ) ]; /*lint !e956 Ok to declare in this manner to prevent additional conditional compilation guards in other locations. */
+
+                        pxService->xTimerQueue = xQueueCreateStatic( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, ( UBaseType_t ) sizeof( DaemonTaskMessage_t ), &( ucStaticTimerQueueStorage[ uxServiceTask ][ 0 ] ), &( xStaticTimerQueue[ uxServiceTask ] ) );
                     }
+                    #else
+                    {
+                        pxService->xTimerQueue = xQueueCreate( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, sizeof( DaemonTaskMessage_t ) );
+                    }
+                    #endif /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+
+                    #if ( configQUEUE_REGISTRY_SIZE > 0 )
+                    {
+                        if( pxService->xTimerQueue != NULL )
+                        {
+                            vQueueAddToRegistry( pxService->xTimerQueue, "TmrQ" );
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    #endif /* configQUEUE_REGISTRY_SIZE */
                 }
-                #endif /* configQUEUE_REGISTRY_SIZE */
             }
             else
             {
@@ -1038,65 +2615,338 @@
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configTIMER_SERVICE_TASKS > 1 )
+
+        void vTimerSetServiceTask( TimerHandle_t xTimer,
+                                   UBaseType_t uxServiceTask )
+        {
+            Timer_t * const pxTimer = xTimer;
+
+            configASSERT( xTimer );
+            configASSERT( uxServiceTask < ( UBaseType_t ) configTIMER_SERVICE_TASKS );
+
+            /* The active timers are only accessed by the timer service task that
+             * services them, so a timer can only be moved to another timer
+             * service task while it is not active and no command for it is
+             * waiting to be processed by the old timer service task.  Only a
+             * coalesced command can be detected here, a command that is still
+             * in the old timer service task's command queue cannot. */
+            configASSERT( ( pxTimer->ucStatus & tmrSTATUS_IS_ACTIVE ) == 0 );
+            configASSERT( tmrHAS_PENDING_COMMAND( pxTimer ) == pdFALSE );
+
+            taskENTER_CRITICAL();
+            {
+                pxTimer->pxTimerService = &( xTimerServices[ uxServiceTask ] );
+            }
+            taskEXIT_CRITICAL();
+        }
+
+    #endif /* configTIMER_SERVICE_TASKS */
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TIMER_SLACK == 1 )
+
+        void vTimerSetSlack( TimerHandle_t xTimer,
+                             const TickType_t xSlackInTicks )
+        {
+            Timer_t * const pxTimer = xTimer;
+
+            configASSERT( xTimer );
+
+            taskENTER_CRITICAL();
+            {
+                pxTimer->xTimerSlackInTicks = xSlackInTicks;
+            }
+            taskEXIT_CRITICAL();
+        }
+/*-----------------------------------------------------------*/
+
+        TickType_t xTimerGetSlack( TimerHandle_t xTimer )
+        {
+            Timer_t * const pxTimer = xTimer;
+
+            configASSERT( xTimer );
+            return pxTimer->xTimerSlackInTicks;
+        }
+
+    #endif /* configUSE_TIMER_SLACK */
+/*-----------------------------------------------------------*/
+
     #if ( INCLUDE_xTimerPendFunctionCall == 1 )
 
+        static BaseType_t prvPendFunctionCall( TimerService_t * const pxService,
+                                               PendedFunction_t xFunctionToPend,
+                                               void * pvParameter1,
+                                               uint32_t ulParameter2,
+                                               BaseType_t * const pxHigherPriorityTaskWoken,
+                                               const TickType_t xTicksToWait,
+                                               const BaseType_t xFromISR )
+        {
+            DaemonTaskMessage_t xMessage;
+            BaseType_t xReturn = pdFAIL;
+
+            #if ( configTIMER_PEND_FUNCTION_RING_LENGTH > 0 )
+            {
+                xReturn = prvAddToPendedFunctionRing( pxService, xFunctionToPend, pvParameter1, ulParameter2, pxHigherPriorityTaskWoken, xFromISR );
+            }
+            #endif
+
+            if( xReturn == pdFAIL )
+            {
+                /* Complete the message with the function parameters and post it
+                 * to the daemon task. */
+                xMessage.u.xCallbackParameters.pxCallbackFunction = xFunctionToPend;
+                xMessage.u.xCallbackParameters.pvParameter1 = pvParameter1;
+                xMessage.u.xCallbackParameters.ulParameter2 = ulParameter2;
+
+                if( xFromISR != pdFALSE )
+                {
+                    xMessage.xMessageID = tmrCOMMAND_EXECUTE_CALLBACK_FROM_ISR;
+                    xReturn = xQueueSendFromISR( pxService->xTimerQueue, &xMessage, pxHigherPriorityTaskWoken );
+                }
+                else
+                {
+                    xMessage.xMessageID = tmrCOMMAND_EXECUTE_CALLBACK;
+                    xReturn = xQueueSendToBack( pxService->xTimerQueue, &xMessage, xTicksToWait );
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return xReturn;
+        }
+/*-----------------------------------------------------------*/
+
         BaseType_t xTimerPendFunctionCallFromISR( PendedFunction_t xFunctionToPend,
                                                   void * pvParameter1,
                                                   uint32_t ulParameter2,
                                                   BaseType_t * pxHigherPriorityTaskWoken )
         {
-            DaemonTaskMessage_t xMessage;
             BaseType_t xReturn;
 
-            /* Complete the message with the function parameters and post it to the
-             * daemon task. */
-            xMessage.xMessageID = tmrCOMMAND_EXECUTE_CALLBACK_FROM_ISR;
-            xMessage.u.xCallbackParameters.pxCallbackFunction = xFunctionToPend;
-            xMessage.u.xCallbackParameters.pvParameter1 = pvParameter1;
-            xMessage.u.xCallbackParameters.ulParameter2 = ulParameter2;
-
-            xReturn = xQueueSendFromISR( xTimerQueue, &xMessage, pxHigherPriorityTaskWoken );
+            /* Pended functions are executed by the first timer service task
+             * unless another is selected. */
+            xReturn = prvPendFunctionCall( &( xTimerServices[ 0 ] ), xFunctionToPend, pvParameter1, ulParameter2, pxHigherPriorityTaskWoken, tmrNO_DELAY, pdTRUE );
 
             tracePEND_FUNC_CALL_FROM_ISR( xFunctionToPend, pvParameter1, ulParameter2, xReturn );
 
             return xReturn;
         }
-
-    #endif /* INCLUDE_xTimerPendFunctionCall */
 /*-----------------------------------------------------------*/
 
-    #if ( INCLUDE_xTimerPendFunctionCall == 1 )
-
         BaseType_t xTimerPendFunctionCall( PendedFunction_t xFunctionToPend,
                                            void * pvParameter1,
                                            uint32_t ulParameter2,
                                            TickType_t xTicksToWait )
         {
-            DaemonTaskMessage_t xMessage;
             BaseType_t xReturn;
 
             /* This function can only be called after a timer has been created or
              * after the scheduler has been started because, until then, the timer
              * queue does not exist. */
-            configASSERT( xTimerQueue );
-
-            /* Complete the message with the function parameters and post it to the
-             * daemon task. */
-            xMessage.xMessageID = tmrCOMMAND_EXECUTE_CALLBACK;
-            xMessage.u.xCallbackParameters.pxCallbackFunction = xFunctionToPend;
-            xMessage.u.xCallbackParameters.pvParameter1 = pvParameter1;
-            xMessage.u.xCallbackParameters.ulParameter2 = ulParameter2;
+            configASSERT( xTimerServices[ 0 ].xTimerQueue );
 
-            xReturn = xQueueSendToBack( xTimerQueue, &xMessage, xTicksToWait );
+            xReturn = prvPendFunctionCall( &( xTimerServices[ 0 ] ), xFunctionToPend, pvParameter1, ulParameter2, NULL, xTicksToWait, pdFALSE );
 
             tracePEND_FUNC_CALL( xFunctionToPend, pvParameter1, ulParameter2, xReturn );
 
             return xReturn;
         }
+/*-----------------------------------------------------------*/
+
+        #if ( configTIMER_SERVICE_TASKS > 1 )
+
+            BaseType_t xTimerPendFunctionCallOnServiceTaskFromISR( UBaseType_t uxServiceTask,
+                                                                   PendedFunction_t xFunctionToPend,
+                                                                   void * pvParameter1,
+                                                                   uint32_t ulParameter2,
+                                                                   BaseType_t * pxHigherPriorityTaskWoken )
+            {
+                BaseType_t xReturn;
+
+                configASSERT( uxServiceTask < ( UBaseType_t ) configTIMER_SERVICE_TASKS );
+
+                xReturn = prvPendFunctionCall( &( xTimerServices[ uxServiceTask ] ), xFunctionToPend, pvParameter1, ulParameter2, pxHigherPriorityTaskWoken, tmrNO_DELAY, pdTRUE );
+
+                tracePEND_FUNC_CALL_FROM_ISR( xFunctionToPend, pvParameter1, ulParameter2, xReturn );
+
+                return xReturn;
+            }
+/*-----------------------------------------------------------*/
+
+            BaseType_t xTimerPendFunctionCallOnServiceTask( UBaseType_t uxServiceTask,
+                                                            PendedFunction_t xFunctionToPend,
+                                                            void * pvParameter1,
+                                                            uint32_t ulParameter2,
+                                                            TickType_t xTicksToWait )
+            {
+                BaseType_t xReturn;
+
+                configASSERT( uxServiceTask < ( UBaseType_t ) configTIMER_SERVICE_TASKS );
+                configASSERT( xTimerServices[ uxServiceTask ].xTimerQueue );
+
+                xReturn = prvPendFunctionCall( &( xTimerServices[ uxServiceTask ] ), xFunctionToPend, pvParameter1, ulParameter2, NULL, xTicksToWait, pdFALSE );
+
+                tracePEND_FUNC_CALL( xFunctionToPend, pvParameter1, ulParameter2, xReturn );
+
+                return xReturn;
+            }
+
+        #endif /* configTIMER_SERVICE_TASKS */
 
     #endif /* INCLUDE_xTimerPendFunctionCall */
 /*-----------------------------------------------------------*/
 
+    #if ( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configTIMER_PEND_FUNCTION_RING_LENGTH > 0 ) )
+
+        static BaseType_t prvAddToPendedFunctionRing( TimerService_t * const pxService,
+                                                      PendedFunction_t xFunctionToPend,
+                                                      void * pvParameter1,
+                                                      uint32_t ulParameter2,
+                                                      BaseType_t * const pxHigherPriorityTaskWoken,
+                                                      const BaseType_t xFromISR )
+        {
+            BaseType_t xReturn = pdFAIL;
+            BaseType_t xWakeTimerTask = pdFALSE;
+            UBaseType_t uxSavedInterruptStatus = 0;
+            UBaseType_t uxEntriesUsed;
+            CallbackParameters_t * pxEntry;
+            DaemonTaskMessage_t xMessage;
+
+            if( xFromISR == pdFALSE )
+            {
+                taskENTER_CRITICAL();
+            }
+            else
+            {
+                uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+            }
+
+            {
+                uxEntriesUsed = pxService->uxPendedCallTail - pxService->uxPendedCallHead;
+
+                if( uxEntriesUsed < ( UBaseType_t ) configTIMER_PEND_FUNCTION_RING_LENGTH )
+                {
+                    pxEntry = &( pxService->xPendedCalls[ tmrPENDED_CALL_INDEX( pxService->uxPendedCallTail ) ] );
+                    pxEntry->pxCallbackFunction = xFunctionToPend;
+                    pxEntry->pvParameter1 = pvParameter1;
+                    pxEntry->ulParameter2 = ulParameter2;
+                    portMEMORY_BARRIER();
+                    pxService->uxPendedCallTail++;
+                    uxEntriesUsed++;
+
+                    if( uxEntriesUsed > pxService->uxPendedCallsMaximum )
+                    {
+                        pxService->uxPendedCallsMaximum = uxEntriesUsed;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    /* The timer service task empties the ring each time it
+                     * runs, so only needs unblocking when the first function
+                     * call is added. */
+                    if( uxEntriesUsed == ( UBaseType_t ) 1U )
+                    {
+                        xWakeTimerTask = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    xReturn = pdPASS;
+                }
+                else
+                {
+                    pxService->uxPendedCallOverflows++;
+                }
+            }
+
+            if( xFromISR == pdFALSE )
+            {
+                taskEXIT_CRITICAL();
+            }
+            else
+            {
+                portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+            }
+
+            if( xWakeTimerTask != pdFALSE )
+            {
+                /* If the queue is full then the timer service task will empty the
+                 * ring after the commands already in the queue. */
+                xMessage.xMessageID = tmrCOMMAND_WAKE_TIMER_TASK;
+                xMessage.u.xTimerParameters.xMessageValue = ( TickType_t ) 0U;
+                xMessage.u.xTimerParameters.pxTimer = NULL;
+
+                if( xFromISR == pdFALSE )
+                {
+                    ( void ) xQueueSendToBack( pxService->xTimerQueue, &xMessage, tmrNO_DELAY );
+                }
+                else
+                {
+                    ( void ) xQueueSendToBackFromISR( pxService->xTimerQueue, &xMessage, pxHigherPriorityTaskWoken );
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return xReturn;
+        }
+/*-----------------------------------------------------------*/
+
+        static void prvProcessPendedFunctionRing( TimerService_t * const pxService )
+        {
+            CallbackParameters_t xCallback;
+            UBaseType_t uxHead = pxService->uxPendedCallHead;
+
+            /* Only this task removes function calls from the ring, so the ring is
+             * emptied without a critical section.  Each entry is copied, and its
+             * slot released, before the function is called so the function can
+             * itself pend function calls.  Function calls added while the ring
+             * is being emptied are also processed, as adding them did not unblock
+             * this task. */
+            while( uxHead != pxService->uxPendedCallTail )
+            {
+                xCallback = pxService->xPendedCalls[ tmrPENDED_CALL_INDEX( uxHead ) ];
+                uxHead++;
+                portMEMORY_BARRIER();
+                pxService->uxPendedCallHead = uxHead;
+
+                xCallback.pxCallbackFunction( xCallback.pvParameter1, xCallback.ulParameter2 );
+            }
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerGetPendedFunctionRingStats( UBaseType_t uxServiceTask,
+                                               PendedFunctionRingStats_t * pxRingStats )
+        {
+            const TimerService_t * pxService;
+
+            configASSERT( uxServiceTask < ( UBaseType_t ) configTIMER_SERVICE_TASKS );
+            configASSERT( pxRingStats );
+
+            pxService = &( xTimerServices[ uxServiceTask ] );
+
+            taskENTER_CRITICAL();
+            {
+                pxRingStats->uxRingLength = ( UBaseType_t ) configTIMER_PEND_FUNCTION_RING_LENGTH;
+                pxRingStats->uxEntriesUsed = pxService->uxPendedCallTail - pxService->uxPendedCallHead;
+                pxRingStats->uxMaximumEntriesUsed = pxService->uxPendedCallsMaximum;
+                pxRingStats->uxOverflows = pxService->uxPendedCallOverflows;
+            }
+            taskEXIT_CRITICAL();
+        }
+
+    #endif /* ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configTIMER_PEND_FUNCTION_RING_LENGTH > 0 ) */
+/*-----------------------------------------------------------*/
+
     #if ( configUSE_TRACE_FACILITY == 1 )
 
         UBaseType_t uxTimerGetTimerNumber( TimerHandle_t xTimer )